@@ -0,0 +1,467 @@
+/**
+ **  ______             ______ _
+ **  |  ___|            |  _  \ |
+ **  | |_ _   _ _ __ ___| | | | |
+ **  |  _| | | | '__/ _ \ | | | |
+ **  | | | |_| | | |  __/ |/ /| |____
+ **  \_|  \__, |_|  \___|___/ \_____/
+ **        __/ |
+ **       |___/
+ **
+ **   Thank you for using "FyreDL" for your download management needs!
+ **   Copyright (C) 2016-2017. GekkoFyre.
+ **
+ **
+ **   FyreDL is free software: you can redistribute it and/or modify
+ **   it under the terms of the GNU General Public License as published by
+ **   the Free Software Foundation, either version 3 of the License, or
+ **   (at your option) any later version.
+ **
+ **   FyreDL is distributed in the hope that it will be useful,
+ **   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **   GNU General Public License for more details.
+ **
+ **   You should have received a copy of the GNU General Public License
+ **   along with FyreDL.  If not, see <http://www.gnu.org/licenses/>.
+ **
+ **
+ **   The latest source code updates can be obtained from [ 1 ] below at your
+ **   discretion. A web-browser or the 'git' application may be required.
+ **
+ **   [ 1 ] - https://github.com/GekkoFyre/FyreDL
+ **
+ ********************************************************************************/
+
+/**
+ * @file async_writer.cpp
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-14
+ * @brief A write-behind stage for downloads, whereby filled buffers are handed over to a dedicated thread that writes
+ * them out to disk at their own, explicit offsets.
+ */
+
+#include "async_writer.hpp"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+extern "C" {
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+}
+
+#elif __linux__
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+extern "C" {
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+}
+
+#else
+#error "Platform not supported!"
+#endif
+
+/**
+ * @brief GekkoFyre::GkAsyncWriter::GkAsyncWriter starts up the thread that does all of the writing.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-14
+ * @param buffer_size The capacity of each buffer, in bytes.
+ * @param max_buffers How many buffers may be queued up at once before submit() starts turning them away, which bounds
+ * the memory that is used whenever the network outpaces the disk.
+ * @param on_buffer_freed Called from the writing thread once a buffer has been written out, so that any transfers that
+ * have been turned away may be resumed. It must not block.
+ */
+GekkoFyre::GkAsyncWriter::GkAsyncWriter(const size_t &buffer_size, const size_t &max_buffers,
+                                        const std::function<void()> &on_buffer_freed)
+    : buf_size(buffer_size), buf_max(max_buffers), in_flight(0), buffer_freed(on_buffer_freed), stopping(false)
+{
+    worker = std::thread(&GkAsyncWriter::run, this);
+}
+
+GekkoFyre::GkAsyncWriter::~GkAsyncWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+
+    cond.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief GekkoFyre::GkAsyncWriter::open opens the given file for writing, creating it should it not yet exist.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-14
+ * @param file_loc The path of the file in question.
+ * @param truncate Whether any pre-existing contents of the file should be thrown away.
+ * @param stream_hash The checksum that everything written through this file descriptor is to be added to, if any.
+ * @return A file descriptor to be given to submit() and, once finished with, to close().
+ */
+int GekkoFyre::GkAsyncWriter::open(const std::string &file_loc, const bool &truncate,
+                                   const std::shared_ptr<GekkoFyre::GkCurl::StreamHash> &stream_hash)
+{
+    #ifdef _WIN32
+    int fd = ::_open(file_loc.c_str(), _O_WRONLY | _O_CREAT | _O_BINARY | (truncate ? _O_TRUNC : 0),
+                     _S_IREAD | _S_IWRITE);
+    #elif __linux__
+    int fd = ::open(file_loc.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : 0), 0644);
+    #else
+    #error "Platform not supported!"
+    #endif
+
+    if (fd < 0) {
+        throw std::runtime_error("Unable to open \"" + file_loc + "\" for writing: " + std::strerror(errno));
+    }
+
+    std::lock_guard<std::mutex> lock(mtx);
+    paths[fd] = file_loc;
+    if (stream_hash != nullptr) {
+        hashes[fd] = stream_hash;
+    }
+
+    return fd;
+}
+
+/**
+ * @brief GekkoFyre::GkAsyncWriter::create_file creates (or truncates) the given file and, should its final size be
+ * known, reserves all of the space that it will need up-front. The file system may then lay it out in one contiguous
+ * piece, and a download runs out of disk space right at the start rather than part-way through. It also allows for
+ * segments to be written out of order without the file growing a piece at a time.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-15
+ * @note <http://man7.org/linux/man-pages/man2/fallocate.2.html>
+ *       <https://msdn.microsoft.com/en-us/library/whx354w1.aspx>
+ * @param file_loc The path of the file in question.
+ * @param length The final size of the file, in bytes, or zero if it is not known.
+ */
+void GekkoFyre::GkAsyncWriter::create_file(const std::string &file_loc, const curl_off_t &length)
+{
+    clear_failed(file_loc);
+    int fd = open(file_loc, true);
+    int ret = 0;
+    if (length > 0) {
+        #ifdef _WIN32
+        ret = ::_chsize_s(fd, (__int64)length);
+        #elif __linux__
+        // Unlike 'posix_fallocate()', this never falls back to writing out zeroes upon file systems that lack support
+        // for it, which would take about as long as the download itself
+        if (::fallocate64(fd, 0, 0, (off64_t)length) != 0) {
+            ret = ((errno == EOPNOTSUPP || errno == ENOSYS) ? 0 : errno);
+        }
+        #endif
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        paths.erase(fd);
+    }
+
+    #ifdef _WIN32
+    ::_close(fd);
+    #elif __linux__
+    ::close(fd);
+    #endif
+
+    if (ret != 0) {
+        throw std::runtime_error("Unable to reserve space for \"" + file_loc + "\": " + std::strerror(ret));
+    }
+
+    return;
+}
+
+/**
+ * @brief GekkoFyre::GkAsyncWriter::submit queues up the given buffer to be written at the given offset. Upon success,
+ * the buffer is swapped for an empty one (of the same capacity) and the offset is moved on past what was queued.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-14
+ * @param fd A file descriptor, as given by open().
+ * @param offset Where within the file the buffer is to be written.
+ * @param buffer The data to be written.
+ * @param force Queue up the buffer even if the limit has been reached, for when the data cannot be held onto any
+ * longer (i.e. the connection is going away).
+ * @param on_written Called from the writing thread once the buffer has been dealt with, along with whether it made it
+ * onto the disk in full. Only then may the buffer be counted as downloaded.
+ * @return False if too many buffers are already queued up, in which case nothing has been touched and the caller should
+ * try again once it has been told that a buffer has been freed.
+ */
+bool GekkoFyre::GkAsyncWriter::submit(const int &fd, curl_off_t &offset, std::vector<char> &buffer, const bool &force,
+                                      const std::function<void(const bool &written)> &on_written)
+{
+    if (buffer.empty()) {
+        return true;
+    }
+
+    std::unique_lock<std::mutex> lock(mtx);
+    if (!force && in_flight >= buf_max) {
+        return false;
+    }
+
+    std::vector<char> fresh;
+    if (!spare_bufs.empty()) {
+        fresh = std::move(spare_bufs.back());
+        spare_bufs.pop_back();
+    } else {
+        fresh.reserve(buf_size);
+    }
+
+    WriteJob job;
+    job.kind = WriteJob::Write;
+    job.fd = fd;
+    job.offset = offset;
+    job.buffer = std::move(buffer);
+    job.on_written = on_written;
+    auto stream_hash = hashes.find(fd);
+    if (stream_hash != hashes.end()) {
+        job.stream_hash = stream_hash->second;
+    }
+
+    offset += (curl_off_t)job.buffer.size();
+    buffer = std::move(fresh);
+
+    jobs.push_back(std::move(job));
+    ++in_flight;
+    lock.unlock();
+    cond.notify_one();
+
+    return true;
+}
+
+/**
+ * @brief GekkoFyre::GkAsyncWriter::close closes the file descriptor once everything that has been submitted for it
+ * beforehand has been written out.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-14
+ * @param fd A file descriptor, as given by open().
+ */
+void GekkoFyre::GkAsyncWriter::close(const int &fd)
+{
+    WriteJob job;
+    job.kind = WriteJob::Close;
+    job.fd = fd;
+    job.offset = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        jobs.push_back(std::move(job));
+    }
+
+    cond.notify_one();
+    return;
+}
+
+/**
+ * @brief GekkoFyre::GkAsyncWriter::barrier calls the given function, from the writing thread, once everything that has
+ * been submitted (or closed) beforehand is on disk. The jobs are carried out strictly in the order that they were
+ * given, so this is no more than yet another job at the back of the queue.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-14
+ * @param on_done What to do once the writes are finished with.
+ */
+void GekkoFyre::GkAsyncWriter::barrier(const std::function<void()> &on_done)
+{
+    WriteJob job;
+    job.kind = WriteJob::Barrier;
+    job.fd = -1;
+    job.offset = 0;
+    job.on_done = on_done;
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        jobs.push_back(std::move(job));
+    }
+
+    cond.notify_one();
+    return;
+}
+
+/**
+ * @brief GekkoFyre::GkAsyncWriter::has_failed tells whether any write to the given file descriptor has failed thus
+ * far, in which case the transfer behind it should be brought to a halt.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-14
+ */
+bool GekkoFyre::GkAsyncWriter::has_failed(const int &fd)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    return (errors.find(fd) != errors.end());
+}
+
+/**
+ * @brief GekkoFyre::GkAsyncWriter::has_failed tells whether any write to the given file has failed since it was last
+ * cleared, through whichever file descriptor it may have been, even one that has since been closed.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-09-01
+ * @see GekkoFyre::GkAsyncWriter::clear_failed()
+ */
+bool GekkoFyre::GkAsyncWriter::has_failed(const std::string &file_loc)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    return (failed_files.find(file_loc) != failed_files.end());
+}
+
+/**
+ * @brief GekkoFyre::GkAsyncWriter::clear_failed forgets about any writes to the given file that have failed, such as
+ * once the download has been started over or reported upon.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-09-01
+ */
+void GekkoFyre::GkAsyncWriter::clear_failed(const std::string &file_loc)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    failed_files.erase(file_loc);
+    return;
+}
+
+/**
+ * @brief GekkoFyre::GkAsyncWriter::hash_result finishes off the given checksum, but only if everything that was written
+ * in order (which is everything, for a download with but the one connection) adds up to the whole file. Whatever the
+ * other segments of a download wrote ahead of that is never read back in here, as doing so would hold up the writes of
+ * every other download in the meantime; the checksum is instead left to the hashing service.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-16
+ * @note This may only be called from within the writing thread (i.e. from a barrier()), once the download has been
+ * written out in full.
+ * @param file_loc The path of the file in question.
+ * @param stream_hash The checksum in question.
+ * @return The checksum in hexadecimal, or an empty string should it not cover the whole file.
+ */
+QString GekkoFyre::GkAsyncWriter::hash_result(const std::string &file_loc, GekkoFyre::GkCurl::StreamHash &stream_hash)
+{
+    struct stat st;
+    if (stat(file_loc.c_str(), &st) != 0 || (curl_off_t)st.st_size != stream_hash.hashed_to) {
+        return "";
+    }
+
+    return QString(stream_hash.hash->result().toHex());
+}
+
+std::string GekkoFyre::GkAsyncWriter::error(const int &fd)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    auto err = errors.find(fd);
+    if (err != errors.end()) {
+        return err->second;
+    }
+
+    return "";
+}
+
+void GekkoFyre::GkAsyncWriter::run()
+{
+    for (;;) {
+        std::unique_lock<std::mutex> lock(mtx);
+        cond.wait(lock, [this]() { return (stopping || !jobs.empty()); });
+        if (jobs.empty()) {
+            // Only ever stop once everything that was queued up has been written out
+            return;
+        }
+
+        WriteJob job = std::move(jobs.front());
+        jobs.pop_front();
+        lock.unlock();
+
+        bool written = false;
+        switch (job.kind) {
+            case WriteJob::Write:
+                written = write_job(job);
+                if (written && job.stream_hash != nullptr && job.offset == job.stream_hash->hashed_to) {
+                    // The buffer carries on from exactly where the checksum left off, so it may be added to the
+                    // checksum whilst it is still at hand
+                    job.stream_hash->hash->addData(job.buffer.data(), (int)job.buffer.size());
+                    job.stream_hash->hashed_to += (curl_off_t)job.buffer.size();
+                }
+
+                if (job.on_written) {
+                    job.on_written(written);
+                }
+
+                job.buffer.clear();
+                lock.lock();
+                spare_bufs.push_back(std::move(job.buffer));
+                --in_flight;
+                lock.unlock();
+                if (buffer_freed) {
+                    buffer_freed();
+                }
+
+                break;
+            case WriteJob::Close:
+                // The descriptor may well be handed out again by the operating system as soon as it is closed, so
+                // forget about it beforehand
+                lock.lock();
+                errors.erase(job.fd);
+                hashes.erase(job.fd);
+                paths.erase(job.fd);
+                lock.unlock();
+
+                #ifdef _WIN32
+                ::_close(job.fd);
+                #elif __linux__
+                ::close(job.fd);
+                #endif
+                break;
+            case WriteJob::Barrier:
+                if (job.on_done) {
+                    job.on_done();
+                }
+
+                break;
+        }
+    }
+}
+
+/**
+ * @brief GekkoFyre::GkAsyncWriter::write_job writes out a buffer in full, at its own offset, without making use of (or
+ * disturbing) the file position. Should the disk refuse, the error is kept for has_failed() to pick up on.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-14
+ * @note <http://man7.org/linux/man-pages/man2/pwrite.2.html>
+ * @return Whether the buffer was written out in full.
+ */
+bool GekkoFyre::GkAsyncWriter::write_job(WriteJob &job)
+{
+    size_t done = 0;
+    while (done < job.buffer.size()) {
+        #ifdef _WIN32
+        // There is no 'pwrite()' here, but nothing besides this one thread ever moves the file position either
+        long long ret = -1;
+        if (::_lseeki64(job.fd, (__int64)(job.offset + done), SEEK_SET) >= 0) {
+            ret = ::_write(job.fd, job.buffer.data() + done, (unsigned int)(job.buffer.size() - done));
+        }
+        #elif __linux__
+        ssize_t ret = ::pwrite64(job.fd, job.buffer.data() + done, job.buffer.size() - done,
+                                 (off64_t)(job.offset + done));
+        #endif
+
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (ret <= 0) {
+            const int err = ((ret < 0) ? errno : ENOSPC);
+            std::lock_guard<std::mutex> lock(mtx);
+            errors[job.fd] = std::strerror(err);
+            auto path = paths.find(job.fd);
+            if (path != paths.end()) {
+                failed_files.insert(path->second);
+            }
+
+            return false;
+        }
+
+        done += (size_t)ret;
+    }
+
+    return true;
+}
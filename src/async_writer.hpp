@@ -0,0 +1,115 @@
+/**
+ **  ______             ______ _
+ **  |  ___|            |  _  \ |
+ **  | |_ _   _ _ __ ___| | | | |
+ **  |  _| | | | '__/ _ \ | | | |
+ **  | | | |_| | | |  __/ |/ /| |____
+ **  \_|  \__, |_|  \___|___/ \_____/
+ **        __/ |
+ **       |___/
+ **
+ **   Thank you for using "FyreDL" for your download management needs!
+ **   Copyright (C) 2016-2017. GekkoFyre.
+ **
+ **
+ **   FyreDL is free software: you can redistribute it and/or modify
+ **   it under the terms of the GNU General Public License as published by
+ **   the Free Software Foundation, either version 3 of the License, or
+ **   (at your option) any later version.
+ **
+ **   FyreDL is distributed in the hope that it will be useful,
+ **   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **   GNU General Public License for more details.
+ **
+ **   You should have received a copy of the GNU General Public License
+ **   along with FyreDL.  If not, see <http://www.gnu.org/licenses/>.
+ **
+ **
+ **   The latest source code updates can be obtained from [ 1 ] below at your
+ **   discretion. A web-browser or the 'git' application may be required.
+ **
+ **   [ 1 ] - https://github.com/GekkoFyre/FyreDL
+ **
+ ********************************************************************************/
+
+/**
+ * @file async_writer.hpp
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-14
+ * @brief A write-behind stage for downloads, whereby filled buffers are handed over to a dedicated thread that writes
+ * them out to disk at their own, explicit offsets.
+ */
+
+#ifndef FYREDL_ASYNC_WRITER_HPP
+#define FYREDL_ASYNC_WRITER_HPP
+
+#include "default_var.hpp"
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <memory>
+#include <QString>
+
+namespace GekkoFyre {
+class GkAsyncWriter {
+public:
+    GkAsyncWriter() = delete;
+    GkAsyncWriter(const GkAsyncWriter&) = delete;
+    GkAsyncWriter &operator=(const GkAsyncWriter&) = delete;
+
+    explicit GkAsyncWriter(const size_t &buffer_size, const size_t &max_buffers,
+                           const std::function<void()> &on_buffer_freed);
+    ~GkAsyncWriter();
+
+    int open(const std::string &file_loc, const bool &truncate,
+             const std::shared_ptr<GekkoFyre::GkCurl::StreamHash> &stream_hash = nullptr);
+    void create_file(const std::string &file_loc, const curl_off_t &length);
+    bool submit(const int &fd, curl_off_t &offset, std::vector<char> &buffer, const bool &force = false,
+                const std::function<void(const bool &written)> &on_written = nullptr);
+    void close(const int &fd);
+    void barrier(const std::function<void()> &on_done);
+    bool has_failed(const int &fd);
+    bool has_failed(const std::string &file_loc);
+    void clear_failed(const std::string &file_loc);
+    std::string error(const int &fd);
+    QString hash_result(const std::string &file_loc, GekkoFyre::GkCurl::StreamHash &stream_hash);
+
+private:
+    struct WriteJob {
+        enum Kind { Write, Close, Barrier } kind;
+        int fd;
+        curl_off_t offset;
+        std::vector<char> buffer;
+        std::function<void()> on_done;
+        std::function<void(const bool &written)> on_written;
+        std::shared_ptr<GekkoFyre::GkCurl::StreamHash> stream_hash;
+    };
+
+    size_t buf_size;                             // The capacity that every buffer is allocated with, in bytes
+    size_t buf_max;                              // How many buffers may be queued up (or be in the midst of writing) at once
+    size_t in_flight;                            // How many buffers are presently queued up or being written
+    std::function<void()> buffer_freed;          // Called from the writing thread, every time a buffer has been written
+    std::deque<WriteJob> jobs;
+    std::vector<std::vector<char>> spare_bufs;   // Buffers that have been written out, ready to be filled once more
+    std::unordered_map<int, std::string> errors; // Any file descriptors that have failed to write, and why
+    std::unordered_map<int, std::string> paths;  // The path of the file behind each open file descriptor
+    std::unordered_set<std::string> failed_files; // Files that have had a write fail, until clear_failed() is called
+    std::unordered_map<int, std::shared_ptr<GekkoFyre::GkCurl::StreamHash>> hashes; // The checksum that each file descriptor's writes are added to, if any
+    std::mutex mtx;
+    std::condition_variable cond;
+    std::thread worker;
+    bool stopping;
+
+    void run();
+    bool write_job(WriteJob &job);
+};
+}
+
+#endif // FYREDL_ASYNC_WRITER_HPP
@@ -0,0 +1,498 @@
+/**
+ **  ______             ______ _
+ **  |  ___|            |  _  \ |
+ **  | |_ _   _ _ __ ___| | | | |
+ **  |  _| | | | '__/ _ \ | | | |
+ **  | | | |_| | | |  __/ |/ /| |____
+ **  \_|  \__, |_|  \___|___/ \_____/
+ **        __/ |
+ **       |___/
+ **
+ **   Thank you for using "FyreDL" for your download management needs!
+ **   Copyright (C) 2016-2017. GekkoFyre.
+ **
+ **
+ **   FyreDL is free software: you can redistribute it and/or modify
+ **   it under the terms of the GNU General Public License as published by
+ **   the Free Software Foundation, either version 3 of the License, or
+ **   (at your option) any later version.
+ **
+ **   FyreDL is distributed in the hope that it will be useful,
+ **   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **   GNU General Public License for more details.
+ **
+ **   You should have received a copy of the GNU General Public License
+ **   along with FyreDL.  If not, see <http://www.gnu.org/licenses/>.
+ **
+ **
+ **   The latest source code updates can be obtained from [ 1 ] below at your
+ **   discretion. A web-browser or the 'git' application may be required.
+ **
+ **   [ 1 ] - https://github.com/GekkoFyre/FyreDL
+ **
+ ********************************************************************************/
+
+
+/**
+ * @file bandwidth.cpp
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-27
+ * @brief Divides a single, global download rate between every HTTP(S)/FTP(S) connection and the BitTorrent session,
+ * by way of a token bucket along with per-host and per-download limits, weights and a schedule for the time of day.
+ */
+
+#include "bandwidth.hpp"
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cctype>
+#include <ctime>
+
+/**
+ * @brief GekkoFyre::GkBandwidth::GkBandwidth sets up the token bucket, which starts out empty.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-27
+ * @param down_limit The download rate, in bytes per second, shared between every transfer. '0' for no limit.
+ * @param up_limit The upload rate, in bytes per second, shared between every transfer. '0' for no limit.
+ */
+GekkoFyre::GkBandwidth::GkBandwidth(const curl_off_t &down_limit, const curl_off_t &up_limit)
+    : down_limit(down_limit), up_limit(up_limit), eff_down(down_limit), eff_up(up_limit), tokens(0)
+{
+    last_refill = clk::now();
+    last_rebalance = last_refill;
+    apply_schedule();
+}
+
+GekkoFyre::GkBandwidth::~GkBandwidth()
+{}
+
+/**
+ * @brief GekkoFyre::GkBandwidth::instance is the one budget that every transfer throughout FyreDL draws upon.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-27
+ */
+GekkoFyre::GkBandwidth &GekkoFyre::GkBandwidth::instance()
+{
+    static GkBandwidth bandwidth;
+    return bandwidth;
+}
+
+/**
+ * @brief GekkoFyre::GkBandwidth::hostOf picks out the host (along with the port, if one is given) from the given URL,
+ * by which per-host limits are looked up.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-27
+ * @param url The URL in question.
+ * @return The host, in lower-case, or an empty string should there not be one.
+ */
+std::string GekkoFyre::GkBandwidth::hostOf(const std::string &url)
+{
+    size_t begin = url.find("://");
+    begin = (begin == std::string::npos) ? 0 : (begin + 3);
+    size_t end = url.find_first_of("/?#", begin);
+    if (end == std::string::npos) {
+        end = url.size();
+    }
+
+    // Skip over any user credentials that come before the host
+    const size_t at = url.rfind('@', end);
+    if (at != std::string::npos && at >= begin) {
+        begin = (at + 1);
+    }
+
+    std::string host = url.substr(begin, (end - begin));
+    std::transform(host.begin(), host.end(), host.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+    return host;
+}
+
+/**
+ * @brief GekkoFyre::GkBandwidth::setGlobalLimit sets the rates that are shared between every transfer, outside of any
+ * window within the schedule.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-27
+ * @param down_limit The download rate, in bytes per second. '0' for no limit.
+ * @param up_limit The upload rate, in bytes per second, which only BitTorrent makes use of. '0' for no limit.
+ */
+void GekkoFyre::GkBandwidth::setGlobalLimit(const curl_off_t &down_limit, const curl_off_t &up_limit)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    this->down_limit = down_limit;
+    this->up_limit = up_limit;
+    apply_schedule();
+    return;
+}
+
+/**
+ * @brief GekkoFyre::GkBandwidth::setHostLimit caps the download rate of every flow from the given host put together.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-27
+ * @param host The host in question, as given by GekkoFyre::GkBandwidth::hostOf().
+ * @param limit The rate in bytes per second, or '0' for no limit. Below zero reverts to 'FYREDL_BW_HOST_LIMIT'.
+ */
+void GekkoFyre::GkBandwidth::setHostLimit(const std::string &host, const curl_off_t &limit)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    if (limit < 0) {
+        host_limits.erase(host);
+    } else {
+        host_limits[host] = limit;
+    }
+
+    return;
+}
+
+/**
+ * @brief GekkoFyre::GkBandwidth::setItemLimit caps the download rate of the given download, over all of its
+ * connections put together.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-27
+ * @param item The download in question, which is its destination upon local storage.
+ * @param limit The rate in bytes per second, or '0' for no limit. Below zero reverts to 'FYREDL_BW_ITEM_LIMIT'.
+ */
+void GekkoFyre::GkBandwidth::setItemLimit(const std::string &item, const curl_off_t &limit)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    if (limit < 0) {
+        item_limits.erase(item);
+    } else {
+        item_limits[item] = limit;
+    }
+
+    return;
+}
+
+/**
+ * @brief GekkoFyre::GkBandwidth::setItemWeight sets how large a share of the global download rate the given download
+ * receives, relative to all of the others.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-27
+ * @param item The download in question, which is its destination upon local storage.
+ * @param weight The download's weight, where every download starts out at '1.0'. Zero or less reverts it to '1.0'.
+ */
+void GekkoFyre::GkBandwidth::setItemWeight(const std::string &item, const double &weight)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    if (weight <= 0) {
+        item_weights.erase(item);
+    } else {
+        item_weights[item] = weight;
+    }
+
+    return;
+}
+
+/**
+ * @brief GekkoFyre::GkBandwidth::setSchedule replaces the windows of the day during which the global limits differ
+ * from the usual ones. Should windows overlap, then the first of them wins out.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-27
+ * @param windows The windows in question, in local time.
+ */
+void GekkoFyre::GkBandwidth::setSchedule(const std::vector<GekkoFyre::GkBw::Window> &windows)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    schedule = windows;
+    apply_schedule();
+    return;
+}
+
+/**
+ * @brief GekkoFyre::GkBandwidth::addFlow registers a new stream of data that is to draw upon the global download rate.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-27
+ * @param item The download that the flow belongs to, which is its destination upon local storage.
+ * @param host The host the flow receives from, or an empty string should no per-host limit apply.
+ * @return The flow, which is to be given back to GekkoFyre::GkBandwidth::removeFlow() once it has come to an end.
+ */
+std::shared_ptr<GekkoFyre::GkBw::Flow> GekkoFyre::GkBandwidth::addFlow(const std::string &item, const std::string &host)
+{
+    std::shared_ptr<GekkoFyre::GkBw::Flow> flow = std::make_shared<GekkoFyre::GkBw::Flow>();
+    flow->item = item;
+    flow->host = host;
+    flow->bytes = 0;
+    flow->measured = 0;
+    flow->rate = 0;
+    flow->reported = false;
+
+    std::lock_guard<std::mutex> lock(mtx);
+    flows.push_back(flow);
+    return flow;
+}
+
+void GekkoFyre::GkBandwidth::removeFlow(const std::shared_ptr<GekkoFyre::GkBw::Flow> &flow)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    flows.erase(std::remove(flows.begin(), flows.end(), flow), flows.end());
+    return;
+}
+
+/**
+ * @brief GekkoFyre::GkBandwidth::allow says whether there is any bandwidth left within the bucket. Should there not be,
+ * then the transfer ought to pause itself until there is.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-27
+ */
+bool GekkoFyre::GkBandwidth::allow()
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    if (eff_down <= 0) {
+        return true;
+    }
+
+    refill(clk::now());
+    return (tokens >= 0);
+}
+
+/**
+ * @brief GekkoFyre::GkBandwidth::consume takes the given amount of data, which has been received by the given flow, out
+ * of the bucket. The bucket may well go into debt, which is then paid back before anything else is allowed through.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-27
+ */
+void GekkoFyre::GkBandwidth::consume(GekkoFyre::GkBw::Flow &flow, const size_t &bytes)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    flow.bytes += (curl_off_t)bytes;
+    if (eff_down > 0) {
+        tokens -= (double)bytes;
+    }
+
+    return;
+}
+
+/**
+ * @brief GekkoFyre::GkBandwidth::report gives the current receive rate of a flow which enforces its own allotment, such
+ * as the BitTorrent session, rather than drawing upon the bucket.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-27
+ */
+void GekkoFyre::GkBandwidth::report(GekkoFyre::GkBw::Flow &flow, const double &rate)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    flow.reported = true;
+    flow.measured = rate;
+    return;
+}
+
+/**
+ * @brief GekkoFyre::GkBandwidth::rate is the download rate that has been allotted to the given flow.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-27
+ * @return The rate in bytes per second, or '0' for no limit.
+ */
+curl_off_t GekkoFyre::GkBandwidth::rate(const GekkoFyre::GkBw::Flow &flow)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    return flow.rate;
+}
+
+curl_off_t GekkoFyre::GkBandwidth::uploadLimit()
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    return eff_up;
+}
+
+/**
+ * @brief GekkoFyre::GkBandwidth::rebalance divides the global download rate up anew between every flow, no more often
+ * than every 'FYREDL_BW_REBALANCE_INTERVAL' milliseconds. Each flow is first allotted up to what it looks able to make
+ * use of, in proportion to its weight, and whatever is then left over is handed out in the same proportions so that
+ * none of the global rate goes unused. Per-host and per-download limits are never exceeded either way.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-27
+ * @note <https://en.wikipedia.org/wiki/Max-min_fairness>
+ * @return Whether the rates have been divided up anew, or it was too soon to do so.
+ */
+bool GekkoFyre::GkBandwidth::rebalance()
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    const clk::time_point now = clk::now();
+    const double elapsed = std::chrono::duration<double>(now - last_rebalance).count();
+    if ((elapsed * 1000.0) < FYREDL_BW_REBALANCE_INTERVAL) {
+        return false;
+    }
+
+    last_rebalance = now;
+    apply_schedule();
+
+    // Each download's weight is split evenly between its connections, so that a segmented download does not receive
+    // any more than one which is not
+    const size_t count = flows.size();
+    std::unordered_map<std::string, size_t> item_flows;
+    std::unordered_map<std::string, double> host_weight;
+    std::vector<double> weight(count, 1.0);
+    std::vector<double> cap(count, std::numeric_limits<double>::infinity());
+    for (auto const &flow: flows) {
+        ++item_flows[flow->item];
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        GekkoFyre::GkBw::Flow &flow = *flows[i];
+        if (!flow.reported) {
+            const double received = ((double)flow.bytes / elapsed);
+            flow.measured = (flow.measured <= 0) ? received : ((flow.measured + received) / 2);
+            flow.bytes = 0;
+        }
+
+        auto item_weight = item_weights.find(flow.item);
+        weight[i] = ((item_weight != item_weights.end()) ? item_weight->second : 1.0) / item_flows[flow.item];
+        if (!flow.host.empty()) {
+            host_weight[flow.host] += weight[i];
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        const GekkoFyre::GkBw::Flow &flow = *flows[i];
+        auto item_limit = item_limits.find(flow.item);
+        const curl_off_t per_item = (item_limit != item_limits.end()) ? item_limit->second : FYREDL_BW_ITEM_LIMIT;
+        if (per_item > 0) {
+            cap[i] = ((double)per_item / item_flows[flow.item]);
+        }
+
+        if (!flow.host.empty()) {
+            auto host_limit = host_limits.find(flow.host);
+            const curl_off_t per_host = (host_limit != host_limits.end()) ? host_limit->second : FYREDL_BW_HOST_LIMIT;
+            if (per_host > 0) {
+                cap[i] = std::min(cap[i], ((double)per_host * weight[i] / host_weight[flow.host]));
+            }
+        }
+    }
+
+    if (eff_down <= 0) {
+        for (size_t i = 0; i < count; ++i) {
+            flows[i]->rate = std::isinf(cap[i]) ? 0 : std::max((curl_off_t)1, (curl_off_t)cap[i]);
+        }
+
+        return true;
+    }
+
+    std::vector<double> alloc(count, 0.0);
+    std::vector<double> demand(count);
+    for (size_t i = 0; i < count; ++i) {
+        demand[i] = std::min(cap[i], std::max((flows[i]->measured * FYREDL_BW_GROWTH), (double)FYREDL_BW_MIN_RATE));
+    }
+
+    water_fill((double)eff_down, weight, demand, alloc);
+
+    double leftover = (double)eff_down;
+    std::vector<double> headroom(count);
+    for (size_t i = 0; i < count; ++i) {
+        leftover -= alloc[i];
+        headroom[i] = (cap[i] - alloc[i]);
+    }
+
+    if (leftover >= 1.0) {
+        water_fill(leftover, weight, headroom, alloc);
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        flows[i]->rate = std::max((curl_off_t)1, (curl_off_t)alloc[i]);
+    }
+
+    return true;
+}
+
+/**
+ * @brief GekkoFyre::GkBandwidth::refill tops the bucket back up for however long it has been since it was last done so,
+ * up to 'FYREDL_BW_BURST' seconds worth of the global download rate. The caller must hold 'mtx'.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-27
+ * @note <https://en.wikipedia.org/wiki/Token_bucket>
+ */
+void GekkoFyre::GkBandwidth::refill(const clk::time_point &now)
+{
+    const double elapsed = std::chrono::duration<double>(now - last_refill).count();
+    last_refill = now;
+    tokens = std::min((tokens + ((double)eff_down * elapsed)), ((double)eff_down * FYREDL_BW_BURST));
+    return;
+}
+
+/**
+ * @brief GekkoFyre::GkBandwidth::apply_schedule works out which global limits are in effect at the current time of
+ * day. The caller must hold 'mtx'.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-27
+ */
+void GekkoFyre::GkBandwidth::apply_schedule()
+{
+    eff_down = down_limit;
+    eff_up = up_limit;
+    if (!schedule.empty()) {
+        const std::time_t now = std::time(nullptr);
+        const std::tm *local = std::localtime(&now);
+        const int minute = (local->tm_hour * 60) + local->tm_min;
+        for (auto const &window: schedule) {
+            const bool within = (window.begin <= window.end) ? (minute >= window.begin && minute < window.end) :
+                                (minute >= window.begin || minute < window.end);
+            if (within) {
+                eff_down = window.down_limit;
+                eff_up = window.up_limit;
+                break;
+            }
+        }
+    }
+
+    if (eff_down <= 0) {
+        tokens = 0;
+    } else {
+        tokens = std::min(tokens, ((double)eff_down * FYREDL_BW_BURST));
+    }
+
+    return;
+}
+
+/**
+ * @brief GekkoFyre::GkBandwidth::water_fill divides the given budget between flows in proportion to their weights,
+ * whereby any flow that would be given more than its limit is given just its limit, with the remainder going to the
+ * others.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-27
+ * @param budget The rate to be divided up, in bytes per second.
+ * @param weight The weight of each flow.
+ * @param limit The most that each flow may be given from this budget.
+ * @param alloc What each flow has been given, which is added onto.
+ */
+void GekkoFyre::GkBandwidth::water_fill(double budget, const std::vector<double> &weight,
+                                        const std::vector<double> &limit, std::vector<double> &alloc)
+{
+    std::vector<bool> filled(weight.size(), false);
+    while (budget > 0) {
+        double total_weight = 0;
+        for (size_t i = 0; i < weight.size(); ++i) {
+            if (!filled[i]) {
+                total_weight += weight[i];
+            }
+        }
+
+        if (total_weight <= 0) {
+            break;
+        }
+
+        // Any flow whose limit falls short of its share is filled up to its limit, which only raises the share of
+        // those that remain. Once no more fall short, the rest of the budget is divided between them as is.
+        double spent = 0;
+        bool capped = false;
+        for (size_t i = 0; i < weight.size(); ++i) {
+            if (!filled[i] && limit[i] <= (budget * weight[i] / total_weight)) {
+                alloc[i] += std::max(limit[i], 0.0);
+                spent += std::max(limit[i], 0.0);
+                filled[i] = true;
+                capped = true;
+            }
+        }
+
+        if (!capped) {
+            for (size_t i = 0; i < weight.size(); ++i) {
+                if (!filled[i]) {
+                    alloc[i] += (budget * weight[i] / total_weight);
+                }
+            }
+
+            break;
+        }
+
+        budget -= spent;
+    }
+
+    return;
+}
@@ -0,0 +1,113 @@
+/**
+ **  ______             ______ _
+ **  |  ___|            |  _  \ |
+ **  | |_ _   _ _ __ ___| | | | |
+ **  |  _| | | | '__/ _ \ | | | |
+ **  | | | |_| | | |  __/ |/ /| |____
+ **  \_|  \__, |_|  \___|___/ \_____/
+ **        __/ |
+ **       |___/
+ **
+ **   Thank you for using "FyreDL" for your download management needs!
+ **   Copyright (C) 2016-2017. GekkoFyre.
+ **
+ **
+ **   FyreDL is free software: you can redistribute it and/or modify
+ **   it under the terms of the GNU General Public License as published by
+ **   the Free Software Foundation, either version 3 of the License, or
+ **   (at your option) any later version.
+ **
+ **   FyreDL is distributed in the hope that it will be useful,
+ **   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **   GNU General Public License for more details.
+ **
+ **   You should have received a copy of the GNU General Public License
+ **   along with FyreDL.  If not, see <http://www.gnu.org/licenses/>.
+ **
+ **
+ **   The latest source code updates can be obtained from [ 1 ] below at your
+ **   discretion. A web-browser or the 'git' application may be required.
+ **
+ **   [ 1 ] - https://github.com/GekkoFyre/FyreDL
+ **
+ ********************************************************************************/
+
+
+/**
+ * @file bandwidth.hpp
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-27
+ * @brief Divides a single, global download rate between every HTTP(S)/FTP(S) connection and the BitTorrent session,
+ * by way of a token bucket along with per-host and per-download limits, weights and a schedule for the time of day.
+ */
+
+#ifndef FYREDL_BANDWIDTH_HPP
+#define FYREDL_BANDWIDTH_HPP
+
+#include "default_var.hpp"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <chrono>
+
+extern "C" {
+#include <curl/curl.h>
+}
+
+namespace GekkoFyre {
+class GkBandwidth {
+public:
+    GkBandwidth(const GkBandwidth&) = delete;
+    GkBandwidth &operator=(const GkBandwidth&) = delete;
+
+    explicit GkBandwidth(const curl_off_t &down_limit = FYREDL_BW_DOWN_LIMIT,
+                         const curl_off_t &up_limit = FYREDL_BW_UP_LIMIT);
+    ~GkBandwidth();
+
+    static GkBandwidth &instance();
+    static std::string hostOf(const std::string &url);
+
+    void setGlobalLimit(const curl_off_t &down_limit, const curl_off_t &up_limit);
+    void setHostLimit(const std::string &host, const curl_off_t &limit);
+    void setItemLimit(const std::string &item, const curl_off_t &limit);
+    void setItemWeight(const std::string &item, const double &weight);
+    void setSchedule(const std::vector<GekkoFyre::GkBw::Window> &windows);
+
+    std::shared_ptr<GekkoFyre::GkBw::Flow> addFlow(const std::string &item, const std::string &host);
+    void removeFlow(const std::shared_ptr<GekkoFyre::GkBw::Flow> &flow);
+
+    bool allow();
+    void consume(GekkoFyre::GkBw::Flow &flow, const size_t &bytes);
+    void report(GekkoFyre::GkBw::Flow &flow, const double &rate);
+    curl_off_t rate(const GekkoFyre::GkBw::Flow &flow);
+    curl_off_t uploadLimit();
+    bool rebalance();
+
+private:
+    typedef std::chrono::steady_clock clk;
+
+    std::vector<std::shared_ptr<GekkoFyre::GkBw::Flow>> flows;
+    std::unordered_map<std::string, curl_off_t> host_limits;
+    std::unordered_map<std::string, curl_off_t> item_limits;
+    std::unordered_map<std::string, double> item_weights;
+    std::vector<GekkoFyre::GkBw::Window> schedule;
+    curl_off_t down_limit;                    // The global download rate, outside of any window within 'schedule'
+    curl_off_t up_limit;                      // The global upload rate, outside of any window within 'schedule'
+    curl_off_t eff_down;                      // The global download rate that is in effect right now
+    curl_off_t eff_up;                        // The global upload rate that is in effect right now
+    double tokens;                            // Bytes that may still be received before the bucket runs dry
+    clk::time_point last_refill;
+    clk::time_point last_rebalance;
+    std::mutex mtx;
+
+    void refill(const clk::time_point &now);
+    void apply_schedule();
+    static void water_fill(double budget, const std::vector<double> &weight, const std::vector<double> &limit,
+                           std::vector<double> &alloc);
+};
+}
+
+#endif // FYREDL_BANDWIDTH_HPP
@@ -43,6 +43,7 @@
 #include "cmnroutines.hpp"
 #include "default_var.hpp"
 #include "csv.hpp"
+#include "db_record.hpp"
 #include <leveldb/db.h>
 #include <leveldb/write_batch.h>
 #include <leveldb/cache.h>
@@ -55,9 +56,11 @@
 #include <libtorrent/magnet_uri.hpp>
 #include <libtorrent/hex.hpp>
 #include <cmath>
+#include <cstring>
 #include <iostream>
 #include <cstdlib>
 #include <random>
+#include <unordered_set>
 #include <QUrl>
 #include <QDir>
 #include <QFile>
@@ -96,12 +99,25 @@ using namespace libtorrent;
 namespace sys = boost::system;
 namespace fs = boost::filesystem;
 
+std::unordered_map<std::string, std::pair<std::string, bool>> GekkoFyre::CmnRoutines::path_index;
+std::mutex GekkoFyre::CmnRoutines::path_index_mtx;
+std::deque<GekkoFyre::CmnRoutines::GroupCommit *> GekkoFyre::CmnRoutines::commit_queue;
+std::mutex GekkoFyre::CmnRoutines::commit_mtx;
+std::condition_variable GekkoFyre::CmnRoutines::commit_cond;
+std::map<std::string, GekkoFyre::GkCurl::CurlDlInfo> GekkoFyre::CmnRoutines::curl_cache;
+std::map<std::string, GekkoFyre::GkTorrent::TorrentInfo> GekkoFyre::CmnRoutines::torrent_cache;
+bool GekkoFyre::CmnRoutines::record_cache_loaded = false;
+std::mutex GekkoFyre::CmnRoutines::record_cache_mtx;
+
 GekkoFyre::CmnRoutines::CmnRoutines(const GekkoFyre::GkFile::FileDb &database, QObject *parent) : QObject(parent)
 {
     setlocale (LC_ALL, "");
 
     try {
         db = database;
+        if (db.db) {
+            convert_legacy_download_ids(db);
+        }
     } catch (const std::exception &e) {
         QMessageBox::warning(nullptr, tr("Error!"), e.what(), QMessageBox::Ok);
         QApplication::exit(-1);
@@ -398,79 +414,99 @@ bool GekkoFyre::CmnRoutines::convertBool_fromInt(const int &value) noexcept {
 }
 
 /**
- * @brief GekkoFyre::CmnRoutines::add_download_id adds a Unique ID (key) to the Google LevelDB database as a key-value store, along
- * with the file-path of the download's location (value) on the user's local storage.
+ * @brief GekkoFyre::CmnRoutines::add_download_id adds a Unique ID to the Google LevelDB database, under a key of its own
+ * that is prefixed with 'LEVELDB_PREFIX_UNIQUE_ID', along with the file-path of the download's location (value) on the
+ * user's local storage. Nothing else within the index is touched, no matter how large the history has become. The
+ * reverse entry, from the file-path back to the Unique ID, and the record of the download itself are all committed
+ * within the same batch.
  * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
  * @date 2017-08-03
  * @param file_path The value to be stored.
  * @param db_struct The database connection object.
+ * @param record_key If not empty, the second part to the key that 'record' is to be stored under.
+ * @param record The record of the download, as given by encode_curl_record() or encode_torrent_record().
  * @return The Unique ID that was created as a result of this function's action.
  */
 std::string GekkoFyre::CmnRoutines::add_download_id(const std::string &file_path, const GekkoFyre::GkFile::FileDb &db_struct,
-                                                    const bool &is_torrent, const std::string &override_unique_id)
+                                                    const bool &is_torrent, const std::string &override_unique_id,
+                                                    const std::string &record_key, const std::string &record)
 {
-    leveldb::ReadOptions read_opt;
-    leveldb::Status s;
-    read_opt.verify_checksums = true;
     std::string key;
-
     if (!override_unique_id.empty()) {
         key = override_unique_id;
     } else {
         key = createId(FYREDL_UNIQUE_ID_DIGIT_COUNT);
     }
 
-    std::string csv_read_data;
-    std::lock_guard<std::mutex> locker(db_mutex);
-    s = db_struct.db->Get(read_opt, LEVELDB_STORE_UNIQUE_ID, &csv_read_data);
-
-    std::stringstream csv_out;
-    if (!csv_read_data.empty() && csv_read_data.size() > CFG_CSV_MIN_PARSE_SIZE) {
-        GkCsvReader csv_reader(3, true, csv_read_data, LEVELDB_CSV_UID_KEY, LEVELDB_CSV_UID_VALUE1, LEVELDB_CSV_UID_VALUE2);
-        std::string uid_key, path, is_torrent_bool;
-        while (csv_reader.read_row(uid_key, path, is_torrent_bool)) {
-            if (!uid_key.empty() && !path.empty()) {
-                csv_out << uid_key << "," << path << "," << is_torrent_bool << std::endl;
-            }
-        }
-    }
-
-    csv_out << key << "," << file_path << "," << is_torrent <<std::endl;
-
-    leveldb::WriteOptions write_options;
-    write_options.sync = true;
     leveldb::WriteBatch batch;
-    batch.Delete(LEVELDB_STORE_UNIQUE_ID);
-    batch.Put(LEVELDB_STORE_UNIQUE_ID, csv_out.str());
-    s = db_struct.db->Write(write_options, &batch);
+    put_download_id(batch, key, file_path, is_torrent, record_key, record);
+
+    leveldb::Status s;
+    s = commit_batch(batch, db_struct);
     if (!s.ok()) {
         throw std::runtime_error(s.ToString());
     }
 
+    std::lock_guard<std::mutex> locker(path_index_mtx);
+    path_index[file_path] = std::make_pair(key, is_torrent);
     return key;
 }
 
-bool GekkoFyre::CmnRoutines::del_download_id(const std::string &unique_id, const GekkoFyre::GkFile::FileDb &db_struct,
-                                             const bool &is_torrent)
+/**
+ * @brief GekkoFyre::CmnRoutines::put_download_id places the Unique ID of a download, the reverse entry from its file-path,
+ * and its record (if any) into the given batch, ready to be committed.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-24
+ * @see GekkoFyre::CmnRoutines::add_download_id(), GekkoFyre::CmnRoutines::addCurlItems()
+ */
+void GekkoFyre::CmnRoutines::put_download_id(leveldb::WriteBatch &batch, const std::string &unique_id,
+                                             const std::string &file_path, const bool &is_torrent,
+                                             const std::string &record_key, const std::string &record)
 {
-    auto download_ids = extract_download_ids(db_struct, is_torrent);
-    std::ostringstream csv_data;
-    for (const auto &id: download_ids) {
-        if (id.first != unique_id) {
-            csv_data << id.first << ",";
-            csv_data << id.second.first << ",";
-            csv_data << id.second.second << std::endl;
-        }
+    batch.Put(std::string(LEVELDB_PREFIX_UNIQUE_ID) + unique_id, encode_download_id(LEVELDB_RECORD_TYPE_UNIQUE_ID, file_path, is_torrent));
+    batch.Put(std::string(LEVELDB_PREFIX_FILE_PATH) + file_path, encode_download_id(LEVELDB_RECORD_TYPE_FILE_PATH, unique_id, is_torrent));
+    if (!record_key.empty()) {
+        batch.Put(multipart_key({unique_id, record_key}), record);
     }
 
+    return;
+}
+
+bool GekkoFyre::CmnRoutines::del_download_id(const std::string &unique_id, const GekkoFyre::GkFile::FileDb &db_struct,
+                                             const bool &is_torrent, const std::string &record_key)
+{
     leveldb::Status s;
-    leveldb::WriteOptions write_options;
-    write_options.sync = true;
+    leveldb::ReadOptions read_opt;
+    read_opt.verify_checksums = true;
     leveldb::WriteBatch batch;
-    std::lock_guard<std::mutex> locker(db_mutex);
-    batch.Delete(LEVELDB_STORE_UNIQUE_ID);
-    batch.Put(LEVELDB_STORE_UNIQUE_ID, csv_data.str());
-    s = db_struct.db->Write(write_options, &batch);
+    std::string file_path;
+
+    {
+        std::lock_guard<std::mutex> locker(db_mutex);
+        const std::string id_key = std::string(LEVELDB_PREFIX_UNIQUE_ID) + unique_id;
+        std::string record;
+        s = db_struct.db->Get(read_opt, id_key, &record);
+        if (s.ok()) {
+            // Only remove the reverse entry if it still points back at this Unique ID, as the path may have been
+            // reused by a newer download since
+            file_path = decode_download_id(record, LEVELDB_RECORD_TYPE_UNIQUE_ID).first;
+            const std::string path_key = std::string(LEVELDB_PREFIX_FILE_PATH) + file_path;
+            s = db_struct.db->Get(read_opt, path_key, &record);
+            if (s.ok() && decode_download_id(record, LEVELDB_RECORD_TYPE_FILE_PATH).first == unique_id) {
+                batch.Delete(path_key);
+            } else {
+                file_path.clear();
+            }
+        }
+
+        batch.Delete(id_key);
+    }
+
+    if (!record_key.empty()) {
+        batch.Delete(multipart_key({unique_id, record_key}));
+    }
+
+    s = commit_batch(batch, db_struct);
     if (!s.ok()) {
         QMessageBox::warning(nullptr, tr("Error!"), tr("There was an issue while deleting Unique ID, \"%1\", from the "
                                                                "database. See below.\n\n%2")
@@ -478,9 +514,100 @@ bool GekkoFyre::CmnRoutines::del_download_id(const std::string &unique_id, const
         return false;
     }
 
+    if (!file_path.empty()) {
+        std::lock_guard<std::mutex> locker(path_index_mtx);
+        path_index.erase(file_path);
+    }
+
     return true;
 }
 
+/**
+ * @brief GekkoFyre::CmnRoutines::encode_download_id forms the value that is stored alongside each Unique ID, or alongside
+ * each file-path within the reverse index. Both take the same shape and only differ in their record type.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-20
+ * @param record_type Either 'LEVELDB_RECORD_TYPE_UNIQUE_ID' or 'LEVELDB_RECORD_TYPE_FILE_PATH'.
+ * @param value The file-path of the download, or its Unique ID, respectively.
+ * @param is_torrent Whether it's a BitTorrent item or not.
+ * @return The record, ready to be written to the database.
+ */
+std::string GekkoFyre::CmnRoutines::encode_download_id(const uint8_t &record_type, const std::string &value,
+                                                       const bool &is_torrent)
+{
+    GkRecordWriter record(record_type, LEVELDB_RECORD_VERSION);
+    record.put_u8(is_torrent);
+    record.put_str(value);
+    return record.data();
+}
+
+/**
+ * @brief GekkoFyre::CmnRoutines::decode_download_id reads back the value that encode_download_id() formed.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-19
+ * @param record The value, as read from the database.
+ * @param record_type The type of record that is expected.
+ * @return The storage path of the download (or its Unique ID), and whether it's a BitTorrent item or not.
+ */
+std::pair<std::string, bool> GekkoFyre::CmnRoutines::decode_download_id(const std::string &record, const uint8_t &record_type)
+{
+    GkRecordReader in(record, record_type);
+    bool is_torrent = (in.get_u8() != 0);
+    std::string value = in.get_str();
+    return std::make_pair(value, is_torrent);
+}
+
+/**
+ * @brief GekkoFyre::CmnRoutines::convert_legacy_download_ids converts the older index of Unique IDs, which was kept as a
+ * single CSV blob under 'LEVELDB_STORE_UNIQUE_ID', over into a key per Unique ID. The blob is deleted within the same
+ * batch, so this only ever happens the once.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-19
+ * @param db_struct The database connection object.
+ */
+void GekkoFyre::CmnRoutines::convert_legacy_download_ids(const GekkoFyre::GkFile::FileDb &db_struct)
+{
+    leveldb::ReadOptions read_opt;
+    leveldb::Status s;
+    read_opt.verify_checksums = true;
+
+    std::string csv_read_data;
+    {
+        std::lock_guard<std::mutex> locker(db_mutex);
+        s = db_struct.db->Get(read_opt, LEVELDB_STORE_UNIQUE_ID, &csv_read_data);
+    }
+
+    if (s.IsNotFound()) {
+        return;
+    }
+
+    if (!s.ok()) {
+        throw std::runtime_error(s.ToString());
+    }
+
+    leveldb::WriteBatch batch;
+    if (!csv_read_data.empty() && csv_read_data.size() > CFG_CSV_MIN_PARSE_SIZE) {
+        GkCsvReader csv_in(3, true, csv_read_data, LEVELDB_CSV_UID_KEY, LEVELDB_CSV_UID_VALUE1, LEVELDB_CSV_UID_VALUE2);
+        std::string unique_id, path;
+        int is_torrent_csv;
+        while (csv_in.read_row(unique_id, path, is_torrent_csv)) {
+            if (!unique_id.empty() && !path.empty()) {
+                bool is_torrent = convertBool_fromInt(is_torrent_csv);
+                batch.Put(std::string(LEVELDB_PREFIX_UNIQUE_ID) + unique_id, encode_download_id(LEVELDB_RECORD_TYPE_UNIQUE_ID, path, is_torrent));
+                batch.Put(std::string(LEVELDB_PREFIX_FILE_PATH) + path, encode_download_id(LEVELDB_RECORD_TYPE_FILE_PATH, unique_id, is_torrent));
+            }
+        }
+    }
+
+    batch.Delete(LEVELDB_STORE_UNIQUE_ID);
+    s = commit_batch(batch, db_struct);
+    if (!s.ok()) {
+        throw std::runtime_error(s.ToString());
+    }
+
+    return;
+}
+
 /**
  * @brief GekkoFyre::CmnRoutines::add_item_db adds an item to the database as a key-value pair. With regard to the key, it
  * is formed as a combination of the parameters 'download_id' and 'key'.
@@ -498,15 +625,12 @@ void GekkoFyre::CmnRoutines::add_item_db(const std::string download_id, const st
         value = "";
     }
 
-    leveldb::WriteOptions write_options;
-    write_options.sync = true;
     leveldb::WriteBatch batch;
-    std::lock_guard<std::mutex> locker(db_mutex);
     std::string key_joined = multipart_key({download_id, key});
     batch.Delete(key_joined);
     batch.Put(key_joined, value);
     leveldb::Status s;
-    s = db_struct.db->Write(write_options, &batch);
+    s = commit_batch(batch, db_struct);
     if (!s.ok()) {
         throw std::runtime_error(s.ToString());
     }
@@ -517,14 +641,11 @@ void GekkoFyre::CmnRoutines::add_item_db(const std::string download_id, const st
 void GekkoFyre::CmnRoutines::del_item_db(const std::string download_id, const std::string &key,
                                          const GekkoFyre::GkFile::FileDb &db_struct)
 {
-    leveldb::WriteOptions write_options;
-    write_options.sync = true;
     leveldb::WriteBatch batch;
-    std::lock_guard<std::mutex> locker(db_mutex);
     std::string key_joined = multipart_key({download_id, key});
     batch.Delete(key_joined);
     leveldb::Status s;
-    s = db_struct.db->Write(write_options, &batch);
+    s = commit_batch(batch, db_struct);
     if (!s.ok()) {
         throw std::runtime_error(s.ToString());
     }
@@ -563,9 +684,134 @@ std::string GekkoFyre::CmnRoutines::read_item_db(const std::string download_id,
     }
 }
 
+/**
+ * @brief GekkoFyre::CmnRoutines::find_item_db reads an item from the Google LevelDB database, much like read_item_db(),
+ * except that a missing key is not treated as an error.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-18
+ * @param download_id The first part to the key.
+ * @param key The second part to the key.
+ * @param value Where the value is to be read into.
+ * @param db_struct The database object used for connecting to the Google LevelDB database.
+ * @return Whether the key was found or not.
+ */
+bool GekkoFyre::CmnRoutines::find_item_db(const std::string &download_id, const std::string &key, std::string &value,
+                                          const GekkoFyre::GkFile::FileDb &db_struct)
+{
+    leveldb::ReadOptions read_opt;
+    leveldb::Status s;
+    read_opt.verify_checksums = true;
+    std::string key_joined = multipart_key({download_id, key});
+
+    std::lock_guard<std::mutex> locker(db_mutex);
+    s = db_struct.db->Get(read_opt, key_joined, &value);
+    if (s.IsNotFound()) {
+        return false;
+    }
+
+    if (!s.ok()) {
+        throw std::runtime_error(s.ToString());
+    }
+
+    return true;
+}
+
+/**
+ * @brief GekkoFyre::CmnRoutines::replace_legacy_items writes out the record for a download while deleting the keys of
+ * the older layout that it supersedes, all within the one batch so that the download is never left half converted.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-18
+ * @param download_id The Unique ID of the download.
+ * @param record_key The second part to the key the record is to be stored under.
+ * @param record The record itself.
+ * @param legacy_keys The (full) keys that are to be deleted.
+ * @param db_struct The database object used for connecting to the Google LevelDB database.
+ */
+void GekkoFyre::CmnRoutines::replace_legacy_items(const std::string &download_id, const std::string &record_key,
+                                                  const std::string &record, const std::vector<std::string> &legacy_keys,
+                                                  const GekkoFyre::GkFile::FileDb &db_struct)
+{
+    leveldb::WriteBatch batch;
+    for (const auto &key: legacy_keys) {
+        batch.Delete(key);
+    }
+
+    batch.Put(multipart_key({download_id, record_key}), record);
+
+    leveldb::Status s;
+    s = commit_batch(batch, db_struct);
+    if (!s.ok()) {
+        throw std::runtime_error(s.ToString());
+    }
+
+    return;
+}
+
+/**
+ * @brief GekkoFyre::CmnRoutines::commit_batch is what every write to the Google LevelDB database goes through, and is
+ * synced to disk before returning. With 'FYREDL_DB_GROUP_COMMIT' enabled, any batches that arrive from other threads
+ * whilst a commit is under way are queued up and then merged together by the first of them into a single write, under
+ * the one sync.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-20
+ * @note <https://github.com/google/leveldb/blob/master/doc/index.md#synchronous-writes>
+ * @param batch The changes to be applied, atomically.
+ * @param db_struct The database object used for connecting to the Google LevelDB database.
+ * @return The outcome of the commit.
+ */
+leveldb::Status GekkoFyre::CmnRoutines::commit_batch(leveldb::WriteBatch &batch, const GekkoFyre::GkFile::FileDb &db_struct)
+{
+    leveldb::WriteOptions sync_options;
+    sync_options.sync = true;
+    if (!FYREDL_DB_GROUP_COMMIT) {
+        return db_struct.db->Write(sync_options, &batch);
+    }
+
+    GroupCommit self;
+    self.batch = &batch;
+    self.done = false;
+
+    std::unique_lock<std::mutex> locker(commit_mtx);
+    commit_queue.push_back(&self);
+    commit_cond.wait(locker, [&]() { return self.done || commit_queue.front() == &self; });
+    if (self.done) {
+        // Another thread has already committed this batch on our behalf
+        return self.status;
+    }
+
+    // This thread is now the leader, and commits everything that has queued up so far
+    std::vector<GroupCommit *> group(commit_queue.begin(), commit_queue.end());
+    locker.unlock();
+
+    // The group is merged into the one batch and written under the one sync, so that every batch within it is either
+    // applied and durable or not applied at all, and they all truly share the outcome
+    leveldb::Status s;
+    if (group.size() == 1) {
+        s = db_struct.db->Write(sync_options, group.front()->batch);
+    } else {
+        leveldb::WriteBatch merged;
+        for (auto commit: group) {
+            merged.Append(*commit->batch);
+        }
+
+        s = db_struct.db->Write(sync_options, &merged);
+    }
+
+    locker.lock();
+    for (auto commit: group) {
+        commit_queue.pop_front();
+        commit->status = s;
+        commit->done = true;
+    }
+
+    commit_cond.notify_all();
+    return s;
+}
+
 /**
  * @brief GekkoFyre::CmnRoutines::determine_download_id determines the Unique ID for a given path of a downloadable item's
- * location on the user's local storage.
+ * location on the user's local storage. This is a point lookup, firstly within the in-memory copy of the reverse index
+ * and then within the database itself.
  * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
  * @date 2017-08-03
  * @param file_path The file path to use in extrapolating the Unique ID.
@@ -575,49 +821,75 @@ std::string GekkoFyre::CmnRoutines::read_item_db(const std::string download_id,
 std::pair<std::string, bool> GekkoFyre::CmnRoutines::determine_download_id(const std::string &file_path,
                                                           const GekkoFyre::GkFile::FileDb &db_struct)
 {
+    {
+        std::lock_guard<std::mutex> locker(path_index_mtx);
+        auto cached = path_index.find(file_path);
+        if (cached != path_index.end()) {
+            return cached->second;
+        }
+    }
+
     leveldb::ReadOptions read_opt;
     leveldb::Status s;
     read_opt.verify_checksums = true;
+    const std::string path_key = std::string(LEVELDB_PREFIX_FILE_PATH) + file_path;
 
-    std::string key = createId(FYREDL_UNIQUE_ID_DIGIT_COUNT);
-    std::string csv_read_data;
-    std::lock_guard<std::mutex> locker(db_mutex);
-    s = db_struct.db->Get(read_opt, LEVELDB_STORE_UNIQUE_ID, &csv_read_data);
-    if (!s.ok()) {
-        throw std::runtime_error(s.ToString());
-    }
+    std::pair<std::string, bool> identifier = std::make_pair("", false);
+    bool backfill = false;
+    {
+        std::lock_guard<std::mutex> locker(db_mutex);
+        std::string record;
+        s = db_struct.db->Get(read_opt, path_key, &record);
+        if (s.ok()) {
+            identifier = decode_download_id(record, LEVELDB_RECORD_TYPE_FILE_PATH);
+        } else if (s.IsNotFound()) {
+            // Histories written before the reverse index existed have to be scanned the once, with the missing entry
+            // being filled in as it is found
+            const leveldb::Slice prefix(LEVELDB_PREFIX_UNIQUE_ID);
+            std::unique_ptr<leveldb::Iterator> it(db_struct.db->NewIterator(read_opt));
+            for (it->Seek(prefix); it->Valid() && it->key().starts_with(prefix); it->Next()) {
+                auto item = decode_download_id(it->value().ToString(), LEVELDB_RECORD_TYPE_UNIQUE_ID);
+                if (item.first == file_path) {
+                    identifier = std::make_pair(it->key().ToString().substr(prefix.size()), item.second);
+                    break;
+                }
+            }
 
-    if (!csv_read_data.empty() && csv_read_data.size() > CFG_CSV_MIN_PARSE_SIZE) {
-        QMap<std::string, std::pair<std::string, bool>> cache;
-        GkCsvReader csv_in(3, true, csv_read_data, LEVELDB_CSV_UID_KEY, LEVELDB_CSV_UID_VALUE1, LEVELDB_CSV_UID_VALUE2);
-        if (!csv_in.has_column(LEVELDB_CSV_UID_KEY) || !csv_in.has_column(LEVELDB_CSV_UID_VALUE1) ||
-            !csv_in.has_column(LEVELDB_CSV_UID_VALUE2)) {
-            throw std::invalid_argument(tr("Information provided from database is invalid!").toStdString());
-        }
+            if (!it->status().ok()) {
+                throw std::runtime_error(it->status().ToString());
+            }
 
-        std::string unique_id, path, is_torrent_csv_str;
-        int is_torrent_csv = 0;
-        while (csv_in.read_row(unique_id, path, is_torrent_csv_str)) {
-            is_torrent_csv = std::atoi(is_torrent_csv_str.c_str());
-            cache.insert(unique_id, std::make_pair(path, convertBool_fromInt(is_torrent_csv)));
+            backfill = !identifier.first.empty();
+        } else {
+            throw std::runtime_error(s.ToString());
         }
+    }
 
-        for (const auto &item: cache.toStdMap()) {
-            if (item.second.first == file_path) {
-                return std::make_pair(item.first, item.second.second);
-            }
+    if (backfill) {
+        // Like every other write, this goes through the one path so that it is synced (and grouped) as they are
+        leveldb::WriteBatch batch;
+        batch.Put(path_key, encode_download_id(LEVELDB_RECORD_TYPE_FILE_PATH, identifier.first, identifier.second));
+        s = commit_batch(batch, db_struct);
+        if (!s.ok()) {
+            std::cerr << s.ToString() << std::endl;
         }
     }
 
+    if (!identifier.first.empty()) {
+        std::lock_guard<std::mutex> locker(path_index_mtx);
+        path_index[file_path] = identifier;
+        return identifier;
+    }
+
     std::cerr << tr("Unable to determine the Unique ID from the given storage path, \"%1\"")
             .arg(QString::fromStdString(file_path)).toStdString() << std::endl;
     return std::make_pair("", false);
 }
 
 /**
- * @brief GekkoFyre::CmnRoutines::extract_download_ids extracts all the downloadable Unique IDs from the Google LevelDB database
- * and presents them as a QMap object, containing as the value the path on the local storage to the item and whether
- * it's a HTTP/FTP or BitTorrent downloadable.
+ * @brief GekkoFyre::CmnRoutines::extract_download_ids extracts all the downloadable Unique IDs from the Google LevelDB database,
+ * by way of a single range scan over the keys prefixed with 'LEVELDB_PREFIX_UNIQUE_ID', and presents them as a map
+ * containing as the value the path on the local storage to the item and whether it's a HTTP/FTP or BitTorrent downloadable.
  * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
  * @date 2017-08-03
  * @param db_struct The database object used to connect to the Google LevelDB database on the user's local storage.
@@ -631,36 +903,24 @@ std::unordered_map<std::string, std::pair<std::string, bool>> GekkoFyre::CmnRout
 {
     leveldb::ReadOptions read_opt;
     read_opt.verify_checksums = true;
-
-    std::string csv_read_data;
-    std::lock_guard<std::mutex> locker(db_mutex);
-    db_struct.db->Get(read_opt, LEVELDB_STORE_UNIQUE_ID, &csv_read_data);
+    const leveldb::Slice prefix(LEVELDB_PREFIX_UNIQUE_ID);
 
     std::unordered_map<std::string, std::pair<std::string, bool>> cache;
-    std::stringstream csv_out;
-    if (!csv_read_data.empty() && csv_read_data.size() > CFG_CSV_MIN_PARSE_SIZE) {
-        GkCsvReader csv_in(3, true, csv_read_data, LEVELDB_CSV_UID_KEY, LEVELDB_CSV_UID_VALUE1, LEVELDB_CSV_UID_VALUE2);
-
-        std::string unique_id, path, is_torrent_csv_str;
-        bool is_torrent_csv = 0;
-        while (csv_in.read_row(unique_id, path, is_torrent_csv_str)) {
-            is_torrent_csv = convertBool_fromInt(std::atoi(is_torrent_csv_str.c_str()));
-            if (torrentsOnly) {
-                // Only accept download items marked as 'BitTorrent'
-                if (is_torrent_csv) {
-                    cache.insert(std::make_pair(unique_id, std::make_pair(path, convertBool_fromInt(is_torrent_csv))));
-                }
-            }
-
-            if (!torrentsOnly) {
-                // Only accept download items marked as 'HTTP/FTP'
-                if (!is_torrent_csv) {
-                    cache.insert(std::make_pair(unique_id, std::make_pair(path, convertBool_fromInt(is_torrent_csv))));
-                }
-            }
+    std::lock_guard<std::mutex> locker(db_mutex);
+    std::unique_ptr<leveldb::Iterator> it(db_struct.db->NewIterator(read_opt));
+    for (it->Seek(prefix); it->Valid() && it->key().starts_with(prefix); it->Next()) {
+        auto item = decode_download_id(it->value().ToString(), LEVELDB_RECORD_TYPE_UNIQUE_ID);
+        // Only accept download items marked as 'BitTorrent' if 'torrentsOnly' is true, otherwise only those marked
+        // as 'HTTP/FTP'
+        if (item.second == torrentsOnly) {
+            cache.insert(std::make_pair(it->key().ToString().substr(prefix.size()), item));
         }
     }
 
+    if (!it->status().ok()) {
+        throw std::runtime_error(it->status().ToString());
+    }
+
     return cache;
 }
 
@@ -734,11 +994,27 @@ unsigned long int GekkoFyre::CmnRoutines::freeDiskSpace(const QString &path)
  * @param file_dest The destination of the file you wish to hash.
  * @param hash_type The crypto type you wish to use, or if given GekkoFyre::HashType::Analyzing, attempt a search of the
  * correct crypto used.
+ * @param progress Called after every block that has been read in, with how many bytes have been hashed thus far out of
+ * the whole file. As this function touches nothing but the file itself, it may well be called from another thread.
+ * @param cancel Checked upon every block that is read in, whereupon the hashing is given up on (by way of an exception)
+ * should it have been set.
  * @return The checksum, in hexadecimal format for portability reasons.
  */
 GekkoFyre::GkFile::FileHash GekkoFyre::CmnRoutines::cryptoFileHash(const QString &file_dest, const GekkoFyre::HashType &hash_type,
-                                                                   const QString &given_hash_val)
+                                                                   const QString &given_hash_val,
+                                                                   const std::function<void(const qint64 &done, const qint64 &total)> &progress,
+                                                                   const std::atomic<bool> *cancel)
 {
+    // Checksums are worked out in lowercase hexadecimal, whereas one that was given may be in either case, and so it is
+    // brought into line here rather than wherever it may have come from
+    const QString given_hash = given_hash_val.trimmed().toLower();
+
+    auto cancelled = [cancel, &file_dest]() {
+        if (cancel != nullptr && cancel->load()) {
+            throw std::runtime_error(tr("The checksum of \"%1\" was no longer needed.").arg(file_dest).toStdString());
+        }
+    };
+
     GekkoFyre::GkFile::FileHash info;
     QFile f(file_dest);
     fs::path boost_file_path(file_dest.toStdString());
@@ -755,25 +1031,39 @@ GekkoFyre::GkFile::FileHash GekkoFyre::CmnRoutines::cryptoFileHash(const QString
              hash_type == GekkoFyre::HashType::SHA256||  hash_type == GekkoFyre::HashType::SHA512 ||
              hash_type == GekkoFyre::HashType::SHA3_256 ||  hash_type == GekkoFyre::HashType::SHA3_512) {
             QCryptographicHash hash(convHashType_toAlgo(hash_type));
-            if (hash.addData(&f)) {
-                result = hash.result();
-                info.checksum = result.toHex();
-                if (!given_hash_val.isEmpty()) {
-                    // There is a given hash to compare against!
-                    if (info.checksum == given_hash_val) {
-                        // The calculated checksum MATCHES the given hash!
-                        info.hash_verif = GekkoFyre::HashVerif::Verified;
-                        return info;
-                    } else {
-                        // The calculated checksum does NOT match the given hash!
-                        info.hash_verif = GekkoFyre::HashVerif::Corrupt;
-                        return info;
-                    }
+            QByteArray block;
+            qint64 hashed = 0;
+            while (!(block = f.read(FYREDL_HASH_BLOCK_SIZE)).isEmpty()) {
+                cancelled();
+                hash.addData(block);
+                hashed += block.size();
+                if (progress) {
+                    progress(hashed, f.size());
+                }
+            }
+
+            if (f.error() != QFileDevice::NoError) {
+                throw std::runtime_error(tr("Unable to read \"%1\" whilst working out its checksum: %2")
+                                                 .arg(file_dest).arg(f.errorString()).toStdString());
+            }
+
+            result = hash.result();
+            info.checksum = result.toHex();
+            if (!given_hash.isEmpty()) {
+                // There is a given hash to compare against!
+                if (info.checksum == given_hash) {
+                    // The calculated checksum MATCHES the given hash!
+                    info.hash_verif = GekkoFyre::HashVerif::Verified;
+                    return info;
                 } else {
-                    // There is no given hash to compare against
-                    info.hash_verif = GekkoFyre::HashVerif::NotApplicable;
+                    // The calculated checksum does NOT match the given hash!
+                    info.hash_verif = GekkoFyre::HashVerif::Corrupt;
                     return info;
                 }
+            } else {
+                // There is no given hash to compare against
+                info.hash_verif = GekkoFyre::HashVerif::NotApplicable;
+                return info;
             }
         } else if (hash_type == GekkoFyre::HashType::None) {
             info.hash_type = GekkoFyre::HashType::None;
@@ -781,31 +1071,64 @@ GekkoFyre::GkFile::FileHash GekkoFyre::CmnRoutines::cryptoFileHash(const QString
             info.checksum = "";
             return info;
         } else {
-            // We need to find the hash-type!
+            if (given_hash.isEmpty()) {
+                // Without a given checksum there is nothing to tell the candidates apart by, so none are worked out
+                info.hash_verif = GekkoFyre::HashVerif::NotApplicable;
+                info.hash_type = GekkoFyre::HashType::CannotDetermine;
+                info.checksum = "";
+                return info;
+            }
+
+            // We need to find the hash-type! Rather than read the file once per candidate, it is read the once in large
+            // blocks, with each block being fed to every candidate in turn. Only those candidates whose checksums are as
+            // long as the given one can possibly match it, so the others are not worked out at all.
             std::vector<QString> vec_hash_val;
             std::vector<GekkoFyre::HashType> vec_hash_type;
-            vec_hash_type.push_back(GekkoFyre::HashType::MD5);
-            vec_hash_type.push_back(GekkoFyre::HashType::SHA1);
-            vec_hash_type.push_back(GekkoFyre::HashType::SHA256);
-            vec_hash_type.push_back(GekkoFyre::HashType::SHA512);
-            vec_hash_type.push_back(GekkoFyre::HashType::SHA3_256);
-            vec_hash_type.push_back(GekkoFyre::HashType::SHA3_512);
-            for (size_t i = 0; i < vec_hash_type.size(); ++i) {
-                QCryptographicHash hash(convHashType_toAlgo(vec_hash_type.at(i)));
-                if (hash.addData(&f)) {
-                    result = hash.result();
-                    vec_hash_val.push_back(result.toHex());
+            std::vector<std::unique_ptr<QCryptographicHash>> vec_hash;
+            const GekkoFyre::HashType candidates[] = {GekkoFyre::HashType::MD5, GekkoFyre::HashType::SHA1,
+                                                      GekkoFyre::HashType::SHA256, GekkoFyre::HashType::SHA512,
+                                                      GekkoFyre::HashType::SHA3_256, GekkoFyre::HashType::SHA3_512};
+            for (auto const &candidate: candidates) {
+                std::unique_ptr<QCryptographicHash> hash(new QCryptographicHash(convHashType_toAlgo(candidate)));
+                if ((hash->result().size() * 2) != given_hash.size()) {
+                    continue;
+                }
+
+                hash->reset();
+                vec_hash_type.push_back(candidate);
+                vec_hash.push_back(std::move(hash));
+            }
+
+            QByteArray block;
+            qint64 hashed = 0;
+            while (!vec_hash.empty() && !(block = f.read(FYREDL_HASH_BLOCK_SIZE)).isEmpty()) {
+                cancelled();
+                for (auto const &hash: vec_hash) {
+                    hash->addData(block);
+                }
+
+                hashed += block.size();
+                if (progress) {
+                    progress(hashed, f.size());
                 }
             }
 
+            if (f.error() != QFileDevice::NoError) {
+                throw std::runtime_error(tr("Unable to read \"%1\" whilst working out its checksum: %2")
+                                                 .arg(file_dest).arg(f.errorString()).toStdString());
+            }
+
+            for (size_t i = 0; i < vec_hash.size(); ++i) {
+                result = vec_hash.at(i)->result();
+                vec_hash_val.push_back(result.toHex());
+            }
+
             for (size_t i = 0; i < vec_hash_val.size(); ++i) {
-                info.checksum = vec_hash_val.at(i);
-                info.hash_type = GekkoFyre::HashType::CannotDetermine;
-                if (!given_hash_val.isEmpty()) {
-                    if (vec_hash_val.at(i) == given_hash_val) {
-                        info.hash_verif = GekkoFyre::HashVerif::Verified;
-                        return info;
-                    }
+                if (vec_hash_val.at(i) == given_hash) {
+                    info.checksum = vec_hash_val.at(i);
+                    info.hash_type = vec_hash_type.at(i);
+                    info.hash_verif = GekkoFyre::HashVerif::Verified;
+                    return info;
                 }
             }
 
@@ -1094,7 +1417,7 @@ GekkoFyre::GkTorrent::TorrentInfo GekkoFyre::CmnRoutines::torrentFileInfo(const
 
 /**
  * @brief GekkoFyre::CmnRoutines::readCurlItems extracts the history information from a Google LevelDB database relating
- * to all the saved HTTP(S)/FTP(S) downloads and parses any CSV herein, outputting a STL container ready for use.
+ * to all the saved HTTP(S)/FTP(S) downloads and decodes the record kept for each, outputting a STL container ready for use.
  * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
  * @date   2016-10
  * @param hashesOnly excludes all the 'extended' information by not loading it into memory.
@@ -1104,56 +1427,18 @@ std::vector<GekkoFyre::GkCurl::CurlDlInfo> GekkoFyre::CmnRoutines::readCurlItems
 {
     try {
         // TODO: Implement 'hashesOnly' as originally designed!
-        auto download_ids = extract_download_ids(db, false);
-        if (!download_ids.empty()) {
-            std::unique_lock<std::mutex> locker(r_curl_mtx, std::defer_lock);
-            if (locker.try_lock()) {
-                std::vector<GekkoFyre::GkCurl::CurlDlInfo> output;
-                for (auto const &id: download_ids) {
-                    if (!id.second.second && !id.second.first.empty()) { // Therefore it's a libcurl item!
-                        GekkoFyre::GkCurl::CurlDlInfo dl_info;
-                        std::string curl_stat, insert_date, complt_date, stat_msg, effec_url, resp_code, cont_lgnth, hash_type,
-                                hash_val_given, hash_val_rtrnd, hash_succ_type, down_dest;
-
-                        down_dest = id.second.first;
-                        curl_stat = read_item_db(id.first, LEVELDB_KEY_CURL_STAT, db);
-                        insert_date = read_item_db(id.first, LEVELDB_KEY_CURL_INSERT_DATE, db);
-                        complt_date = read_item_db(id.first, LEVELDB_KEY_CURL_COMPLT_DATE, db);
-                        stat_msg = read_item_db(id.first, LEVELDB_KEY_CURL_STATMSG, db);
-                        effec_url = read_item_db(id.first, LEVELDB_KEY_CURL_EFFEC_URL, db);
-                        resp_code = read_item_db(id.first, LEVELDB_KEY_CURL_RESP_CODE, db);
-                        cont_lgnth = read_item_db(id.first, LEVELDB_KEY_CURL_CONT_LNGTH, db);
-                        hash_type = read_item_db(id.first, LEVELDB_KEY_CURL_HASH_TYPE, db);
-                        hash_val_given = read_item_db(id.first, LEVELDB_KEY_CURL_HASH_VAL_GIVEN, db);
-                        hash_val_rtrnd = read_item_db(id.first, LEVELDB_KEY_CURL_HASH_VAL_RTRND, db);
-                        hash_succ_type = read_item_db(id.first, LEVELDB_KEY_CURL_HASH_SUCC_TYPE, db);
-
-                        dl_info.file_loc = id.second.first;
-                        dl_info.unique_id = id.first;
-                        dl_info.dlStatus = convDlStat_IntToEnum(std::atoi(curl_stat.c_str()));
-                        dl_info.insert_timestamp = std::atoll(insert_date.c_str());
-                        dl_info.complt_timestamp = std::atoll(complt_date.c_str());
-                        long long ret_code = std::atoll(resp_code.c_str());
-                        if (ret_code >= 200 && ret_code < 300) {
-                            dl_info.ext_info.status_ok = true;
-                        }
-
-                        dl_info.ext_info.elapsed = -1;
-                        dl_info.ext_info.status_msg = stat_msg;
-                        dl_info.ext_info.effective_url = effec_url;
-                        dl_info.ext_info.response_code = ret_code;
-                        dl_info.ext_info.content_length = std::stod(cont_lgnth);
-                        dl_info.hash_type = convHashType_IntToEnum(std::atoi(hash_type.c_str()));
-                        dl_info.hash_val_given = hash_val_given;
-                        dl_info.hash_val_rtrnd = hash_val_rtrnd;
-                        dl_info.hash_succ_type = convHashVerif_IntToEnum(std::atoi(hash_succ_type.c_str()));
-
-                        output.push_back(dl_info);
-                    }
-                }
+        std::unique_lock<std::mutex> locker(r_curl_mtx, std::defer_lock);
+        if (locker.try_lock()) {
+            std::lock_guard<std::mutex> cache_locker(record_cache_mtx);
+            load_record_cache(db);
 
-                return output;
+            std::vector<GekkoFyre::GkCurl::CurlDlInfo> output;
+            output.reserve(curl_cache.size());
+            for (const auto &item: curl_cache) {
+                output.push_back(item.second);
             }
+
+            return output;
         }
     } catch (const std::exception &e) {
         QMessageBox::warning(nullptr, tr("Error!"), e.what(), QMessageBox::Ok);
@@ -1165,7 +1450,7 @@ std::vector<GekkoFyre::GkCurl::CurlDlInfo> GekkoFyre::CmnRoutines::readCurlItems
 
 /**
  * @brief GekkoFyre::CmnRoutines::addCurlItem writes libcurl related information to a Google LevelDB database on the local
- * disk of the user's system, within the home directory. The information is stored in an XML format.
+ * disk of the user's system, within the home directory. The information is stored as a single binary record.
  * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
  * @date   2017-07-18
  * @param dl_info The download information to add to the database.
@@ -1185,19 +1470,9 @@ bool GekkoFyre::CmnRoutines::addCurlItem(GekkoFyre::GkCurl::CurlDlInfo &dl_info)
                     dl_info.complt_timestamp = 0;
                     dl_info.ext_info.status_msg = "";
 
-                    std::string unique_id = dl_info.unique_id;
-                    std::string download_key = add_download_id(dl_info.file_loc, db, false, dl_info.unique_id);
-                    add_item_db(download_key, LEVELDB_KEY_CURL_STAT, std::to_string(convDlStat_toInt(dl_info.dlStatus)), db);
-                    add_item_db(download_key, LEVELDB_KEY_CURL_INSERT_DATE, std::to_string(dl_info.insert_timestamp), db);
-                    add_item_db(download_key, LEVELDB_KEY_CURL_COMPLT_DATE, std::to_string(dl_info.complt_timestamp), db);
-                    add_item_db(download_key, LEVELDB_KEY_CURL_STATMSG, dl_info.ext_info.status_msg, db);
-                    add_item_db(download_key, LEVELDB_KEY_CURL_EFFEC_URL, dl_info.ext_info.effective_url, db);
-                    add_item_db(download_key, LEVELDB_KEY_CURL_RESP_CODE, std::to_string(dl_info.ext_info.response_code), db);
-                    add_item_db(download_key, LEVELDB_KEY_CURL_CONT_LNGTH, std::to_string(dl_info.ext_info.content_length), db);
-                    add_item_db(download_key, LEVELDB_KEY_CURL_HASH_TYPE, std::to_string(dl_info.hash_type), db);
-                    add_item_db(download_key, LEVELDB_KEY_CURL_HASH_VAL_GIVEN, dl_info.hash_val_given, db);
-                    add_item_db(download_key, LEVELDB_KEY_CURL_HASH_VAL_RTRND, dl_info.hash_val_rtrnd, db);
-                    add_item_db(download_key, LEVELDB_KEY_CURL_HASH_SUCC_TYPE, std::to_string(dl_info.hash_succ_type), db);
+                    dl_info.unique_id = add_download_id(dl_info.file_loc, db, false, dl_info.unique_id,
+                                                        LEVELDB_KEY_CURL_RECORD, encode_curl_record(dl_info));
+                    cache_curl_record(dl_info);
                     return true;
                 }
             } catch (const std::exception &e) {
@@ -1211,52 +1486,115 @@ bool GekkoFyre::CmnRoutines::addCurlItem(GekkoFyre::GkCurl::CurlDlInfo &dl_info)
 }
 
 /**
- * @brief GekkoFyre::CmnRoutines::delCurlItem deletes the given downloadable item from the Google LevelDB database.
+ * @brief GekkoFyre::CmnRoutines::addCurlItems writes a whole batch of HTTP(S)/FTP(S) downloads to the Google LevelDB
+ * database at once, as is done when importing a large list of URLs. Every record within the batch is committed under the
+ * one write, and thus the one disk sync, rather than one apiece as addCurlItem() would need.
  * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
- * @date 2017-07-21
- * @param file_dest The location of the downloadable item on the user's local storage, along with the folder name of the
- * download. This is used to deduce the Unique ID of the download in question to modify.
- * @param unique_id_backup If the 'file_dest' param happens to be empty but the unique identifier provided instead (i.e. in the
- * event of database corruption), then this may be used as a last resort to delete an item from the database.
- * @return Whether the series of operations to delete the database object proceeded okay or not.
+ * @date 2017-08-24
+ * @param dl_info The downloads to add to the database. As with addCurlItem(), only those that were found to exist upon
+ * the web-server are written.
+ * @return Whether the write operations were successful or not.
  */
-bool GekkoFyre::CmnRoutines::delCurlItem(const QString &file_dest, const std::string &unique_id_backup)
+bool GekkoFyre::CmnRoutines::addCurlItems(const std::vector<GekkoFyre::GkCurl::CurlDlInfo> &dl_info)
 {
     try {
-        std::unique_lock<std::mutex> locker(w_curl_mtx, std::defer_lock);
-        if (locker.try_lock()) {
-            std::string download_id;
-            if (unique_id_backup.empty() && !file_dest.isEmpty()) {
-                auto identifier = determine_download_id(file_dest.toStdString(), db);
-                download_id = identifier.first;
-            } else {
-                // TODO: An empty 'unique_id_backup' can still possibly be provided, as-is dealt with by the exception below!
-                download_id = unique_id_backup;
+        // The whole batch would be lost otherwise, so this waits upon any other write rather than giving up
+        std::lock_guard<std::mutex> locker(w_curl_mtx);
+        const long long now = QDateTime::currentDateTime().toTime_t();
+
+        leveldb::WriteBatch batch;
+        std::vector<GekkoFyre::GkCurl::CurlDlInfo> added;
+        added.reserve(dl_info.size());
+        for (const auto &item: dl_info) {
+            if (!item.ext_info.status_ok || item.file_loc.empty()) {
+                continue;
             }
 
-            if (download_id.empty()) {
-                throw std::invalid_argument(tr("An invalid Unique ID has been provided. Unable to delete download item with "
-                                                       "storage path, \"%1\".").arg(file_dest).toStdString());
-            }
+            if (item.dlStatus == GekkoFyre::DownloadStatus::Stopped || item.dlStatus == GekkoFyre::DownloadStatus::Invalid ||
+                item.dlStatus == GekkoFyre::DownloadStatus::Unknown) {
+                GekkoFyre::GkCurl::CurlDlInfo record = item;
+                record.dlStatus = GekkoFyre::DownloadStatus::Unknown;
+                record.insert_timestamp = now;
+                record.complt_timestamp = 0;
+                record.ext_info.status_msg = "";
+                if (record.unique_id.empty()) {
+                    record.unique_id = createId(FYREDL_UNIQUE_ID_DIGIT_COUNT);
+                }
 
-            del_item_db(download_id, LEVELDB_KEY_CURL_STAT, db);
-            del_item_db(download_id, LEVELDB_KEY_CURL_INSERT_DATE, db);
-            del_item_db(download_id, LEVELDB_KEY_CURL_COMPLT_DATE, db);
-            del_item_db(download_id, LEVELDB_KEY_CURL_STATMSG, db);
-            del_item_db(download_id, LEVELDB_KEY_CURL_EFFEC_URL, db);
-            del_item_db(download_id, LEVELDB_KEY_CURL_RESP_CODE, db);
-            del_item_db(download_id, LEVELDB_KEY_CURL_CONT_LNGTH, db);
-            del_item_db(download_id, LEVELDB_KEY_CURL_HASH_TYPE, db);
-            del_item_db(download_id, LEVELDB_KEY_CURL_HASH_VAL_GIVEN, db);
-            del_item_db(download_id, LEVELDB_KEY_CURL_HASH_VAL_RTRND, db);
-            del_item_db(download_id, LEVELDB_KEY_CURL_HASH_SUCC_TYPE, db);
-            bool ret = del_download_id(download_id, db, false);
-            return ret;
+                put_download_id(batch, record.unique_id, record.file_loc, false, LEVELDB_KEY_CURL_RECORD,
+                                encode_curl_record(record));
+                added.push_back(std::move(record));
+            }
         }
-    } catch (const std::exception &e) {
-        QMessageBox::warning(nullptr, tr("Error!"), e.what(), QMessageBox::Ok);
-        return false;
-    }
+
+        if (added.empty()) {
+            return false;
+        }
+
+        leveldb::Status s;
+        s = commit_batch(batch, db);
+        if (!s.ok()) {
+            throw std::runtime_error(s.ToString());
+        }
+
+        {
+            std::lock_guard<std::mutex> index_locker(path_index_mtx);
+            for (const auto &record: added) {
+                path_index[record.file_loc] = std::make_pair(record.unique_id, false);
+            }
+        }
+
+        for (const auto &record: added) {
+            cache_curl_record(record);
+        }
+
+        return true;
+    } catch (const std::exception &e) {
+        QMessageBox::warning(nullptr, tr("Error!"), e.what(), QMessageBox::Ok);
+        return false;
+    }
+}
+
+/**
+ * @brief GekkoFyre::CmnRoutines::delCurlItem deletes the given downloadable item from the Google LevelDB database.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-07-21
+ * @param file_dest The location of the downloadable item on the user's local storage, along with the folder name of the
+ * download. This is used to deduce the Unique ID of the download in question to modify.
+ * @param unique_id_backup If the 'file_dest' param happens to be empty but the unique identifier provided instead (i.e. in the
+ * event of database corruption), then this may be used as a last resort to delete an item from the database.
+ * @return Whether the series of operations to delete the database object proceeded okay or not.
+ */
+bool GekkoFyre::CmnRoutines::delCurlItem(const QString &file_dest, const std::string &unique_id_backup)
+{
+    try {
+        std::unique_lock<std::mutex> locker(w_curl_mtx, std::defer_lock);
+        if (locker.try_lock()) {
+            std::string download_id;
+            if (unique_id_backup.empty() && !file_dest.isEmpty()) {
+                auto identifier = determine_download_id(file_dest.toStdString(), db);
+                download_id = identifier.first;
+            } else {
+                // TODO: An empty 'unique_id_backup' can still possibly be provided, as-is dealt with by the exception below!
+                download_id = unique_id_backup;
+            }
+
+            if (download_id.empty()) {
+                throw std::invalid_argument(tr("An invalid Unique ID has been provided. Unable to delete download item with "
+                                                       "storage path, \"%1\".").arg(file_dest).toStdString());
+            }
+
+            bool ret = del_download_id(download_id, db, false, LEVELDB_KEY_CURL_RECORD);
+            if (ret) {
+                uncache_record(download_id);
+            }
+
+            return ret;
+        }
+    } catch (const std::exception &e) {
+        QMessageBox::warning(nullptr, tr("Error!"), e.what(), QMessageBox::Ok);
+        return false;
+    }
 
     return false;
 }
@@ -1288,23 +1626,29 @@ bool GekkoFyre::CmnRoutines::modifyCurlItem(const std::string &file_loc, const G
             std::unique_lock<std::mutex> locker(w_curl_mtx, std::defer_lock);
             if (locker.try_lock()) {
                 std::string dl_id = identifier.first;
+                GekkoFyre::GkCurl::CurlDlInfo dl_info;
+                if (!findCurlItem(dl_id, dl_info)) {
+                    dl_info = read_curl_record(dl_id, file_loc);
+                }
 
                 //
                 // General
-                add_item_db(dl_id, LEVELDB_KEY_CURL_STAT, std::to_string(convDlStat_toInt(status)), db);
+                dl_info.dlStatus = status;
                 if (complt_timestamp > 0) {
-                    add_item_db(dl_id, LEVELDB_KEY_CURL_COMPLT_DATE, std::to_string(complt_timestamp), db);
+                    dl_info.complt_timestamp = complt_timestamp;
                 }
 
                 //
                 // Hash Values
                 if (ret_succ_type != GekkoFyre::HashVerif::NotApplicable) {
-                    add_item_db(dl_id, LEVELDB_KEY_CURL_HASH_TYPE, std::to_string(convHashType_toInt(hash_type)), db);
-                    add_item_db(dl_id, LEVELDB_KEY_CURL_HASH_VAL_GIVEN, hash_given, db);
-                    add_item_db(dl_id, LEVELDB_KEY_CURL_HASH_VAL_RTRND, hash_rtrnd, db);
-                    add_item_db(dl_id, LEVELDB_KEY_CURL_HASH_SUCC_TYPE, std::to_string(convHashVerif_toInt(ret_succ_type)), db);
+                    dl_info.hash_type = hash_type;
+                    dl_info.hash_val_given = hash_given;
+                    dl_info.hash_val_rtrnd = hash_rtrnd;
+                    dl_info.hash_succ_type = ret_succ_type;
                 }
 
+                add_item_db(dl_id, LEVELDB_KEY_CURL_RECORD, encode_curl_record(dl_info), db);
+                cache_curl_record(dl_info);
                 return true;
             }
         } else {
@@ -1319,6 +1663,44 @@ bool GekkoFyre::CmnRoutines::modifyCurlItem(const std::string &file_loc, const G
     return false;
 }
 
+/**
+ * @brief GekkoFyre::CmnRoutines::modifyCurlSegments keeps how far along each segment of a HTTP(S)/FTP(S) download is
+ * within its record, so that the download may be picked up from where it left off even after FyreDL has been restarted.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-09-02
+ * @param file_loc The location of the download on the user's local storage.
+ * @param segments The byte-ranges of the download and how much of each has been written, or empty should it have none.
+ * @return Whether the series of operations to modify the database object(s) proceeded okay or not.
+ */
+bool GekkoFyre::CmnRoutines::modifyCurlSegments(const std::string &file_loc,
+                                                const std::vector<GekkoFyre::GkCurl::SegmentRange> &segments)
+{
+    try {
+        auto identifier = determine_download_id(file_loc, db);
+        if (identifier.first.empty()) {
+            throw std::invalid_argument(tr("An invalid Unique ID has been provided. Unable to modify download item with "
+                                                   "storage path, \"%1\".").arg(QString::fromStdString(file_loc)).toStdString());
+        }
+
+        // Were this to be skipped, then segments that no longer match the file could be left behind within the record,
+        // so this waits upon any other write rather than giving up
+        std::lock_guard<std::mutex> locker(w_curl_mtx);
+        std::string dl_id = identifier.first;
+        GekkoFyre::GkCurl::CurlDlInfo dl_info;
+        if (!findCurlItem(dl_id, dl_info)) {
+            dl_info = read_curl_record(dl_id, file_loc);
+        }
+
+        dl_info.segments = segments;
+        add_item_db(dl_id, LEVELDB_KEY_CURL_RECORD, encode_curl_record(dl_info), db);
+        cache_curl_record(dl_info);
+        return true;
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return false;
+    }
+}
+
 bool GekkoFyre::CmnRoutines::modifyTorrentItem(const std::string &unique_id, const GekkoFyre::DownloadStatus &dl_status)
 {
     try {
@@ -1336,7 +1718,8 @@ bool GekkoFyre::CmnRoutines::modifyTorrentItem(const std::string &unique_id, con
 
 /**
  * @brief GekkoFyre::CmnRoutines::addTorrentItem writes BitTorrent related information to a Google LevelDB database that is kept on
- * the user's local storage within the home directory. This information is stored in a readibly parsable XML format.
+ * the user's local storage within the home directory. This information is stored as a single binary record, inclusive
+ * of the torrent's files and trackers.
  * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
  * @date 2017-07
  * @param gk_ti The BitTorrent related information to write to the database.
@@ -1351,43 +1734,17 @@ bool GekkoFyre::CmnRoutines::addTorrentItem(GekkoFyre::GkTorrent::TorrentInfo &g
                 QDateTime now = QDateTime::currentDateTime();
                 gk_ti.general.insert_timestamp = now.toTime_t();
 
-                std::string download_key = add_download_id(gk_ti.general.down_dest, db, true, gk_ti.general.unique_id);
-                if (gk_ti.general.unique_id != download_key) {
-                    throw std::invalid_argument(tr("Unique ID mismatch while adding a BitTorrent item!\n\n%1 != %2")
-                                                        .arg(QString::fromStdString(gk_ti.general.unique_id))
-                                                        .arg(QString::fromStdString(download_key)).toStdString());
-                }
-
-                add_item_db(download_key, LEVELDB_KEY_TORRENT_INSERT_DATE, std::to_string(gk_ti.general.insert_timestamp), db);
-                add_item_db(download_key, LEVELDB_KEY_TORRENT_COMPLT_DATE, std::to_string(gk_ti.general.complt_timestamp), db);
-                add_item_db(download_key, LEVELDB_KEY_TORRENT_CREATN_DATE, std::to_string(gk_ti.general.creatn_timestamp), db);
-                add_item_db(download_key, LEVELDB_KEY_TORRENT_DLSTATUS, convDlStat_toString(gk_ti.general.dlStatus).toStdString(), db);
-                add_item_db(download_key, LEVELDB_KEY_TORRENT_TORRNT_COMMENT, gk_ti.general.comment, db);
-                add_item_db(download_key, LEVELDB_KEY_TORRENT_TORRNT_CREATOR, gk_ti.general.creator, db);
-                add_item_db(download_key, LEVELDB_KEY_TORRENT_MAGNET_URI, gk_ti.general.magnet_uri, db);
-                add_item_db(download_key, LEVELDB_KEY_TORRENT_TORRNT_NAME, gk_ti.general.torrent_name, db);
-                add_item_db(download_key, LEVELDB_KEY_TORRENT_NUM_FILES, std::to_string(gk_ti.general.num_files), db);
-                add_item_db(download_key, LEVELDB_KEY_TORRENT_NUM_TRACKERS, std::to_string(gk_ti.general.num_trackers), db);
-                add_item_db(download_key, LEVELDB_KEY_TORRENT_TORRNT_PIECES, std::to_string(gk_ti.general.num_pieces), db);
-                add_item_db(download_key, LEVELDB_KEY_TORRENT_TORRNT_PIECE_LENGTH, std::to_string(gk_ti.general.piece_length), db);
-
-                //
-                // Files
-                //
-                bool wtf_ret = write_torrent_files_addendum(gk_ti.files_vec, download_key, db);
-
-                //
-                // Trackers
-                //
-                bool wtt_ret = write_torrent_trkrs_addendum(gk_ti.trackers, download_key, db);
-
-                if (!wtf_ret || !wtt_ret) {
-                    QMessageBox::warning(nullptr, tr("Error!"), tr("There was an error with inserting the following BitTorrent "
-                                                                           "item into the database: \"%1\".")
-                            .arg(QString::fromStdString(gk_ti.general.torrent_name)), QMessageBox::Ok);
-                    return false;
+                if (gk_ti.general.unique_id.empty()) {
+                    throw std::invalid_argument(tr("No Unique ID has been given while adding BitTorrent item, \"%1\"!")
+                                                        .arg(QString::fromStdString(gk_ti.general.torrent_name)).toStdString());
                 }
 
+                // The torrent's files and trackers are all within its record, so the whole torrent is committed
+                // under the one batch no matter how many files it holds
+                add_download_id(gk_ti.general.down_dest, db, true, gk_ti.general.unique_id, LEVELDB_KEY_TORRENT_RECORD,
+                                encode_torrent_record(gk_ti));
+                assign_torrent_id(gk_ti, gk_ti.general.unique_id, gk_ti.general.down_dest);
+                cache_torrent_record(gk_ti);
                 return true;
             }
         }
@@ -1401,7 +1758,7 @@ bool GekkoFyre::CmnRoutines::addTorrentItem(GekkoFyre::GkTorrent::TorrentInfo &g
 
 /**
  * @brief GekkoFyre::CmnRoutines::readTorrentItems extracts all of the users stored history relating to BitTorrent downloads
- * from a Google LevelDB database and parses any CSV therein, outputting a STL container that's ready for use.
+ * from a Google LevelDB database and decodes the record kept for each, outputting a STL container that's ready for use.
  * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
  * @date 2017-07
  * @param minimal_readout only extracts the most vital history information, thus (potentially) saving CPU time and
@@ -1413,81 +1770,364 @@ std::vector<GekkoFyre::GkTorrent::TorrentInfo> GekkoFyre::CmnRoutines::readTorre
     try {
         std::unique_lock<std::mutex> locker(r_torrent_mtx, std::defer_lock);
         if (locker.try_lock()) {
-            auto download_ids = extract_download_ids(db, true);
-            if (!download_ids.empty()) {
-                std::vector<GekkoFyre::GkTorrent::TorrentInfo> output;
-                for (auto const &id: download_ids) {
-                    if (id.second.second && !id.second.first.empty()) { // Therefore it's a BitTorrent item!
-                        GekkoFyre::GkTorrent::TorrentInfo to_info;
-                        GekkoFyre::GkTorrent::GeneralInfo gen_info;
-                        std::string insert_date, complt_date, creatn_date, dlstatus, comment, creator, magnet_uri, torrent_name,
-                                num_files, num_trackers, num_pieces, piece_length;
-
-                        insert_date = read_item_db(id.first, LEVELDB_KEY_TORRENT_INSERT_DATE, db);
-                        complt_date = read_item_db(id.first, LEVELDB_KEY_TORRENT_COMPLT_DATE, db);
-                        creatn_date = read_item_db(id.first, LEVELDB_KEY_TORRENT_CREATN_DATE, db);
-                        dlstatus = read_item_db(id.first, LEVELDB_KEY_TORRENT_DLSTATUS, db);
-                        comment = read_item_db(id.first, LEVELDB_KEY_TORRENT_TORRNT_COMMENT, db);
-                        creator = read_item_db(id.first, LEVELDB_KEY_TORRENT_TORRNT_CREATOR, db);
-                        magnet_uri = read_item_db(id.first, LEVELDB_KEY_TORRENT_MAGNET_URI, db);
-                        torrent_name = read_item_db(id.first, LEVELDB_KEY_TORRENT_TORRNT_NAME, db);
-                        num_files = read_item_db(id.first, LEVELDB_KEY_TORRENT_NUM_FILES, db);
-                        num_trackers = read_item_db(id.first, LEVELDB_KEY_TORRENT_NUM_TRACKERS, db);
-                        num_pieces = read_item_db(id.first, LEVELDB_KEY_TORRENT_TORRNT_PIECES, db);
-                        piece_length = read_item_db(id.first, LEVELDB_KEY_TORRENT_TORRNT_PIECE_LENGTH, db);
-
-                        gen_info.unique_id = id.first;
-                        gen_info.down_dest = id.second.first;
-                        gen_info.insert_timestamp = std::atoll(insert_date.c_str());
-                        gen_info.complt_timestamp = std::atoll(complt_date.c_str());
-                        gen_info.creatn_timestamp = std::atol(creatn_date.c_str());
-                        gen_info.dlStatus = convDlStat_IntToEnum(std::atoi(dlstatus.c_str()));
-                        gen_info.comment = comment;
-                        gen_info.creator = creator;
-                        gen_info.magnet_uri = magnet_uri;
-                        gen_info.torrent_name = torrent_name;
-                        gen_info.num_files = std::atoi(num_files.c_str());
-                        gen_info.num_trackers = std::atoi(num_trackers.c_str());
-                        gen_info.num_pieces = std::atoi(num_pieces.c_str());
-                        gen_info.piece_length = std::atoi(piece_length.c_str());
-
-                        if (!minimal_readout) {
-                            //
-                            // Files
-                            auto files_info_vec = read_torrent_files_addendum(gen_info.num_files, id.first, db);
-                            if (!files_info_vec.empty()) {
-                                to_info.files_vec = files_info_vec;
-                            } else {
-                                throw std::invalid_argument(tr("Unable to interpret the internal file-layout for BitTorrent item, \"%1\".")
-                                                                    .arg(QString::fromStdString(gen_info.torrent_name)).toStdString());
-                            }
-                        }
+            std::lock_guard<std::mutex> cache_locker(record_cache_mtx);
+            load_record_cache(db);
 
-                        //
-                        // Trackers
-                        auto trackers_info_vec = read_torrent_trkrs_addendum(gen_info.num_trackers, id.first, db);
+            std::vector<GekkoFyre::GkTorrent::TorrentInfo> output;
+            output.reserve(torrent_cache.size());
+            for (const auto &item: torrent_cache) {
+                output.push_back(copy_torrent_record(item.second, minimal_readout));
+            }
 
-                        to_info.general = gen_info;
-                        if (!trackers_info_vec.empty()) {
-                            to_info.trackers = trackers_info_vec;
-                        } else {
-                            throw std::invalid_argument(tr("Unable to determine the trackers for BitTorrent item, \"%1\".")
-                                                                .arg(QString::fromStdString(gen_info.torrent_name)).toStdString());
-                        }
+            return output;
+        }
+    } catch (const std::exception &e) {
+        QMessageBox::warning(nullptr, tr("Error!"), e.what(), QMessageBox::Ok);
+        return std::vector<GekkoFyre::GkTorrent::TorrentInfo>();
+    }
 
-                        output.push_back(to_info);
-                    }
+    return std::vector<GekkoFyre::GkTorrent::TorrentInfo>();
+}
+
+/**
+ * @brief GekkoFyre::CmnRoutines::readHistory reads back the history of both the HTTP(S)/FTP(S) and BitTorrent downloads
+ * in the one pass over the database, as is needed upon start-up.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-21
+ * @param curl_items Where the HTTP(S)/FTP(S) downloads are to be output to.
+ * @param torrent_items Where the BitTorrent downloads are to be output to.
+ * @param minimal_readout Whether to leave out the internal files of each torrent.
+ * @return Whether the history could be read or not.
+ */
+bool GekkoFyre::CmnRoutines::readHistory(std::vector<GekkoFyre::GkCurl::CurlDlInfo> &curl_items,
+                                         std::vector<GekkoFyre::GkTorrent::TorrentInfo> &torrent_items,
+                                         const bool &minimal_readout)
+{
+    try {
+        std::unique_lock<std::mutex> curl_locker(r_curl_mtx, std::defer_lock);
+        std::unique_lock<std::mutex> torrent_locker(r_torrent_mtx, std::defer_lock);
+        if (std::try_lock(curl_locker, torrent_locker) == -1) {
+            std::lock_guard<std::mutex> cache_locker(record_cache_mtx);
+            load_record_cache(db);
+
+            curl_items.reserve(curl_items.size() + curl_cache.size());
+            for (const auto &item: curl_cache) {
+                curl_items.push_back(item.second);
+            }
+
+            torrent_items.reserve(torrent_items.size() + torrent_cache.size());
+            for (const auto &item: torrent_cache) {
+                torrent_items.push_back(copy_torrent_record(item.second, minimal_readout));
+            }
+
+            return true;
+        }
+    } catch (const std::exception &e) {
+        QMessageBox::warning(nullptr, tr("Error!"), e.what(), QMessageBox::Ok);
+        return false;
+    }
+
+    return false;
+}
+
+/**
+ * @brief GekkoFyre::CmnRoutines::load_history walks the keyspace of the Google LevelDB database the once, with a single
+ * iterator, decoding every Unique ID and record as it comes across them rather than looking each one up in turn. This is
+ * all done under a snapshot, so that the Unique IDs and the records that are read agree with one another even if other
+ * writes are under way.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-21
+ * @param curl_items Where the HTTP(S)/FTP(S) downloads are to be output to, if anywhere.
+ * @param torrent_items Where the BitTorrent downloads are to be output to, if anywhere.
+ * @param minimal_readout Whether to leave out the internal files of each torrent.
+ * @param db_struct The database object used for connecting to the Google LevelDB database.
+ */
+void GekkoFyre::CmnRoutines::load_history(std::vector<GekkoFyre::GkCurl::CurlDlInfo> *curl_items,
+                                          std::vector<GekkoFyre::GkTorrent::TorrentInfo> *torrent_items,
+                                          const bool &minimal_readout, const GekkoFyre::GkFile::FileDb &db_struct)
+{
+    const leveldb::Slice id_prefix(LEVELDB_PREFIX_UNIQUE_ID);
+    const leveldb::Slice path_prefix(LEVELDB_PREFIX_FILE_PATH);
+    const std::string curl_suffix = std::string("_") + LEVELDB_KEY_CURL_RECORD;
+    const std::string torrent_suffix = std::string("_") + LEVELDB_KEY_TORRENT_RECORD;
+    auto has_suffix = [](const leveldb::Slice &key, const std::string &suffix) {
+        return (key.size() > suffix.size() &&
+                std::memcmp(key.data() + (key.size() - suffix.size()), suffix.data(), suffix.size()) == 0);
+    };
+
+    std::vector<std::pair<std::string, std::pair<std::string, bool>>> download_ids;
+    std::unordered_map<std::string, GekkoFyre::GkCurl::CurlDlInfo> curl_records;
+    std::unordered_map<std::string, GekkoFyre::GkTorrent::TorrentInfo> torrent_records;
+    std::unordered_set<std::string> bad_records; // Unique IDs whose records could not be read, and are left out
+
+    {
+        std::lock_guard<std::mutex> locker(db_mutex);
+        std::unique_ptr<const leveldb::Snapshot, std::function<void(const leveldb::Snapshot *)>> snapshot(
+                db_struct.db->GetSnapshot(), [&db_struct](const leveldb::Snapshot *snap) { db_struct.db->ReleaseSnapshot(snap); });
+
+        leveldb::ReadOptions read_opt;
+        read_opt.verify_checksums = true;
+        read_opt.fill_cache = false; // A one-off scan such as this would only push everything else out of the block cache
+        read_opt.snapshot = snapshot.get();
+
+        std::unique_ptr<leveldb::Iterator> it(db_struct.db->NewIterator(read_opt));
+        for (it->SeekToFirst(); it->Valid(); it->Next()) {
+            const leveldb::Slice key = it->key();
+            if (key.starts_with(path_prefix)) {
+                // The reverse index is keyed by the download's path, which may well end in anything at all
+                continue;
+            }
+
+            if (key.starts_with(id_prefix)) {
+                auto item = decode_download_id(it->value().ToString(), LEVELDB_RECORD_TYPE_UNIQUE_ID);
+                download_ids.push_back(std::make_pair(std::string(key.data() + id_prefix.size(), key.size() - id_prefix.size()), item));
+            } else if (curl_items != nullptr && has_suffix(key, curl_suffix)) {
+                const std::string unique_id(key.data(), key.size() - curl_suffix.size());
+                try {
+                    curl_records.emplace(unique_id, decode_curl_record(it->value().ToString()));
+                } catch (const std::exception &e) {
+                    // A single record that cannot be read is no reason to lose the rest of the history along with it
+                    std::cerr << tr("Skipping download \"%1\": %2").arg(QString::fromStdString(unique_id))
+                            .arg(e.what()).toStdString() << std::endl;
+                    bad_records.insert(unique_id);
                 }
+            } else if (torrent_items != nullptr && has_suffix(key, torrent_suffix)) {
+                const std::string unique_id(key.data(), key.size() - torrent_suffix.size());
+                try {
+                    torrent_records.emplace(unique_id, decode_torrent_record(it->value().ToString(), minimal_readout));
+                } catch (const std::exception &e) {
+                    std::cerr << tr("Skipping download \"%1\": %2").arg(QString::fromStdString(unique_id))
+                            .arg(e.what()).toStdString() << std::endl;
+                    bad_records.insert(unique_id);
+                }
+            }
+        }
 
-                return output;
+        if (!it->status().ok()) {
+            throw std::runtime_error(it->status().ToString());
+        }
+    }
+
+    for (const auto &id: download_ids) {
+        if (id.second.first.empty() || bad_records.find(id.first) != bad_records.end()) {
+            continue;
+        }
+
+        if (!id.second.second && curl_items != nullptr) { // Therefore it's a libcurl item!
+            auto record = curl_records.find(id.first);
+            if (record != curl_records.end()) {
+                record->second.file_loc = id.second.first;
+                record->second.unique_id = id.first;
+                curl_items->push_back(std::move(record->second));
+            } else {
+                // Still stored in the older layout, which is converted over as it's read
+                curl_items->push_back(read_curl_record(id.first, id.second.first));
+            }
+        } else if (id.second.second && torrent_items != nullptr) { // Therefore it's a BitTorrent item!
+            GekkoFyre::GkTorrent::TorrentInfo to_info;
+            auto record = torrent_records.find(id.first);
+            if (record != torrent_records.end()) {
+                to_info = std::move(record->second);
+                assign_torrent_id(to_info, id.first, id.second.first);
+            } else {
+                to_info = read_torrent_record(id.first, id.second.first, minimal_readout);
             }
+
+            if (!minimal_readout && to_info.files_vec.empty()) {
+                std::cerr << tr("Unable to interpret the internal file-layout for BitTorrent item, \"%1\".")
+                        .arg(QString::fromStdString(to_info.general.torrent_name)).toStdString() << std::endl;
+                continue;
+            }
+
+            if (to_info.trackers.empty()) {
+                std::cerr << tr("Unable to determine the trackers for BitTorrent item, \"%1\".")
+                        .arg(QString::fromStdString(to_info.general.torrent_name)).toStdString() << std::endl;
+                continue;
+            }
+
+            torrent_items->push_back(std::move(to_info));
+        }
+    }
+
+    return;
+}
+
+/**
+ * @brief GekkoFyre::CmnRoutines::findCurlItem looks up a HTTP(S)/FTP(S) download by its Unique ID, as held within the
+ * in-memory table of records rather than going back to the database.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-22
+ * @param unique_id The Unique ID of the download in question.
+ * @param dl_info Where the download's information is to be output to.
+ * @return Whether the download could be found or not.
+ */
+bool GekkoFyre::CmnRoutines::findCurlItem(const std::string &unique_id, GekkoFyre::GkCurl::CurlDlInfo &dl_info)
+{
+    try {
+        std::lock_guard<std::mutex> locker(record_cache_mtx);
+        load_record_cache(db);
+        auto it = curl_cache.find(unique_id);
+        if (it != curl_cache.end()) {
+            dl_info = it->second;
+            return true;
         }
     } catch (const std::exception &e) {
         QMessageBox::warning(nullptr, tr("Error!"), e.what(), QMessageBox::Ok);
-        return std::vector<GekkoFyre::GkTorrent::TorrentInfo>();
+        return false;
     }
 
-    return std::vector<GekkoFyre::GkTorrent::TorrentInfo>();
+    return false;
+}
+
+/**
+ * @brief GekkoFyre::CmnRoutines::findCurlItemByPath looks up a HTTP(S)/FTP(S) download by where it is stored upon the
+ * user's local storage, as held within the in-memory table of records.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-22
+ * @param file_loc The location of the download on the user's local storage.
+ * @param dl_info Where the download's information is to be output to.
+ * @return Whether the download could be found or not.
+ */
+bool GekkoFyre::CmnRoutines::findCurlItemByPath(const std::string &file_loc, GekkoFyre::GkCurl::CurlDlInfo &dl_info)
+{
+    auto identifier = determine_download_id(file_loc, db);
+    if (identifier.first.empty() || identifier.second) {
+        return false;
+    }
+
+    return findCurlItem(identifier.first, dl_info);
+}
+
+/**
+ * @brief GekkoFyre::CmnRoutines::findTorrentItem looks up a BitTorrent download by its Unique ID, as held within the
+ * in-memory table of records rather than going back to the database.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-22
+ * @param unique_id The Unique ID of the download in question.
+ * @param gk_ti Where the download's information is to be output to.
+ * @param minimal_readout Whether to leave out the internal files of the torrent.
+ * @return Whether the download could be found or not.
+ */
+bool GekkoFyre::CmnRoutines::findTorrentItem(const std::string &unique_id, GekkoFyre::GkTorrent::TorrentInfo &gk_ti,
+                                             const bool &minimal_readout)
+{
+    try {
+        std::lock_guard<std::mutex> locker(record_cache_mtx);
+        load_record_cache(db);
+        auto it = torrent_cache.find(unique_id);
+        if (it != torrent_cache.end()) {
+            gk_ti = copy_torrent_record(it->second, minimal_readout);
+            return true;
+        }
+    } catch (const std::exception &e) {
+        QMessageBox::warning(nullptr, tr("Error!"), e.what(), QMessageBox::Ok);
+        return false;
+    }
+
+    return false;
+}
+
+/**
+ * @brief GekkoFyre::CmnRoutines::load_record_cache fills the in-memory table of records from the database, the once,
+ * upon first being needed. From then onwards it's kept up to date by every write that goes through this class, so there
+ * is no need to ever read the whole database back in again.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-22
+ * @note 'record_cache_mtx' must already be held by the caller.
+ * @param db_struct The database object used for connecting to the Google LevelDB database.
+ */
+void GekkoFyre::CmnRoutines::load_record_cache(const GekkoFyre::GkFile::FileDb &db_struct)
+{
+    if (record_cache_loaded) {
+        return;
+    }
+
+    std::vector<GekkoFyre::GkCurl::CurlDlInfo> curl_items;
+    std::vector<GekkoFyre::GkTorrent::TorrentInfo> torrent_items;
+    load_history(&curl_items, &torrent_items, false, db_struct);
+
+    curl_cache.clear();
+    torrent_cache.clear();
+    for (auto &item: curl_items) {
+        const std::string unique_id = item.unique_id;
+        curl_cache[unique_id] = std::move(item);
+    }
+
+    for (auto &item: torrent_items) {
+        const std::string unique_id = item.general.unique_id;
+        torrent_cache[unique_id] = std::move(item);
+    }
+
+    record_cache_loaded = true;
+    return;
+}
+
+/**
+ * @brief GekkoFyre::CmnRoutines::copy_torrent_record makes a copy of a torrent's record as held in memory, leaving out
+ * the (potentially very many) internal files of the torrent if they're not needed.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-22
+ */
+GekkoFyre::GkTorrent::TorrentInfo GekkoFyre::CmnRoutines::copy_torrent_record(const GekkoFyre::GkTorrent::TorrentInfo &gk_ti,
+                                                                              const bool &minimal_readout)
+{
+    if (!minimal_readout) {
+        return gk_ti;
+    }
+
+    GekkoFyre::GkTorrent::TorrentInfo output;
+    output.general = gk_ti.general;
+    output.to_resume_info = gk_ti.to_resume_info;
+    output.nodes = gk_ti.nodes;
+    output.trackers = gk_ti.trackers;
+    return output;
+}
+
+/**
+ * @brief GekkoFyre::CmnRoutines::cache_curl_record writes through a change to a HTTP(S)/FTP(S) download's record to the
+ * in-memory table of records, once it's been committed to the database.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-22
+ */
+void GekkoFyre::CmnRoutines::cache_curl_record(const GekkoFyre::GkCurl::CurlDlInfo &dl_info)
+{
+    std::lock_guard<std::mutex> locker(record_cache_mtx);
+    if (record_cache_loaded) {
+        // Otherwise the record will be picked up from the database whenever the table is first filled
+        curl_cache[dl_info.unique_id] = dl_info;
+    }
+
+    return;
+}
+
+/**
+ * @brief GekkoFyre::CmnRoutines::cache_torrent_record writes through a change to a BitTorrent download's record to the
+ * in-memory table of records, once it's been committed to the database.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-22
+ */
+void GekkoFyre::CmnRoutines::cache_torrent_record(const GekkoFyre::GkTorrent::TorrentInfo &gk_ti)
+{
+    std::lock_guard<std::mutex> locker(record_cache_mtx);
+    if (record_cache_loaded) {
+        torrent_cache[gk_ti.general.unique_id] = gk_ti;
+    }
+
+    return;
+}
+
+/**
+ * @brief GekkoFyre::CmnRoutines::uncache_record removes a download from the in-memory table of records, once it's been
+ * deleted from the database.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-22
+ */
+void GekkoFyre::CmnRoutines::uncache_record(const std::string &unique_id)
+{
+    std::lock_guard<std::mutex> locker(record_cache_mtx);
+    curl_cache.erase(unique_id);
+    torrent_cache.erase(unique_id);
+    return;
 }
 
 bool GekkoFyre::CmnRoutines::delTorrentItem(const std::string &unique_id)
@@ -1513,6 +2153,8 @@ int GekkoFyre::CmnRoutines::convDlStat_toInt(const GekkoFyre::DownloadStatus &st
         return 5;
     case GekkoFyre::DownloadStatus::Invalid:
         return 6;
+    case GekkoFyre::DownloadStatus::Queued:
+        return 7;
     default:
         return -1;
     }
@@ -1659,6 +2301,9 @@ GekkoFyre::DownloadStatus GekkoFyre::CmnRoutines::convDlStat_IntToEnum(const int
     case 6:
         ds_enum = GekkoFyre::DownloadStatus::Invalid;
         return ds_enum;
+    case 7:
+        ds_enum = GekkoFyre::DownloadStatus::Queued;
+        return ds_enum;
     default:
         ds_enum = GekkoFyre::DownloadStatus::Unknown;
         return ds_enum;
@@ -1682,6 +2327,8 @@ QString GekkoFyre::CmnRoutines::convDlStat_toString(const GekkoFyre::DownloadSta
         return tr("Unknown");
     case GekkoFyre::DownloadStatus::Invalid:
         return tr("Invalid");
+    case GekkoFyre::DownloadStatus::Queued:
+        return tr("Queued");
     default:
         return tr("Unknown");
     }
@@ -1701,6 +2348,8 @@ GekkoFyre::DownloadStatus GekkoFyre::CmnRoutines::convDlStat_StringToEnum(const
         return GekkoFyre::DownloadStatus::Stopped;
     } else if (status == tr("Unknown")) {
         return GekkoFyre::DownloadStatus::Unknown;
+    } else if (status == tr("Queued")) {
+        return GekkoFyre::DownloadStatus::Queued;
     } else {
         return GekkoFyre::DownloadStatus::Unknown;
     }
@@ -1799,58 +2448,363 @@ QString GekkoFyre::CmnRoutines::numberConverter(const double &value)
     }
 }
 
-bool GekkoFyre::CmnRoutines::write_torrent_files_addendum(std::vector<GekkoFyre::GkTorrent::TorrentFile> &to_files_vec,
-                                                          const std::string &download_key,
-                                                          const GekkoFyre::GkFile::FileDb &db_struct) noexcept
+/**
+ * @brief GekkoFyre::CmnRoutines::encode_curl_record packs the history of a HTTP(S)/FTP(S) download into a single binary
+ * record, so that it may be stored under the one key. The path and Unique ID are left out, as these are already kept
+ * alongside the Unique ID itself.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-18
+ * @param dl_info The download information to be encoded.
+ * @return The record, ready to be written to the database.
+ */
+std::string GekkoFyre::CmnRoutines::encode_curl_record(const GekkoFyre::GkCurl::CurlDlInfo &dl_info)
 {
-    if (!to_files_vec.empty()) {
-        static int counter;
-        counter = 0;
-        for (auto &f: to_files_vec) {
-            ++counter;
-            std::string file_key, mapflepce_key;
-            std::ostringstream file_write_data, mapflepce_write_data;
-            leveldb::WriteOptions write_options;
-            leveldb::WriteBatch batch;
+    GkRecordWriter out(LEVELDB_RECORD_TYPE_CURL, LEVELDB_RECORD_VERSION);
+    out.put_i32(convDlStat_toInt(dl_info.dlStatus));
+    out.put_i64(dl_info.insert_timestamp);
+    out.put_i64(dl_info.complt_timestamp);
+    out.put_str(dl_info.ext_info.status_msg);
+    out.put_str(dl_info.ext_info.effective_url);
+    out.put_i64(dl_info.ext_info.response_code);
+    out.put_f64(dl_info.ext_info.content_length);
+    out.put_i32(convHashType_toInt(dl_info.hash_type));
+    out.put_str(dl_info.hash_val_given);
+    out.put_str(dl_info.hash_val_rtrnd);
+    out.put_i32(convHashVerif_toInt(dl_info.hash_succ_type));
+
+    // Added with version 2 of the record
+    out.put_i32((int32_t)dl_info.mirrors.size());
+    for (const auto &mirror: dl_info.mirrors) {
+        out.put_str(mirror);
+    }
+
+    // Added with version 3 of the record
+    out.put_i32((int32_t)dl_info.segments.size());
+    for (const auto &seg: dl_info.segments) {
+        out.put_i64(seg.range_begin);
+        out.put_i64(seg.range_end);
+        out.put_i64(seg.written);
+    }
+
+    return out.data();
+}
 
-            file_key = multipart_key({download_key, LEVELDB_KEY_TORRENT_TORRENT_FILES, std::to_string(counter)});
-            mapflepce_key = multipart_key({download_key, LEVELDB_CHILD_NODE_TORRENT_FILES_MAPFLEPCE, std::to_string(counter)});
-            write_options.sync = true;
-            batch.Delete(file_key);
-            batch.Delete(mapflepce_key);
+/**
+ * @brief GekkoFyre::CmnRoutines::decode_curl_record is the reverse of encode_curl_record(), and reads each field straight
+ * out of the record without any string parsing.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-18
+ * @param record The record, as read from the database.
+ * @return The download information, minus the path and Unique ID.
+ */
+GekkoFyre::GkCurl::CurlDlInfo GekkoFyre::CmnRoutines::decode_curl_record(const std::string &record)
+{
+    GkRecordReader in(record, LEVELDB_RECORD_TYPE_CURL);
+    if (in.version() > LEVELDB_RECORD_VERSION) {
+        throw std::runtime_error(tr("The download history has been written by a newer version of FyreDL!").toStdString());
+    }
+
+    GekkoFyre::GkCurl::CurlDlInfo dl_info;
+    dl_info.dlStatus = convDlStat_IntToEnum(in.get_i32());
+    dl_info.insert_timestamp = in.get_i64();
+    dl_info.complt_timestamp = in.get_i64();
+    dl_info.ext_info.status_msg = in.get_str();
+    dl_info.ext_info.effective_url = in.get_str();
+    dl_info.ext_info.response_code = in.get_i64();
+    dl_info.ext_info.content_length = in.get_f64();
+    dl_info.hash_type = convHashType_IntToEnum(in.get_i32());
+    dl_info.hash_val_given = in.get_str();
+    dl_info.hash_val_rtrnd = in.get_str();
+    dl_info.hash_succ_type = convHashVerif_IntToEnum(in.get_i32());
+    if (in.version() >= 2) {
+        const int32_t mirror_count = in.get_i32();
+        for (int32_t i = 0; i < mirror_count; ++i) {
+            dl_info.mirrors.push_back(in.get_str());
+        }
+    }
 
-            if (f.sha1_hash_hex.empty()) {
-                f.sha1_hash_hex = "";
-            }
+    if (in.version() >= 3) {
+        const int32_t seg_count = in.get_i32();
+        for (int32_t i = 0; i < seg_count; ++i) {
+            GekkoFyre::GkCurl::SegmentRange seg;
+            seg.range_begin = in.get_i64();
+            seg.range_end = in.get_i64();
+            seg.written = in.get_i64();
+            dl_info.segments.push_back(seg);
+        }
+    }
 
-            file_write_data << LEVELDB_CSV_TORRENT_FILE_PATH << "," << LEVELDB_CSV_TORRENT_FILE_CONTENT_LENGTH << ",";
-            file_write_data << LEVELDB_CSV_TORRENT_FILE_SHA1 << "," << LEVELDB_CSV_TORRENT_FILE_FILE_OFFSET << ",";
-            file_write_data << LEVELDB_CSV_TORRENT_FILE_MTIME << "," << LEVELDB_CSV_TORRENT_FILE_MAPFLEPCE_KEY ",";
-            file_write_data << LEVELDB_CSV_TORRENT_FILE_BOOL_DLED << "," << LEVELDB_CSV_TORRENT_FILE_FLAGS << std::endl;
-            file_write_data << f.file_path << "," << std::to_string(f.content_length) << "," << f.sha1_hash_hex << ",";
-            file_write_data << std::to_string(f.file_offset) << "," << std::to_string(f.mtime) << ",";
-            file_write_data << mapflepce_key << "," << std::to_string(f.downloaded) << "," << std::to_string(f.flags);
+    dl_info.ext_info.status_ok = (dl_info.ext_info.response_code >= 200 && dl_info.ext_info.response_code < 300);
+    dl_info.ext_info.elapsed = -1;
+    dl_info.ext_info.accept_ranges = false;
+    return dl_info;
+}
 
-            mapflepce_write_data << LEVELDB_CSV_TORRENT_MAPFLEPCE_1 << "," << LEVELDB_CSV_TORRENT_MAPFLEPCE_2 << std::endl;
-            mapflepce_write_data << std::to_string(f.map_file_piece.first) << "," << std::to_string(f.map_file_piece.second);
+/**
+ * @brief GekkoFyre::CmnRoutines::read_curl_record reads the history of a single HTTP(S)/FTP(S) download from the database.
+ * Should the download still be stored in the older layout, with a key for every field, then it is converted over into a
+ * record there and then.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-18
+ * @param download_id The Unique ID of the download.
+ * @param file_loc The path of the download on the user's local storage.
+ * @return The download information.
+ */
+GekkoFyre::GkCurl::CurlDlInfo GekkoFyre::CmnRoutines::read_curl_record(const std::string &download_id, const std::string &file_loc)
+{
+    GekkoFyre::GkCurl::CurlDlInfo dl_info;
+    std::string record;
+    if (find_item_db(download_id, LEVELDB_KEY_CURL_RECORD, record, db)) {
+        dl_info = decode_curl_record(record);
+    } else {
+        dl_info = read_legacy_curl_item(download_id);
+        std::vector<std::string> legacy_keys;
+        for (const auto &key: {LEVELDB_KEY_CURL_STAT, LEVELDB_KEY_CURL_INSERT_DATE, LEVELDB_KEY_CURL_COMPLT_DATE,
+                               LEVELDB_KEY_CURL_STATMSG, LEVELDB_KEY_CURL_EFFEC_URL, LEVELDB_KEY_CURL_RESP_CODE,
+                               LEVELDB_KEY_CURL_CONT_LNGTH, LEVELDB_KEY_CURL_HASH_TYPE, LEVELDB_KEY_CURL_HASH_VAL_GIVEN,
+                               LEVELDB_KEY_CURL_HASH_VAL_RTRND, LEVELDB_KEY_CURL_HASH_SUCC_TYPE}) {
+            legacy_keys.push_back(multipart_key({download_id, key}));
+        }
 
-            batch.Put(file_key, file_write_data.str());
-            batch.Put(mapflepce_key, mapflepce_write_data.str());
+        replace_legacy_items(download_id, LEVELDB_KEY_CURL_RECORD, encode_curl_record(dl_info), legacy_keys, db);
+    }
 
-            std::lock_guard<std::mutex> locker(db_mutex);
-            leveldb::Status s;
-            s = db_struct.db->Write(write_options, &batch);
-            if (!s.ok()) {
-                std::cerr << tr("Error whilst processing files for BitTorrent item: \"%1\".\nError: ")
-                        .arg(QString::fromStdString(download_key)).toStdString() << s.ToString() << std::endl;
-                return false;
-            }
+    dl_info.file_loc = file_loc;
+    dl_info.unique_id = download_id;
+    return dl_info;
+}
+
+GekkoFyre::GkCurl::CurlDlInfo GekkoFyre::CmnRoutines::read_legacy_curl_item(const std::string &download_id)
+{
+    GekkoFyre::GkCurl::CurlDlInfo dl_info;
+    std::string curl_stat, insert_date, complt_date, resp_code, cont_lgnth, hash_type, hash_succ_type;
+
+    curl_stat = read_item_db(download_id, LEVELDB_KEY_CURL_STAT, db);
+    insert_date = read_item_db(download_id, LEVELDB_KEY_CURL_INSERT_DATE, db);
+    complt_date = read_item_db(download_id, LEVELDB_KEY_CURL_COMPLT_DATE, db);
+    resp_code = read_item_db(download_id, LEVELDB_KEY_CURL_RESP_CODE, db);
+    cont_lgnth = read_item_db(download_id, LEVELDB_KEY_CURL_CONT_LNGTH, db);
+    hash_type = read_item_db(download_id, LEVELDB_KEY_CURL_HASH_TYPE, db);
+    hash_succ_type = read_item_db(download_id, LEVELDB_KEY_CURL_HASH_SUCC_TYPE, db);
+
+    dl_info.dlStatus = convDlStat_IntToEnum(std::atoi(curl_stat.c_str()));
+    dl_info.insert_timestamp = std::atoll(insert_date.c_str());
+    dl_info.complt_timestamp = std::atoll(complt_date.c_str());
+    dl_info.ext_info.response_code = std::atoll(resp_code.c_str());
+    dl_info.ext_info.status_ok = (dl_info.ext_info.response_code >= 200 && dl_info.ext_info.response_code < 300);
+    dl_info.ext_info.elapsed = -1;
+    dl_info.ext_info.accept_ranges = false;
+    dl_info.ext_info.status_msg = read_item_db(download_id, LEVELDB_KEY_CURL_STATMSG, db);
+    dl_info.ext_info.effective_url = read_item_db(download_id, LEVELDB_KEY_CURL_EFFEC_URL, db);
+    dl_info.ext_info.content_length = std::atof(cont_lgnth.c_str());
+    dl_info.hash_type = convHashType_IntToEnum(std::atoi(hash_type.c_str()));
+    dl_info.hash_val_given = read_item_db(download_id, LEVELDB_KEY_CURL_HASH_VAL_GIVEN, db);
+    dl_info.hash_val_rtrnd = read_item_db(download_id, LEVELDB_KEY_CURL_HASH_VAL_RTRND, db);
+    dl_info.hash_succ_type = convHashVerif_IntToEnum(std::atoi(hash_succ_type.c_str()));
+    return dl_info;
+}
+
+/**
+ * @brief GekkoFyre::CmnRoutines::encode_torrent_record packs the history of a BitTorrent download into a single binary
+ * record, inclusive of its trackers and internal files. The files come last, so that a minimal read-out may stop short
+ * of them.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-18
+ * @param gk_ti The BitTorrent related information to be encoded.
+ * @return The record, ready to be written to the database.
+ */
+std::string GekkoFyre::CmnRoutines::encode_torrent_record(const GekkoFyre::GkTorrent::TorrentInfo &gk_ti)
+{
+    GkRecordWriter out(LEVELDB_RECORD_TYPE_TORRENT, LEVELDB_RECORD_VERSION, 256 + (gk_ti.files_vec.size() * 96));
+    out.put_i64(gk_ti.general.insert_timestamp);
+    out.put_i64(gk_ti.general.complt_timestamp);
+    out.put_i64(gk_ti.general.creatn_timestamp);
+    out.put_i32(convDlStat_toInt(gk_ti.general.dlStatus));
+    out.put_str(gk_ti.general.comment);
+    out.put_str(gk_ti.general.creator);
+    out.put_str(gk_ti.general.magnet_uri);
+    out.put_str(gk_ti.general.torrent_name);
+    out.put_i32(gk_ti.general.num_files);
+    out.put_i32(gk_ti.general.num_trackers);
+    out.put_i32(gk_ti.general.num_pieces);
+    out.put_i32(gk_ti.general.piece_length);
+
+    out.put_i32(static_cast<int32_t>(gk_ti.trackers.size()));
+    for (const auto &t: gk_ti.trackers) {
+        out.put_str(t.url);
+        out.put_i32(t.tier);
+        out.put_u8(t.enabled);
+    }
+
+    out.put_i32(static_cast<int32_t>(gk_ti.files_vec.size()));
+    for (const auto &f: gk_ti.files_vec) {
+        out.put_str(f.file_path);
+        out.put_str(f.sha1_hash_hex);
+        out.put_i32(f.flags);
+        out.put_i64(f.content_length);
+        out.put_i64(f.file_offset);
+        out.put_i64(f.mtime);
+        out.put_i32(f.map_file_piece.first);
+        out.put_i32(f.map_file_piece.second);
+        out.put_u8(f.downloaded);
+    }
+
+    return out.data();
+}
+
+/**
+ * @brief GekkoFyre::CmnRoutines::decode_torrent_record is the reverse of encode_torrent_record().
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-18
+ * @param record The record, as read from the database.
+ * @param minimal_readout Whether to leave out the internal files of the torrent.
+ * @return The BitTorrent related information, minus the Unique ID and download destination.
+ */
+GekkoFyre::GkTorrent::TorrentInfo GekkoFyre::CmnRoutines::decode_torrent_record(const std::string &record,
+                                                                                const bool &minimal_readout)
+{
+    GkRecordReader in(record, LEVELDB_RECORD_TYPE_TORRENT);
+    if (in.version() > LEVELDB_RECORD_VERSION) {
+        throw std::runtime_error(tr("The download history has been written by a newer version of FyreDL!").toStdString());
+    }
+
+    GekkoFyre::GkTorrent::TorrentInfo to_info;
+    to_info.general.insert_timestamp = in.get_i64();
+    to_info.general.complt_timestamp = in.get_i64();
+    to_info.general.creatn_timestamp = static_cast<long>(in.get_i64());
+    to_info.general.dlStatus = convDlStat_IntToEnum(in.get_i32());
+    to_info.general.comment = in.get_str();
+    to_info.general.creator = in.get_str();
+    to_info.general.magnet_uri = in.get_str();
+    to_info.general.torrent_name = in.get_str();
+    to_info.general.num_files = in.get_i32();
+    to_info.general.num_trackers = in.get_i32();
+    to_info.general.num_pieces = in.get_i32();
+    to_info.general.piece_length = in.get_i32();
+
+    const int32_t num_trackers = in.get_i32();
+    to_info.trackers.reserve(num_trackers);
+    for (int32_t i = 0; i < num_trackers; ++i) {
+        GekkoFyre::GkTorrent::TorrentTrackers tracker;
+        tracker.url = in.get_str();
+        tracker.tier = in.get_i32();
+        tracker.enabled = (in.get_u8() != 0);
+        to_info.trackers.push_back(tracker);
+    }
+
+    if (!minimal_readout) {
+        const int32_t num_files = in.get_i32();
+        to_info.files_vec.reserve(num_files);
+        for (int32_t i = 0; i < num_files; ++i) {
+            GekkoFyre::GkTorrent::TorrentFile file;
+            file.file_path = in.get_str();
+            file.sha1_hash_hex = in.get_str();
+            file.flags = in.get_i32();
+            file.content_length = in.get_i64();
+            file.file_offset = in.get_i64();
+            file.mtime = static_cast<uint32_t>(in.get_i64());
+            file.map_file_piece.first = in.get_i32();
+            file.map_file_piece.second = in.get_i32();
+            file.downloaded = (in.get_u8() != 0);
+            to_info.files_vec.push_back(file);
         }
+    }
 
-        return true;
+    return to_info;
+}
+
+/**
+ * @brief GekkoFyre::CmnRoutines::read_torrent_record reads the history of a single BitTorrent download from the database,
+ * converting it over into a record should it still be stored in the older layout.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-18
+ * @param download_id The Unique ID of the torrent.
+ * @param down_dest Where the torrent is being downloaded to on the user's local storage.
+ * @param minimal_readout Whether to leave out the internal files of the torrent.
+ * @return The BitTorrent related information.
+ */
+GekkoFyre::GkTorrent::TorrentInfo GekkoFyre::CmnRoutines::read_torrent_record(const std::string &download_id,
+                                                                              const std::string &down_dest,
+                                                                              const bool &minimal_readout)
+{
+    GekkoFyre::GkTorrent::TorrentInfo to_info;
+    std::string record;
+    if (find_item_db(download_id, LEVELDB_KEY_TORRENT_RECORD, record, db)) {
+        to_info = decode_torrent_record(record, minimal_readout);
+    } else {
+        to_info = read_legacy_torrent_item(download_id);
+        std::vector<std::string> legacy_keys;
+        for (const auto &key: {LEVELDB_KEY_TORRENT_INSERT_DATE, LEVELDB_KEY_TORRENT_COMPLT_DATE, LEVELDB_KEY_TORRENT_CREATN_DATE,
+                               LEVELDB_KEY_TORRENT_DLSTATUS, LEVELDB_KEY_TORRENT_TORRNT_COMMENT, LEVELDB_KEY_TORRENT_TORRNT_CREATOR,
+                               LEVELDB_KEY_TORRENT_MAGNET_URI, LEVELDB_KEY_TORRENT_TORRNT_NAME, LEVELDB_KEY_TORRENT_NUM_FILES,
+                               LEVELDB_KEY_TORRENT_NUM_TRACKERS, LEVELDB_KEY_TORRENT_TORRNT_PIECES,
+                               LEVELDB_KEY_TORRENT_TORRNT_PIECE_LENGTH}) {
+            legacy_keys.push_back(multipart_key({download_id, key}));
+        }
+
+        for (int i = 1; i <= to_info.general.num_files; ++i) {
+            legacy_keys.push_back(multipart_key({download_id, LEVELDB_KEY_TORRENT_TORRENT_FILES, std::to_string(i)}));
+            legacy_keys.push_back(multipart_key({download_id, LEVELDB_CHILD_NODE_TORRENT_FILES_MAPFLEPCE, std::to_string(i)}));
+        }
+
+        for (int i = 1; i <= to_info.general.num_trackers; ++i) {
+            legacy_keys.push_back(multipart_key({download_id, LEVELDB_KEY_TORRENT_TRACKERS, std::to_string(i)}));
+        }
+
+        replace_legacy_items(download_id, LEVELDB_KEY_TORRENT_RECORD, encode_torrent_record(to_info), legacy_keys, db);
     }
 
-    return false;
+    assign_torrent_id(to_info, download_id, down_dest);
+    return to_info;
+}
+
+void GekkoFyre::CmnRoutines::assign_torrent_id(GekkoFyre::GkTorrent::TorrentInfo &to_info, const std::string &download_id,
+                                               const std::string &down_dest)
+{
+    to_info.general.unique_id = download_id;
+    to_info.general.down_dest = down_dest;
+    for (auto &t: to_info.trackers) {
+        t.unique_id = download_id;
+    }
+
+    for (auto &f: to_info.files_vec) {
+        f.unique_id = download_id;
+    }
+
+    return;
+}
+
+GekkoFyre::GkTorrent::TorrentInfo GekkoFyre::CmnRoutines::read_legacy_torrent_item(const std::string &download_id)
+{
+    GekkoFyre::GkTorrent::TorrentInfo to_info;
+    GekkoFyre::GkTorrent::GeneralInfo &gen_info = to_info.general;
+    std::string insert_date, complt_date, creatn_date, num_files, num_trackers, num_pieces, piece_length;
+
+    insert_date = read_item_db(download_id, LEVELDB_KEY_TORRENT_INSERT_DATE, db);
+    complt_date = read_item_db(download_id, LEVELDB_KEY_TORRENT_COMPLT_DATE, db);
+    creatn_date = read_item_db(download_id, LEVELDB_KEY_TORRENT_CREATN_DATE, db);
+    num_files = read_item_db(download_id, LEVELDB_KEY_TORRENT_NUM_FILES, db);
+    num_trackers = read_item_db(download_id, LEVELDB_KEY_TORRENT_NUM_TRACKERS, db);
+    num_pieces = read_item_db(download_id, LEVELDB_KEY_TORRENT_TORRNT_PIECES, db);
+    piece_length = read_item_db(download_id, LEVELDB_KEY_TORRENT_TORRNT_PIECE_LENGTH, db);
+
+    gen_info.insert_timestamp = std::atoll(insert_date.c_str());
+    gen_info.complt_timestamp = std::atoll(complt_date.c_str());
+    gen_info.creatn_timestamp = std::atol(creatn_date.c_str());
+    // NOTE: The status was written out as a string in this layout, not as an integer!
+    gen_info.dlStatus = convDlStat_StringToEnum(QString::fromStdString(read_item_db(download_id, LEVELDB_KEY_TORRENT_DLSTATUS, db)));
+    gen_info.comment = read_item_db(download_id, LEVELDB_KEY_TORRENT_TORRNT_COMMENT, db);
+    gen_info.creator = read_item_db(download_id, LEVELDB_KEY_TORRENT_TORRNT_CREATOR, db);
+    gen_info.magnet_uri = read_item_db(download_id, LEVELDB_KEY_TORRENT_MAGNET_URI, db);
+    gen_info.torrent_name = read_item_db(download_id, LEVELDB_KEY_TORRENT_TORRNT_NAME, db);
+    gen_info.num_files = std::atoi(num_files.c_str());
+    gen_info.num_trackers = std::atoi(num_trackers.c_str());
+    gen_info.num_pieces = std::atoi(num_pieces.c_str());
+    gen_info.piece_length = std::atoi(piece_length.c_str());
+
+    to_info.files_vec = read_torrent_files_addendum(gen_info.num_files, download_id, db);
+    to_info.trackers = read_torrent_trkrs_addendum(gen_info.num_trackers, download_id, db);
+    return to_info;
 }
 
 std::vector<GekkoFyre::GkTorrent::TorrentFile> GekkoFyre::CmnRoutines::read_torrent_files_addendum(const int &num_files, const std::string &download_key,
@@ -1886,18 +2840,14 @@ std::vector<GekkoFyre::GkTorrent::TorrentFile> GekkoFyre::CmnRoutines::read_torr
                             .arg(QString::fromStdString(download_key)), QMessageBox::Ok);
                 }
 
-                std::string file_path, content_length, sha1, file_offset, mod_time, mapflepce_key, bool_dled, flags;
+                std::string mapflepce_key;
+                int bool_dled;
                 GekkoFyre::GkTorrent::TorrentFile item;
-                while (csv_parse.read_row(file_path, content_length, sha1, file_offset, mod_time, mapflepce_key, bool_dled, flags)) {
+                while (csv_parse.read_row(item.file_path, item.content_length, item.sha1_hash_hex, item.file_offset, item.mtime,
+                                          mapflepce_key, bool_dled, item.flags)) {
                     if (!download_key.empty()) {
                         item.unique_id = download_key; // This is needed because we are not extracting the key in the CSV data itself
-                        item.file_path = file_path;
-                        item.content_length = std::atol(content_length.c_str());
-                        item.sha1_hash_hex = sha1;
-                        item.file_offset = std::atol(file_offset.c_str());
-                        item.mtime = std::atoi(mod_time.c_str());
-                        item.downloaded = convertBool_fromInt(std::atoi(bool_dled.c_str()));
-                        item.flags = std::atoi(flags.c_str());
+                        item.downloaded = convertBool_fromInt(bool_dled);
 
                         std::string csv_mapflepce_data;
                         if (!mapflepce_key.empty()) {
@@ -1919,12 +2869,7 @@ std::vector<GekkoFyre::GkTorrent::TorrentFile> GekkoFyre::CmnRoutines::read_torr
                                     .arg(QString::fromStdString(download_key)), QMessageBox::Ok);
                         }
 
-                        std::string mapflepce_1, mapflepce_2;
-                        while (csv_mapflepce_parse.read_row(mapflepce_1, mapflepce_2)) {
-                            item.map_file_piece.first = std::atoi(mapflepce_1.c_str());
-                            item.map_file_piece.second = std::atoi(mapflepce_2.c_str());
-                            break;
-                        }
+                        csv_mapflepce_parse.read_row(item.map_file_piece.first, item.map_file_piece.second);
                     }
 
                     to_files.push_back(item);
@@ -1938,51 +2883,15 @@ std::vector<GekkoFyre::GkTorrent::TorrentFile> GekkoFyre::CmnRoutines::read_torr
     return std::vector<GekkoFyre::GkTorrent::TorrentFile>();
 }
 
-bool GekkoFyre::CmnRoutines::write_torrent_trkrs_addendum(const std::vector<GekkoFyre::GkTorrent::TorrentTrackers> &to_trackers_vec,
-                                                          const std::string &download_key,
-                                                          const GekkoFyre::GkFile::FileDb &db_struct) noexcept {
-    if (!to_trackers_vec.empty()) {
-        static int counter;
-        counter = 0;
-        for (const auto &t: to_trackers_vec) {
-            ++counter;
-            std::string tracker_key;
-            std::ostringstream tracker_write_data;
-            leveldb::WriteOptions write_options;
-            leveldb::WriteBatch batch;
-
-            tracker_key = multipart_key({download_key, LEVELDB_KEY_TORRENT_TRACKERS, std::to_string(counter)});
-            write_options.sync = true;
-            batch.Delete(tracker_key);
-
-            tracker_write_data << LEVELDB_CSV_TORRENT_TRACKER_URL << "," << LEVELDB_CSV_TORRENT_TRACKER_TIER ",";
-            tracker_write_data << LEVELDB_CSV_TORRENT_TRACKER_BOOL_ENABLED << std::endl;
-            tracker_write_data << t.url << "," << std::to_string(t.tier) << "," << std::to_string(t.enabled);
-
-            std::lock_guard<std::mutex> locker(db_mutex);
-            batch.Put(tracker_key, tracker_write_data.str());
-            leveldb::Status s;
-            s = db_struct.db->Write(write_options, &batch);
-            if (!s.ok()) {
-                std::cerr << tr("Error whilst processing trackers for BitTorrent item: \"%1\".\nError: ")
-                        .arg(QString::fromStdString(download_key)).toStdString() << s.ToString() << std::endl;
-                return false;
-            }
-        }
-    }
-
-    return true;
-}
-
 std::vector<GekkoFyre::GkTorrent::TorrentTrackers> GekkoFyre::CmnRoutines::read_torrent_trkrs_addendum(const int &num_trackers, const std::string &download_key,
                                                                                                        const GekkoFyre::GkFile::FileDb &db_struct)
 {
     if (num_trackers > 0) {
         static int counter;
-        counter = (num_trackers + 1);
+        counter = 0;
         std::vector<GekkoFyre::GkTorrent::TorrentTrackers> to_trackers;
-        while (counter > num_trackers) {
-            --counter;
+        while (counter < num_trackers) {
+            ++counter;
             std::string tracker_key, csv_tracker_data;
             leveldb::ReadOptions read_opt;
             leveldb::Status s;
@@ -2006,12 +2915,10 @@ std::vector<GekkoFyre::GkTorrent::TorrentTrackers> GekkoFyre::CmnRoutines::read_
                             .arg(QString::fromStdString(download_key)), QMessageBox::Ok);
                 }
 
-                std::string tracker_url, tracker_tier, tracker_bool_enabled;
+                int tracker_bool_enabled;
                 GekkoFyre::GkTorrent::TorrentTrackers item;
-                while (csv_parse.read_row(tracker_url, tracker_tier, tracker_bool_enabled)) {
-                    item.url = tracker_url;
-                    item.tier = std::atoi(tracker_tier.c_str());
-                    item.enabled = convertBool_fromInt(std::atoi(tracker_bool_enabled.c_str()));
+                while (csv_parse.read_row(item.url, item.tier, tracker_bool_enabled)) {
+                    item.enabled = convertBool_fromInt(tracker_bool_enabled);
                     item.unique_id = download_key;
                 }
 
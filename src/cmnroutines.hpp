@@ -44,14 +44,21 @@
 #define CMNROUTINES_HPP
 
 #include "default_var.hpp"
+#include <leveldb/write_batch.h>
 #include <libtorrent/entry.hpp>
 #include <string>
 #include <cstdio>
+#include <cstdint>
 #include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
 #include <exception>
 #include <stdexcept>
 #include <initializer_list>
 #include <unordered_map>
+#include <functional>
 #include <QString>
 #include <QObject>
 #include <QMutex>
@@ -90,7 +97,7 @@ public:
     int convDownType_toInt(const GekkoFyre::DownloadType &down_type);
     GekkoFyre::HashType convHashType_IntToEnum(const int &t);
     GekkoFyre::HashVerif convHashVerif_IntToEnum(const int &v);
-    QCryptographicHash::Algorithm convHashType_toAlgo(const GekkoFyre::HashType &hash_type);
+    static QCryptographicHash::Algorithm convHashType_toAlgo(const GekkoFyre::HashType &hash_type);
     static GekkoFyre::DownloadStatus convDlStat_IntToEnum(const int &s);
     QString convDlStat_toString(const GekkoFyre::DownloadStatus &status);
     GekkoFyre::DownloadStatus convDlStat_StringToEnum(const QString &status);
@@ -100,9 +107,11 @@ public:
     GekkoFyre::DownloadType convDownType_IntToEnum(const int &down_int);
 
     static long getFileSize(const std::string &file_name);
-    unsigned long int freeDiskSpace(const QString &path = QDir::rootPath());
-    GekkoFyre::GkFile::FileHash cryptoFileHash(const QString &file_dest, const GekkoFyre::HashType &hash_type,
-                                               const QString &given_hash_val);
+    static unsigned long int freeDiskSpace(const QString &path = QDir::rootPath());
+    static GekkoFyre::GkFile::FileHash cryptoFileHash(const QString &file_dest, const GekkoFyre::HashType &hash_type,
+                                                      const QString &given_hash_val,
+                                                      const std::function<void(const qint64 &done, const qint64 &total)> &progress = nullptr,
+                                                      const std::atomic<bool> *cancel = nullptr);
     GekkoFyre::GkTorrent::TorrentInfo torrentFileInfo(const std::string &file_dest,
                                                       const int &item_limit = 500000,
                                                       const int &depth_limit = 1000);
@@ -122,6 +131,7 @@ public:
 
     std::vector<GekkoFyre::GkCurl::CurlDlInfo> readCurlItems(const bool &hashesOnly = false);
     bool addCurlItem(GekkoFyre::GkCurl::CurlDlInfo &dl_info_list);
+    bool addCurlItems(const std::vector<GekkoFyre::GkCurl::CurlDlInfo> &dl_info);
     bool delCurlItem(const QString &file_dest, const std::string &unique_id_backup = "");
     bool modifyCurlItem(const std::string &file_loc, const GekkoFyre::DownloadStatus &status,
                         const long long &complt_timestamp = 0,
@@ -129,12 +139,21 @@ public:
                         const GekkoFyre::HashType &hash_type = GekkoFyre::HashType::None,
                         const std::string &hash_rtrnd = "",
                         const GekkoFyre::HashVerif &ret_succ_type = GekkoFyre::HashVerif::NotApplicable);
+    bool modifyCurlSegments(const std::string &file_loc, const std::vector<GekkoFyre::GkCurl::SegmentRange> &segments);
     bool modifyTorrentItem(const std::string &unique_id, const GekkoFyre::DownloadStatus &dl_status);
 
     bool addTorrentItem(GekkoFyre::GkTorrent::TorrentInfo &gk_ti);
     std::vector<GekkoFyre::GkTorrent::TorrentInfo> readTorrentItems(const bool &minimal_readout = false);
     bool delTorrentItem(const std::string &unique_id);
 
+    bool readHistory(std::vector<GekkoFyre::GkCurl::CurlDlInfo> &curl_items,
+                     std::vector<GekkoFyre::GkTorrent::TorrentInfo> &torrent_items,
+                     const bool &minimal_readout = true);
+    bool findCurlItem(const std::string &unique_id, GekkoFyre::GkCurl::CurlDlInfo &dl_info);
+    bool findCurlItemByPath(const std::string &file_loc, GekkoFyre::GkCurl::CurlDlInfo &dl_info);
+    bool findTorrentItem(const std::string &unique_id, GekkoFyre::GkTorrent::TorrentInfo &gk_ti,
+                         const bool &minimal_readout = false);
+
 private:
     int load_file(const std::string &filename, std::vector<char> &v,
                   libtorrent::error_code &ec, int limit = 8000000);
@@ -142,16 +161,46 @@ private:
     bool convertBool_fromInt(const int &value) noexcept;
     std::string multipart_key(const std::initializer_list<std::string> &args);
     std::string add_download_id(const std::string &file_path, const GekkoFyre::GkFile::FileDb &db_struct,
-                                const bool &is_torrent = false, const std::string &override_unique_id = "");
+                                const bool &is_torrent = false, const std::string &override_unique_id = "",
+                                const std::string &record_key = "", const std::string &record = "");
+    void put_download_id(leveldb::WriteBatch &batch, const std::string &unique_id, const std::string &file_path,
+                         const bool &is_torrent, const std::string &record_key, const std::string &record);
     bool del_download_id(const std::string &unique_id, const GekkoFyre::GkFile::FileDb &db_struct,
-                         const bool &is_torrent = false);
+                         const bool &is_torrent = false, const std::string &record_key = "");
+    std::string encode_download_id(const uint8_t &record_type, const std::string &value, const bool &is_torrent);
+    std::pair<std::string, bool> decode_download_id(const std::string &record, const uint8_t &record_type);
+    void convert_legacy_download_ids(const GekkoFyre::GkFile::FileDb &db_struct);
+
+    bool find_item_db(const std::string &download_id, const std::string &key, std::string &value,
+                      const GekkoFyre::GkFile::FileDb &db_struct);
+    leveldb::Status commit_batch(leveldb::WriteBatch &batch, const GekkoFyre::GkFile::FileDb &db_struct);
+    void replace_legacy_items(const std::string &download_id, const std::string &record_key, const std::string &record,
+                              const std::vector<std::string> &legacy_keys, const GekkoFyre::GkFile::FileDb &db_struct);
+
+    std::string encode_curl_record(const GekkoFyre::GkCurl::CurlDlInfo &dl_info);
+    GekkoFyre::GkCurl::CurlDlInfo decode_curl_record(const std::string &record);
+    GekkoFyre::GkCurl::CurlDlInfo read_curl_record(const std::string &download_id, const std::string &file_loc);
+    GekkoFyre::GkCurl::CurlDlInfo read_legacy_curl_item(const std::string &download_id);
+    std::string encode_torrent_record(const GekkoFyre::GkTorrent::TorrentInfo &gk_ti);
+    GekkoFyre::GkTorrent::TorrentInfo decode_torrent_record(const std::string &record, const bool &minimal_readout);
+    GekkoFyre::GkTorrent::TorrentInfo read_torrent_record(const std::string &download_id, const std::string &down_dest,
+                                                          const bool &minimal_readout);
+    GekkoFyre::GkTorrent::TorrentInfo read_legacy_torrent_item(const std::string &download_id);
+    void assign_torrent_id(GekkoFyre::GkTorrent::TorrentInfo &to_info, const std::string &download_id,
+                           const std::string &down_dest);
+    void load_history(std::vector<GekkoFyre::GkCurl::CurlDlInfo> *curl_items,
+                      std::vector<GekkoFyre::GkTorrent::TorrentInfo> *torrent_items,
+                      const bool &minimal_readout, const GekkoFyre::GkFile::FileDb &db_struct);
+
+    void load_record_cache(const GekkoFyre::GkFile::FileDb &db_struct);
+    GekkoFyre::GkTorrent::TorrentInfo copy_torrent_record(const GekkoFyre::GkTorrent::TorrentInfo &gk_ti,
+                                                          const bool &minimal_readout);
+    void cache_curl_record(const GekkoFyre::GkCurl::CurlDlInfo &dl_info);
+    void cache_torrent_record(const GekkoFyre::GkTorrent::TorrentInfo &gk_ti);
+    void uncache_record(const std::string &unique_id);
 
-    bool write_torrent_files_addendum(std::vector<GekkoFyre::GkTorrent::TorrentFile> &to_files_vec,
-                                      const std::string &download_key, const GekkoFyre::GkFile::FileDb &db_struct) noexcept;
     std::vector<GkTorrent::TorrentFile> read_torrent_files_addendum(const int &num_files, const std::string &download_key,
                                                                     const GekkoFyre::GkFile::FileDb &db_struct);
-    bool write_torrent_trkrs_addendum(const std::vector<GekkoFyre::GkTorrent::TorrentTrackers> &to_trackers_vec,
-                                      const std::string &download_key, const GekkoFyre::GkFile::FileDb &db_struct) noexcept;
     std::vector<GkTorrent::TorrentTrackers> read_torrent_trkrs_addendum(const int &num_trackers, const std::string &download_key,
                                                                         const GekkoFyre::GkFile::FileDb &db_struct);
 
@@ -165,6 +214,29 @@ private:
     std::mutex r_torrent_mtx;
     std::mutex w_torrent_mtx;
     QMutex mutex;
+
+    // The reverse index, from the path of a download to its Unique ID, is shared between every instance as they all
+    // work upon the same database
+    static std::unordered_map<std::string, std::pair<std::string, bool>> path_index;
+    static std::mutex path_index_mtx;
+
+    struct GroupCommit {
+        leveldb::WriteBatch *batch;
+        leveldb::Status status;
+        bool done;
+    };
+
+    // Batches that are waiting to be committed, whereby the one at the front commits all of them (see 'commit_batch()')
+    static std::deque<GroupCommit *> commit_queue;
+    static std::mutex commit_mtx;
+    static std::condition_variable commit_cond;
+
+    // The records of every download, keyed by their Unique ID. This is filled from the database upon first use and then
+    // written through to by every addition, modification and deletion, so the database need not be re-read each time.
+    static std::map<std::string, GekkoFyre::GkCurl::CurlDlInfo> curl_cache;
+    static std::map<std::string, GekkoFyre::GkTorrent::TorrentInfo> torrent_cache;
+    static bool record_cache_loaded;
+    static std::mutex record_cache_mtx;
 };
 }
 
@@ -33,6 +33,7 @@
 **
 ********************************************************************************/
 
+
 /**
  * @file csv.cpp
  * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
@@ -41,216 +42,132 @@
  */
 
 #include "csv.hpp"
-#include <iostream>
-
-int GekkoFyre::GkCsvReader::rows_parsed;
-int GekkoFyre::GkCsvReader::ret_parsed_cols;
-QMultiMap<int, int> GekkoFyre::GkCsvReader::proc_cols;
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+#include <algorithm>
 
-bool GekkoFyre::GkCsvReader::read_row()
+/**
+ * @brief GekkoFyre::GkCsvReader::has_column determines whether the given header exists within the CSV data.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-23
+ * @param name The header to search for.
+ */
+bool GekkoFyre::GkCsvReader::has_column(const std::string &name) const
 {
-    return false;
+    return (determine_column(name) > 0);
 }
 
-bool GekkoFyre::GkCsvReader::has_column(const std::string &name)
+/**
+ * @brief GekkoFyre::GkCvsReader::determine_column will determine the given column number for a header.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-09
+ * @param header The header you wish to determine the column number for.
+ * @return The column number for a given header. If integer '-1' is returned, the header was not found.
+ */
+int GekkoFyre::GkCsvReader::determine_column(const std::string &header) const
 {
-    if (key) {
-        for (const auto &header: headers) {
-            if (header == name) {
-                return true;
-            }
-        }
-    } else {
-        auto rows = read_rows(csv_raw_data.str());
-        if (!rows.empty()) {
-            for (const auto &row: rows) {
-                // Key is the row number and value is the row of raw data
-                auto cols = split_values(std::stringstream(row.second));
-                if (row.first == 1) {
-                    // Determine headers
-                    for (const auto &col: cols) {
-                        if (col.second == name) {
-                            return true;
-                        }
-                    }
-                }
-            }
+    const std::vector<boost::string_ref> &headers = key ? given_headers : file_headers;
+    for (size_t i = 0; i < headers.size(); ++i) {
+        if (headers[i] == boost::string_ref(header)) {
+            return (int)(i + 1);
         }
     }
 
-    return false;
+    return -1;
 }
 
 /**
- * @brief GekkoFyre::GkCvsReader::read_rows reads each row of the CSV data and outputs them into a STL container.
+ * @brief GekkoFyre::GkCsvReader::rewind goes back to the first row of CSV data, after any headers, so that it may all be
+ * read again.
  * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
- * @date 2017-08-09
- * @return A std::map where the key is the row number, and the value is the row of raw data.
+ * @date 2017-08-23
  */
-std::map<int, std::string> GekkoFyre::GkCsvReader::read_rows(std::string raw_data)
+void GekkoFyre::GkCsvReader::rewind()
 {
-    std::map<int, std::string> lines;
-    if (!raw_data.empty()) {
-        std::lock_guard<std::mutex> lock(excl_mtx);
-        if (search_string(raw_data, "\r\n")) {
-            raw_data.erase(std::remove(raw_data.begin(), raw_data.end(), '\r'),
-                                     raw_data.end());
-        } else if (!search_string(raw_data, "\n")) {
-            throw std::invalid_argument("Unable to find any suitable line-endings for the given CSV data!");
-        }
-
-        if (rows_count != 0) {
-            rows_count = 0;
-        }
-
-        std::string row;
-        std::stringstream istring;
-        istring << raw_data;
-        while (std::getline(istring, row, '\n')) {
-            ++rows_count;
-            lines.insert(std::make_pair(rows_count, row));
-        }
-
-        if (!key) {
-            rows_count = (rows_count - 1); // Remove the column containing the headers
-        }
-    }
-
-    return lines;
+    pos = data_start;
+    cells.clear();
+    return;
 }
 
 /**
- * @brief GekkoFyre::GkCsvReader::parse_csv will parse the CSV data line-by-line and separate out the columns before
- * inserting them into an std::map, ready for immediate use or ideally, further processing.
+ * @brief GekkoFyre::GkCsvReader::next_row tokenises the next row of CSV data into its columns, each of which is a view upon
+ * the data itself. Blank lines are skipped over and both '\n' and '\r\n' line-endings are accepted.
  * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
- * @date 2017-08-10
+ * @date 2017-08-23
+ * @return Whether there was another row to be had or not.
  */
-std::multimap<int, std::pair<int, std::string>> GekkoFyre::GkCsvReader::parse_csv()
+bool GekkoFyre::GkCsvReader::next_row()
 {
-    auto rows = read_rows(csv_raw_data.str());
-    if (!rows.empty()) {
-        csv_data.clear();
-        std::multimap<int, std::pair<int, std::string>> output;
-        size_t start_row = 0;
-        if (!key) {
-            start_row = 1;
+    cells.clear();
+    const char *data_end = data.data() + data.size();
+    while (pos < data.size()) {
+        const char *line = data.data() + pos;
+        const char *eol = static_cast<const char *>(std::memchr(line, '\n', (size_t)(data_end - line)));
+        if (eol == nullptr) {
+            eol = data_end;
         }
 
-        for (size_t i = start_row; i < rows.size(); ++i) {
-            std::string csv;
-            int col = 0;
-            std::stringstream tmp;
-            tmp << extract_values(rows).at(i);
-
-            while (std::getline(tmp, csv, ',')) {
-                if (col >= cols_count) {
-                    col = 0;
-                }
-
-                ++col;
-                output.insert(std::make_pair(((i + 1) - start_row), std::make_pair(col, csv)));
-            }
+        pos = (size_t)(eol - data.data()) + 1;
+        const char *line_end = eol;
+        if (line_end > line && *(line_end - 1) == '\r') {
+            --line_end;
         }
 
-        return output;
-    }
-
-    return std::multimap<int, std::pair<int, std::string>>();
-}
+        if (line_end == line) {
+            continue;
+        }
 
-/**
- * @brief GekkoFyre::GkCvsReader::determine_column will determine the given column number for a header.
- * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
- * @date 2017-08-09
- * @param header The header you wish to determine the column number for.
- * @return The column number for a given header. If integer '-1' is returned, the header was not found.
- */
-int GekkoFyre::GkCsvReader::determine_column(const std::string &header)
-{
-    auto rows = read_rows(csv_raw_data.str());
-    if (!rows.empty()) {
-        for (const auto &row: rows) {
-            // Key is the row number and value is the row of raw data
-            auto cols = split_values(std::stringstream(row.second));
-            if (row.first == 1) {
-                // Determine headers
-                for (const auto &col: cols) {
-                    if (col.second == header) {
-                        return col.first;
-                    }
-                }
+        const char *cell = line;
+        for (const char *c = line; c < line_end; ++c) {
+            if (*c == ',') {
+                cells.emplace_back(cell, (size_t)(c - cell));
+                cell = c + 1;
             }
         }
+
+        cells.emplace_back(cell, (size_t)(line_end - cell));
+        return true;
     }
 
-    return -1;
+    pos = data.size();
+    return false;
 }
 
 /**
- * @brief GekkoFyre::GkCvsReader::split_values splits a single row into its individual columns.
+ * @brief GekkoFyre::GkCsvReader::to_integer converts a cell into an integer in the same fashion as std::atoll(), but
+ * without the need for the cell to be null-terminated.
  * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
- * @date 2017-08-09
- * @param raw_csv_line The raw line of CSV data to parse.
- * @return Outputs a std::map with the key being the column number and the value being the information
- * in that column.
+ * @date 2017-08-23
  */
-std::map<int, std::string> GekkoFyre::GkCsvReader::split_values(std::stringstream raw_csv_line)
+long long GekkoFyre::GkCsvReader::to_integer(const boost::string_ref &cell) const
 {
-    std::string csv;
-    std::map<int, std::string> output;
-    int col = 0;
-    std::lock_guard<std::mutex> lock(excl_mtx);
-    while (std::getline(raw_csv_line, csv, ',')) {
-        ++col;
-        output.insert(std::make_pair(col, csv));
+    size_t i = 0;
+    while (i < cell.size() && std::isspace((unsigned char)cell[i])) {
+        ++i;
     }
 
-    return output;
-}
-
-std::string GekkoFyre::GkCsvReader::read_csv_helper(const int &col_no, const int &row_no)
-{
-    if (col_no == 0 || row_no == 0) {
-        return "";
+    bool negative = false;
+    if (i < cell.size() && (cell[i] == '-' || cell[i] == '+')) {
+        negative = (cell[i] == '-');
+        ++i;
     }
 
-    if (!csv_data.empty()) {
-        std::lock_guard<std::mutex> lock(excl_mtx);
-        if (row_no <= rows_count) {
-            while (col_no <= cols_count) {
-                for (auto col: csv_data) {
-                    if (!proc_cols.contains(row_no, col_no)) {
-                        if ((col.first == row_no) && (col.second.first == col_no)) {
-                            if (!col.second.second.empty()) {
-                                proc_cols.insertMulti(row_no, col_no);
-                                return col.second.second;
-                            } else {
-                                return "";
-                            }
-                        }
-                    } else {
-                        return "";
-                    }
-                }
-            }
-        }
+    long long value = 0;
+    for (; i < cell.size() && std::isdigit((unsigned char)cell[i]); ++i) {
+        value = (value * 10) + (cell[i] - '0');
     }
 
-    return "";
+    return negative ? -value : value;
 }
 
-/**
- * @brief GekkoFyre::GkCsvReader::force_cache_reload forces a reload of the CSV data cache.
- * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
- * @date 2017-08-13
- * @return Whether the operation succeeded or not.
- */
-bool GekkoFyre::GkCsvReader::force_cache_reload()
+void GekkoFyre::GkCsvReader::convert(const boost::string_ref &cell, double &out) const
 {
-    proc_cols.clear();
-    csv_data.clear();
-    ret_parsed_cols = 0;
-    rows_parsed = 0;
-    csv_data = parse_csv();
-    return !csv_data.empty();
+    // std::strtod() needs a null-terminated string, so the cell is copied onto the stack first
+    char buf[64];
+    const size_t len = std::min(cell.size(), sizeof(buf) - 1);
+    std::memcpy(buf, cell.data(), len);
+    buf[len] = '\0';
+    out = std::strtod(buf, nullptr);
+    return;
 }
@@ -33,6 +33,7 @@
  **
  ********************************************************************************/
 
+
 /**
  * @file csv.hpp
  * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
@@ -44,154 +45,100 @@
 #define GKCSV_HPP
 
 #include "default_var.hpp"
-#include <utility>
-#include <algorithm>
-#include <numeric>
-#include <list>
+#include <boost/utility/string_ref.hpp>
 #include <string>
-#include <sstream>
-#include <map>
-#include <mutex>
-#include <QMultiMap>
+#include <vector>
+#include <type_traits>
 
 namespace GekkoFyre {
+/**
+ * @brief GekkoFyre::GkCsvReader tokenises CSV data in the one pass, as each row is asked for, without copying the data
+ * itself. Each cell is a view upon the original data and is only converted (or copied) once it is read out into one of
+ * the arguments given to `read_row()`.
+ * @note The CSV data must outlive the reader. A reader holds no state that is shared with any other, so each may be
+ * used independently of one another, but a single reader is not to be shared between threads.
+ */
 class GkCsvReader {
 public:
     GkCsvReader() = delete;
     GkCsvReader(const GkCsvReader&) = delete;
 
     template<typename ...Headers>
-    explicit GkCsvReader(const int &column_count, const bool &download_ids, const std::string &csv_data, const Headers& ...headers) {
-        cols_count = column_count;
-        key = download_ids;
-        if (!csv_data.empty()) {
-            csv_raw_data << csv_data;
-            rows_parsed = 0;
-            ret_parsed_cols = 0;
-            add_headers(headers...);
-            return;
-        } else {
-            rows_count = 0;
-            rows_parsed = 0;
-            ret_parsed_cols = 0;
-            key = false;
+    explicit GkCsvReader(const int &column_count, const bool &download_ids, const std::string &csv_data, const Headers& ...headers)
+        : data(csv_data), pos(0), cols_count(column_count), key(download_ids), given_headers({ boost::string_ref(headers)... })
+    {
+        cells.reserve((size_t)((cols_count > 0) ? cols_count : 1));
+        if (!key) {
+            // The first row holds the headers for the rest of the data
+            if (next_row()) {
+                file_headers = cells;
+            }
         }
 
+        data_start = pos;
         return;
     }
 
-    virtual bool has_column(const std::string &name);
-    virtual int determine_column(const std::string &header);
-    virtual bool force_cache_reload();
-    bool read_row();
+    // The data is not copied, so a temporary would no longer exist by the time it came to be read
+    template<typename ...Headers>
+    GkCsvReader(const int &column_count, const bool &download_ids, const std::string &&csv_data, const Headers& ...headers) = delete;
+
+    bool has_column(const std::string &name) const;
+    int determine_column(const std::string &header) const;
+    void rewind();
 
     /**
-     * @brief GekkoFyre::GkCsvReader::read_row will output the CSV data via the arguments in a variadic fashion, and is intended
-     * to be used with a while() loop.
+     * @brief GekkoFyre::GkCsvReader::read_row will output the next row of CSV data via the arguments in a variadic fashion,
+     * and is intended to be used with a while() loop. Any columns that are missing from the row are output as empty, or
+     * zero, as the case may be.
      * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
-     * @date 2017-08-13
-     * @param cols The ouputted information. Depending on if this is the first, second, third, etc. argument, it will signify
-     * which column to draw the data from.
+     * @date 2017-08-23
+     * @param cols The outputted information. Depending on if this is the first, second, third, etc. argument, it will signify
+     * which column to draw the data from. These may be either a std::string, an integral type or a double.
      * @return When to abort or repeat the while() loop.
      */
-    template<typename T, typename ...ColTypes>
-    bool read_row(T& col, ColTypes& ...cols) {
-        static int cols_parsed;
-        static bool ret_val;
-        cols_parsed = 0;
-        if (!csv_data.empty()) {
-            if (rows_parsed <= rows_count) {
-                if (recur_mtx.try_lock()) {
-                    while (cols_parsed <= (cols_count - 1)) { // Keep this at `(cols_count - 1)`!.
-                        ++cols_parsed;
-                        std::string col_data;
-                        col_data = read_csv_helper(cols_parsed, (rows_parsed + 1));
-                        if (!col_data.empty()) {
-                            col = col_data;
-                            ret_val = read_row(cols...);
-                        }
-                    }
-
-                    cols_parsed = 0;
-                    if (ret_parsed_cols == (cols_count - 1)) {
-                        ret_parsed_cols = 0;
-                        ++rows_parsed;
-                        recur_mtx.unlock();
-                        return true;
-                    }
-                }
-            }
+    template<typename ...ColTypes>
+    bool read_row(ColTypes& ...cols) {
+        if (!next_row()) {
+            return false;
         }
 
-        ++ret_parsed_cols;
-        recur_mtx.unlock();
-        return false;
+        assign_cols(0, cols...);
+        return true;
     }
 
 private:
-    template<typename T>
-    std::string to_string(const T &value) {
-        std::ostringstream ss;
-        ss << value;
-        return ss.str();
-    }
+    const std::string &data;
+    size_t pos;                                  // Where the next row begins within `data`
+    size_t data_start;                           // Where the first row after any headers begins within `data`
+    int cols_count;
+    bool key;                                    // Whether we are processing `CmnRoutines::extract_download_ids()` or its cousins
+    std::vector<boost::string_ref> given_headers;
+    std::vector<boost::string_ref> file_headers; // The headers as given by the first row of the CSV data itself
+    std::vector<boost::string_ref> cells;        // The columns of the current row, which is reused for every row
 
-    std::string to_string(const std::string &value) {
-        return value;
-    }
+    bool next_row();
+    long long to_integer(const boost::string_ref &cell) const;
 
-    std::stringstream csv_raw_data;
-    int cols_count;
-    int rows_count;
-    static int rows_parsed;
-    static int ret_parsed_cols;                               // The amount of columns that have been parsed and returned successfully in `read_row()`
-    std::recursive_mutex recur_mtx;
-    std::mutex excl_mtx;
-    bool key;                                                 // Whether we are processing `CmnRoutines::extract_download_ids()` or its cousins
-    std::list<std::string> headers;                           // The key is the column number, whilst the value is the header associated with that column.
-    static QMultiMap<int, int> proc_cols;                     // The rows/columns we have already processed under `read_csv_helper()`
-    std::multimap<int, std::pair<int, std::string>> csv_data; // The key is the row number whilst the values are are the column number and the comma-separated-values.
-
-    template<typename Container>
-    bool search_string(const Container &cont, const std::string &to_find) {
-        return std::search(cont.begin(), cont.end(), to_find.begin(), to_find.end()) != cont.end();
-    }
+    void assign_cols(const size_t &) {}
 
-    template<typename ...Headers>
-    void add_headers(const Headers& ...args) {
-        headers = { to_string(args)... };
-        constexpr int args_count = sizeof...(args);
-        cols_count = args_count;
-        csv_data.clear();
-        proc_cols.clear();
-        csv_data = parse_csv();
+    template<typename T, typename ...ColTypes>
+    void assign_cols(const size_t &index, T &col, ColTypes& ...cols) {
+        convert((index < cells.size()) ? cells[index] : boost::string_ref(), col);
+        assign_cols(index + 1, cols...);
     }
 
-    template<typename T, typename X>
-    std::vector<T> extract_keys(const std::map<T, X> &input_map) {
-        std::vector<T> ret_val;
-        for (const auto &element: input_map) {
-            ret_val.push_back(element.second);
-        }
-
-        return ret_val;
+    void convert(const boost::string_ref &cell, std::string &out) const {
+        out.assign(cell.data(), cell.size());
     }
 
-    template<typename T, typename X>
-    std::vector<X> extract_values(const std::map<T, X> &input_map) {
-        std::vector<X> ret_val;
-        for (const auto &element: input_map) {
-            ret_val.push_back(element.second);
-        }
+    void convert(const boost::string_ref &cell, double &out) const;
 
-        return ret_val;
+    template<typename T>
+    typename std::enable_if<std::is_integral<T>::value>::type convert(const boost::string_ref &cell, T &out) const {
+        out = static_cast<T>(to_integer(cell));
     }
-
-    std::map<int, std::string> read_rows(std::string raw_data);
-    std::map<int, std::string> split_values(std::stringstream raw_csv_line);
-    std::multimap<int, std::pair<int, std::string>> parse_csv();
-    std::string read_csv_helper(const int &col_no, const int &row_no);
 };
 }
 
-#endif // GKCSV_HPP
\ No newline at end of file
+#endif // GKCSV_HPP
@@ -42,9 +42,11 @@
  */
 
 #include "curl_easy.hpp"
+#include "curl_probe.hpp"
 #include <cstdio>
 #include <cstdlib>
 #include <string>
+#include <mutex>
 
 GekkoFyre::CurlEasy::CurlEasy()
 {}
@@ -55,165 +57,60 @@ GekkoFyre::CurlEasy::~CurlEasy()
 }
 
 /**
- * @brief GekkoFyre::CurlEasy::new_easy_handle creates a new 'easy-handle' for use by libcurl.
- * @note <https://curl.haxx.se/libcurl/c/CURLOPT_ERRORBUFFER.html>
- * @param url The web-address of the file in question
- * @return
+ * @brief GekkoFyre::CurlEasy::globalInit sets up libcurl for use by the whole of the application, the once, no matter
+ * how many threads should try to do so at the same time.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-25
+ * @note <https://curl.haxx.se/libcurl/c/curl_global_init.html>
  */
-GekkoFyre::GkCurl::CurlInit *GekkoFyre::CurlEasy::new_easy_handle(const QString &url)
+void GekkoFyre::CurlEasy::globalInit()
 {
-    GekkoFyre::GkCurl::CurlInit *ci;
-    ci = new GekkoFyre::GkCurl::CurlInit;
-    ci->conn_info = new GekkoFyre::GkCurl::ConnInfo;
-
-    curl_global_init(CURL_GLOBAL_DEFAULT);
-    ci->conn_info->easy = curl_easy_init(); // Initiate the curl session
-
-    if (!ci->conn_info->easy) {
-        throw std::runtime_error(tr("'curl_easy_init()' failed, exiting!").toStdString());
-    }
-
-    ci->conn_info->url = url.toStdString();
-    curl_easy_setopt(ci->conn_info->easy, CURLOPT_URL, ci->conn_info->url.c_str());
-
-    // Grab only the header
-    curl_easy_setopt(ci->conn_info->easy, CURLOPT_HEADER, 1);
-    curl_easy_setopt(ci->conn_info->easy, CURLOPT_NOBODY, 1);
-    curl_easy_setopt(ci->conn_info->easy, CURLOPT_NOPROGRESS, 1L);
-
-    ci->mem_chunk.size = 0; // No data at this point
-
-    // Send all data to this function, via the computer's RAM
-    // NOTE: On Windows, 'CURLOPT_WRITEFUNCTION' /must/ be set, otherwise a crash will occur!
-    curl_easy_setopt(ci->conn_info->easy, CURLOPT_WRITEFUNCTION, &curl_write_memory_callback);
-
-    // We pass our 'chunk' struct to the callback function
-    curl_easy_setopt(ci->conn_info->easy, CURLOPT_WRITEDATA, &ci->mem_chunk);
-
-    // A long parameter set to 1 tells the library to follow any Location: header that the server
-    // sends as part of a HTTP header in a 3xx response. The Location: header can specify a relative
-    // or an absolute URL to follow.
-    // https://curl.haxx.se/libcurl/c/CURLOPT_FOLLOWLOCATION.html
-    curl_easy_setopt(ci->conn_info->easy, CURLOPT_FOLLOWLOCATION, 1L);
-
-    // Some servers don't like requests that are made without a user-agent field, so we provide one
-    curl_easy_setopt(ci->conn_info->easy, CURLOPT_USERAGENT, FYREDL_USER_AGENT);
-
-    // The maximum redirection limit goes here
-    curl_easy_setopt(ci->conn_info->easy, CURLOPT_MAXREDIRS, 12L);
-
-    // Enable TCP keep-alive for this transfer
-    // https://curl.haxx.se/libcurl/c/CURLOPT_TCP_KEEPALIVE.html
-    curl_easy_setopt(ci->conn_info->easy, CURLOPT_TCP_KEEPALIVE, 1L);
-    curl_easy_setopt(ci->conn_info->easy, CURLOPT_TCP_KEEPIDLE, 120L); // Keep-alive idle time to 120 seconds
-    curl_easy_setopt(ci->conn_info->easy, CURLOPT_TCP_KEEPINTVL, 60L); // Interval time between keep-alive probes is 60 seconds
-
-    curl_easy_setopt(ci->conn_info->easy, CURLOPT_VERBOSE, 1L);
-    curl_easy_setopt(ci->conn_info->easy, CURLOPT_ERRORBUFFER, ci->conn_info->error);
-    curl_easy_setopt(ci->conn_info->easy, CURLOPT_PRIVATE, ci->conn_info);
-    curl_easy_setopt(ci->conn_info->easy, CURLOPT_LOW_SPEED_TIME, 3L);
-    curl_easy_setopt(ci->conn_info->easy, CURLOPT_LOW_SPEED_LIMIT, 10L);
-
-    ci->file_buf.file_loc = "";
-    return ci;
+    static std::once_flag curl_global_flag;
+    std::call_once(curl_global_flag, []() { curl_global_init(CURL_GLOBAL_DEFAULT); });
+    return;
 }
 
+/**
+ * @brief GekkoFyre::CurlEasy::verifyFileExists checks that the given URL exists upon the web-server, by way of a HEAD
+ * request.
+ * @note The request is made through the shared probing service, so that name resolving, TLS sessions and connections
+ * are all reused from any probes made before it.
+ * @param url The web-address of the file in question
+ */
 GekkoFyre::GkCurl::CurlInfo GekkoFyre::CurlEasy::verifyFileExists(const QString &url)
 {
-    // curl_easy_perform(), to initiate the request and fire any callbacks
-
-    CURLcode curl_res;
     GekkoFyre::GkCurl::CurlInfo info;
-    std::unique_ptr<GekkoFyre::GkCurl::CurlInit> curl_struct(new_easy_handle(url));
-    if (curl_struct->conn_info->easy != nullptr) {
-        curl_res = curl_easy_perform(curl_struct->conn_info->easy);
-        if (curl_res != CURLE_OK) {
-            info.response_code = curl_res;
-            info.effective_url = curl_struct->conn_info->error;
-            return info;
-        } else {
-            // https://curl.haxx.se/libcurl/c/curl_easy_getinfo.html
-            // http://stackoverflow.com/questions/14947821/how-do-i-use-strdup
-            long rescode;
-            char *effec_url;
-            curl_easy_getinfo(curl_struct->conn_info->easy, CURLINFO_RESPONSE_CODE, &rescode);
-            curl_easy_getinfo(curl_struct->conn_info->easy, CURLINFO_EFFECTIVE_URL, &effec_url);
-
-            std::memcpy(&info.response_code, &rescode, sizeof(unsigned long)); // Must be trivially copyable otherwise UB!
-            info.effective_url = effec_url;
-
-            curl_easy_cleanup(curl_struct->conn_info->easy);
-
-            return info;
-        }
+    try {
+        GekkoFyre::GkCurl::CurlInfoExt info_ext = GekkoFyre::GkCurlProbe::instance().probe(url.toStdString()).get();
+        info.response_code = (long)info_ext.response_code;
+        info.effective_url = info_ext.effective_url;
+        return info;
+    } catch (const std::exception &e) {
+        info.effective_url = e.what();
+        info.response_code = -1;
+        return info;
     }
-
-    // curlCleanup(curl_struct);
-    info.effective_url = "";
-    info.response_code = -1;
-    return info;
 }
 
+/**
+ * @brief GekkoFyre::CurlEasy::curlGrabInfo grabs the headers of the given URL, by way of a HEAD request, and returns
+ * the more detailed information to be had from them.
+ * @note The request is made through the shared probing service. Should many URLs need probing at once then it is better
+ * to use GekkoFyre::GkCurlProbe::probe() directly, as each probe need not wait upon the one before it.
+ * @param url The web-address of the file in question
+ */
 GekkoFyre::GkCurl::CurlInfoExt GekkoFyre::CurlEasy::curlGrabInfo(const QString &url)
 {
-    CURLcode curl_res;
-    GekkoFyre::GkCurl::CurlInfoExt info;
-    std::unique_ptr<GekkoFyre::GkCurl::CurlInit> curl_struct(new_easy_handle(url));
-    if (curl_struct->conn_info->easy != nullptr) {
-        curl_res = curl_easy_perform(curl_struct->conn_info->easy);
-        if (curl_res != CURLE_OK) {
-            info.response_code = curl_res;
-            info.effective_url = curl_struct->conn_info->error;
-            info.status_ok = false;
-            info.elapsed = -1;
-            info.content_length = -1;
-            return info;
-        } else {
-            long rescode;
-            double elapsed, content_length;
-            char *effec_url;
-            curl_easy_getinfo(curl_struct->conn_info->easy, CURLINFO_RESPONSE_CODE, &rescode);
-            curl_easy_getinfo(curl_struct->conn_info->easy, CURLINFO_TOTAL_TIME, &elapsed);
-            curl_easy_getinfo(curl_struct->conn_info->easy, CURLINFO_EFFECTIVE_URL, &effec_url);
-            curl_easy_getinfo(curl_struct->conn_info->easy, CURLINFO_CONTENT_LENGTH_DOWNLOAD, &content_length);
-
-            // Must be trivially copyable otherwise UB!
-            std::memcpy(&info.response_code, &rescode, sizeof(unsigned long));
-            std::memcpy(&info.elapsed, &elapsed, sizeof(double));
-            std::memcpy(&info.content_length, &content_length, sizeof(double));
-            info.effective_url = effec_url;
-            // info.status_msg = curl_struct->conn_info->error;
-            info.status_ok = true;
-
-            curl_easy_cleanup(curl_struct->conn_info->easy);
-
-            return info;
-        }
+    try {
+        return GekkoFyre::GkCurlProbe::instance().probe(url.toStdString()).get();
+    } catch (const std::exception &e) {
+        GekkoFyre::GkCurl::CurlInfoExt info;
+        info.response_code = -1;
+        info.effective_url = e.what();
+        info.status_ok = false;
+        info.elapsed = -1;
+        info.content_length = -1;
+        info.accept_ranges = false;
+        return info;
     }
-
-    // curlCleanup(curl_struct);
-    return GekkoFyre::GkCurl::CurlInfoExt();
-}
-
-void GekkoFyre::CurlEasy::curlCleanup(GekkoFyre::GkCurl::CurlInit &curl_init)
-{
-    // curl_easy_cleanup(), to clean up the context
-    // curl_global_cleanup(), to tear down the curl library (once per program)
-
-    curl_easy_cleanup(curl_init.conn_info->easy); // Always cleanup
-    if (!curl_init.mem_chunk.memory.empty()) {
-        curl_init.mem_chunk.memory.clear();
-    }
-
-    curl_init.conn_info->easy = nullptr;
-    curl_init.conn_info->url.clear();
-    return;
-}
-
-size_t GekkoFyre::CurlEasy::curl_write_memory_callback(void *ptr, size_t size, size_t nmemb, void *userp)
-{
-    GekkoFyre::GkCurl::MemoryStruct *mstr = static_cast<GekkoFyre::GkCurl::MemoryStruct *>(userp);
-    size_t realsize = (size * nmemb);
-    mstr->memory.append((char *)ptr, realsize);
-    return realsize;
 }
@@ -59,13 +59,9 @@ public:
     CurlEasy();
     ~CurlEasy();
 
+    static void globalInit();
     static GekkoFyre::GkCurl::CurlInfo verifyFileExists(const QString &url);
     static GekkoFyre::GkCurl::CurlInfoExt curlGrabInfo(const QString &url);
-
-private:
-    static size_t curl_write_memory_callback(void *ptr, size_t size, size_t nmemb, void *userp);
-    static GkCurl::CurlInit *new_easy_handle(const QString &url);
-    static void curlCleanup(GekkoFyre::GkCurl::CurlInit &curl_init);
 };
 }
 
@@ -49,6 +49,11 @@
 #include <random>
 #include <ctime>
 #include <memory>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <map>
+#include <limits>
 #include <QMessageBox>
 
 namespace sys = boost::system;
@@ -57,155 +62,199 @@ namespace fs = boost::filesystem;
 // Global/Static variables... so, so much ugliness :(
 boost::asio::io_service io_service;
 boost::asio::deadline_timer timer(io_service);
+boost::asio::deadline_timer bw_timer(io_service); // Hands out bandwidth for as long as there are connections to hand it to
+bool bw_timer_armed = false;
 std::map<curl_socket_t, boost::asio::ip::tcp::socket *> socket_map;
+std::map<curl_socket_t, int> socket_actions; // The events that libcurl currently wants us to watch for, per socket
+std::unique_ptr<boost::asio::io_service::work> io_work; // Keeps 'io_service' running even when there is nothing to do
+std::thread io_thread;
+std::mutex io_init_mtx; // The slots that set up the event loop are not all called from within the same thread
 
-std::time_t lastTime = 0;
 boost::ptr_unordered_map<std::string, GekkoFyre::GkCurl::CurlInit> GekkoFyre::CurlMulti::eh_vec;
 std::unordered_map<std::string, GekkoFyre::GkCurl::ActiveDownloads> GekkoFyre::CurlMulti::transfer_monitoring;
+std::unordered_map<std::string, std::string> GekkoFyre::CurlMulti::monitor_index;
 GekkoFyre::GkCurl::GlobalInfo *GekkoFyre::CurlMulti::gi;
+std::unique_ptr<GekkoFyre::GkAsyncWriter> GekkoFyre::CurlMulti::disk_writer;
+std::vector<std::string> GekkoFyre::CurlMulti::paused_conns;
+std::vector<CURL *> GekkoFyre::CurlMulti::idle_easy;
 QMutex GekkoFyre::CurlMulti::mutex;
-short GekkoFyre::CurlMulti::active_downloads;
+std::vector<GekkoFyre::GkCurl::QueuedDl> GekkoFyre::CurlMulti::dl_queue;
+std::unordered_map<std::string, std::string> GekkoFyre::CurlMulti::active_dls;
+std::unordered_map<std::string, long> GekkoFyre::CurlMulti::host_active;
+std::unordered_map<std::string, int> GekkoFyre::CurlMulti::dl_priority;
+unsigned long long GekkoFyre::CurlMulti::queue_seq = 0;
+std::unordered_map<std::string, GekkoFyre::GkCurl::HostHealth> GekkoFyre::CurlMulti::host_health;
+GekkoFyre::GkStatRing<GekkoFyre::GkCurl::XferSample, FYREDL_STATS_RING_SIZE> GekkoFyre::CurlMulti::xfer_ring;
 
 GekkoFyre::CurlMulti::CurlMulti()
 {
     setlocale (LC_ALL, "");
     // curl_global_init(CURL_GLOBAL_DEFAULT); // https://curl.haxx.se/libcurl/c/curl_global_init.html
-
-    active_downloads = 0;
 }
 
 GekkoFyre::CurlMulti::~CurlMulti()
 {
     // curl_global_cleanup(); // We're done with libcurl, globally, so clean it up!
-    // curl_multi_cleanup(gi->multi);
+    if (io_work != nullptr) {
+        io_work.reset();
+        io_service.stop();
+    }
+
+    if (io_thread.joinable()) {
+        io_thread.join();
+    }
+
+    // Waits upon anything that has yet to be written out to disk
+    disk_writer.reset();
+
     if (gi != nullptr) {
+        // The multi-handle closes whatever connections it still has cached, so it has to go before the easy handles
+        // and the share they are attached to
+        curl_multi_cleanup(gi->multi);
+        for (auto const &easy: idle_easy) {
+            curl_easy_cleanup(easy);
+        }
+
+        idle_easy.clear();
+        curl_share_cleanup(gi->share);
         delete gi;
+        gi = nullptr;
     }
 }
 
 /**
- * @brief GekkoFyre::CurlMulti::fileStream
- * @note  <https://curl.haxx.se/libcurl/c/multi-single.html>
- *        <https://gist.github.com/clemensg/4960504>
- *        <https://curl.haxx.se/libcurl/c/curl_multi_info_read.html>
- *        <http://stackoverflow.com/questions/24288513/how-to-do-curl-multi-perform-asynchronously-in-c>
- * @param url
- * @param file_loc
- * @return
+ * @brief GekkoFyre::CurlMulti::init_event_loop creates the global multi-handle and starts up the thread that drives
+ * every transfer. Nothing is polled; the thread sleeps within 'io_service' until either a socket becomes ready or a
+ * timeout set by libcurl expires, whereupon 'curl_multi_socket_action()' is called for just that socket.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date   2017-08-06
+ * @note   <https://curl.haxx.se/libcurl/c/asiohiper.html>
+ *         <https://curl.haxx.se/libcurl/c/curl_multi_socket_action.html>
+ *         <http://www.boost.org/doc/libs/1_64_0/doc/html/boost_asio/reference/io_service.html>
  */
-bool GekkoFyre::CurlMulti::fileStream()
+void GekkoFyre::CurlMulti::init_event_loop()
 {
-    CURLMcode multi_res;
-    int repeats = 0;
-    CURLMsg *msg; // For picking up messages with the transfer status
-    int msgs_left = 0; // How many messages are left
-    GekkoFyre::GkCurl::DlStatusMsg status_msg;
-    try {
-        if (gi->multi != nullptr) {
-            multi_res = curl_multi_perform(gi->multi, &gi->still_running);
-            if (multi_res != CURLM_OK) {
-                mcode_or_die(tr("Download file routine: ").toStdString().c_str(), multi_res);
-            }
-
-            // You need to keep calling curl_multi_perform() to make things transfer. If you don't call
-            // it, nothing gets transferred. Everytime you call it, a piece of the transfer is made (if
-            // there's anything to do at the time).
-            // The function returns CURLM_CALL_MULTI_PERFORM only if you should call it again before you
-            // do select(), but you should always keep calling it until the transfer is done. Preferrably
-            // after waiting for action with select().
-            // If you want stuff to happen "in the background", you need to start a new thread and do the
-            // transfer there.
-            while ((gi->still_running > 0 && active_downloads > 0) || (gi->still_running != 0)) {
-                CURLMcode mc; // curl_multi_wait() return code
-                int numfds = 0; // Number of file descriptors
-
-                mc = curl_multi_wait(gi->multi, NULL, 0, CURL_MAX_WAIT_MSECS, &numfds);
-                if (mc != CURLM_OK) {
-                    throw std::runtime_error(tr("curl_multi_wait() failed! Code: %1").arg(QString::number(mc)).toStdString());
-                }
-
-                // 'numfds' being zero means either a timeout or no file-descriptors to wait for. Try
-                // timeout on first occurrence, then assume no file descriptors and no file descriptors to
-                // wait for means wait for 100 milliseconds.
-                if (!numfds) {
-                    repeats++;
-
-                    if (repeats > 1) {
-                        std::this_thread::sleep_for(std::chrono::milliseconds(100)); // Sleep for 100 milliseconds
-                    }
-                } else {
-                    repeats = 0;
-                }
-
-                if (active_downloads > 0) {
-                    curl_multi_perform(gi->multi, &gi->still_running);
-                } else {
+    std::lock_guard<std::mutex> locker(io_init_mtx);
+    if (gi == nullptr) {
+        // Global multi-handle does not exist, so create it
+        gi = new GekkoFyre::GkCurl::GlobalInfo;
+        gi->multi = curl_multi_init(); // Initiate the libcurl session
+        gi->still_running = 0;
+        curl_multi_setopt(gi->multi, CURLMOPT_SOCKETFUNCTION, sock_cb);
+        curl_multi_setopt(gi->multi, CURLMOPT_SOCKETDATA, gi);
+        curl_multi_setopt(gi->multi, CURLMOPT_TIMERFUNCTION, multi_timer_cb);
+        curl_multi_setopt(gi->multi, CURLMOPT_TIMERDATA, gi);
+
+        // Connections are returned to the multi-handle's own cache once a transfer has finished with them, so keep
+        // enough of them around that the next download from the same host skips the DNS, TCP and TLS handshakes
+        // https://curl.haxx.se/libcurl/c/CURLMOPT_MAXCONNECTS.html
+        // https://curl.haxx.se/libcurl/c/CURLMOPT_MAX_HOST_CONNECTIONS.html
+        curl_multi_setopt(gi->multi, CURLMOPT_MAXCONNECTS, FYREDL_CONN_MAX_CACHED);
+        #if LIBCURL_VERSION_NUM >= 0x071e00
+        curl_multi_setopt(gi->multi, CURLMOPT_MAX_HOST_CONNECTIONS, FYREDL_CONN_MAX_HOST_CONNS);
+        #endif
+
+        // TLS sessions are otherwise held by each easy handle, and so would be lost along with it. Every easy handle
+        // is only ever touched from within the event loop's thread, so no locking callbacks are needed.
+        // https://curl.haxx.se/libcurl/c/CURLSHOPT_SHARE.html
+        gi->share = curl_share_init();
+        curl_share_setopt(gi->share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(gi->share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+
+        // HTTP/2 is only ever asked for should the libcurl we are running against have been built with it, as otherwise
+        // the option is refused outright rather than falling back to HTTP/1.1
+        // https://curl.haxx.se/libcurl/c/CURLMOPT_PIPELINING.html
+        // https://curl.haxx.se/libcurl/c/CURLMOPT_MAX_CONCURRENT_STREAMS.html
+        gi->multiplex = false;
+        #if LIBCURL_VERSION_NUM >= 0x072f00
+        if (FYREDL_CONN_HTTP2_MULTIPLEX && (curl_version_info(CURLVERSION_NOW)->features & CURL_VERSION_HTTP2)) {
+            gi->multiplex = true;
+            curl_multi_setopt(gi->multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+            #if LIBCURL_VERSION_NUM >= 0x074300
+            curl_multi_setopt(gi->multi, CURLMOPT_MAX_CONCURRENT_STREAMS, FYREDL_CONN_HTTP2_MAX_STREAMS);
+            #endif
+        }
+        #endif
+
+        // Every transfer that was paused for want of a free buffer is resumed from within the event loop's thread
+        disk_writer.reset(new GekkoFyre::GkAsyncWriter(WRITE_BUFFER_SIZE, WRITE_BUFFER_MAX_COUNT, []() {
+            io_service.post(&resume_paused);
+        }));
+
+        io_work.reset(new boost::asio::io_service::work(io_service));
+        io_thread = std::thread([]() {
+            // An exception thrown from within a handler unwinds out of 'run()', so log it and carry on with the
+            // remaining transfers
+            for (;;) {
+                try {
+                    io_service.run();
                     break;
+                } catch (const std::exception &e) {
+                    std::cerr << e.what() << std::endl;
                 }
-            };
-
-            while ((msg = curl_multi_info_read(gi->multi, &msgs_left))) {
-                if (msg->msg == CURLMSG_DONE) {
-                    std::string ptr_uuid;
-                    GekkoFyre::GkCurl::CurlInit *curl_struct;
-                    for (auto const &entry : eh_vec) {
-                        // http://www.boost.org/doc/libs/1_49_0/libs/ptr_container/doc/ptr_container.html
-                        if (msg->easy_handle == entry.second->conn_info->easy) {
-                            ptr_uuid = entry.first;
-                            curl_struct = &eh_vec[ptr_uuid];
-                            break;
-                        }
-                    }
-
-                    if (ptr_uuid.empty()) {
-                        // Display an error so that we do not read into uninitialized memory!
-                        throw std::runtime_error(tr("Warning, 'ptr_uuid' is empty!").toStdString());
-                    }
-
-                    std::string stat_uuid;
-                    for (auto const &entry : transfer_monitoring) {
-                        if (QString::fromStdString(curl_struct->file_buf.file_loc) == entry.second.file_dest) {
-                            stat_uuid = entry.first;
-                            break;
-                        }
-                    }
+            }
+        });
+    }
 
-                    if (stat_uuid.empty()) {
-                        // Display an error so that we do not read into uninitialized memory!
-                        throw std::runtime_error(tr("Warning, 'stat_uuid' is empty!").toStdString());
-                    }
+    return;
+}
 
-                    double content_length = 0;
-                    curl_easy_getinfo(curl_struct->conn_info->easy, CURLINFO_CONTENT_LENGTH_DOWNLOAD, &content_length);
-                    std::memcpy(&status_msg.content_len, &content_length, sizeof(double));
+/**
+ * @brief GekkoFyre::CurlMulti::resume_paused un-pauses every transfer that had to be paused because the disk could not
+ * keep up with it. Should there still be no buffer free, then the transfer merely pauses itself once again.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date   2017-08-14
+ * @note   <https://curl.haxx.se/libcurl/c/curl_easy_pause.html>
+ */
+void GekkoFyre::CurlMulti::resume_paused()
+{
+    std::vector<std::string> to_resume;
+    to_resume.swap(paused_conns);
+    for (auto const &conn_id: to_resume) {
+        auto conn = eh_vec.find(conn_id);
+        if (conn != eh_vec.end()) {
+            curl_easy_pause(conn->second->conn_info->easy, CURLPAUSE_CONT);
+        }
+    }
 
-                    // The download has either completed successfully or been aborted! Either way, the handle
-                    // is no longer needed.
-                    status_msg.url = QString::fromStdString(curl_struct->conn_info->url);
-                    status_msg.file_loc = curl_struct->prog.file_dest;
-                    curl_multi_remove_handle(gi->multi, curl_struct->conn_info->easy);
-                    curl_easy_cleanup(curl_struct->conn_info->easy);
-                    // curl_multi_cleanup(gi->multi);
+    return;
+}
 
-                    eh_vec.erase(ptr_uuid);
-                    transfer_monitoring.erase(stat_uuid);
-                    --active_downloads;
+/**
+ * @brief GekkoFyre::CurlMulti::bw_tick runs every 'FYREDL_BW_TICK_INTERVAL' milliseconds for as long as there are
+ * connections, from within the event loop's thread. Each connection is kept to its allotted share of the global download
+ * rate by way of 'CURLOPT_MAX_RECV_SPEED_LARGE', whilst the bucket itself is enforced by pausing any connection that
+ * receives data once it has run dry, until it has been topped back up again.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date   2017-08-27
+ * @note   <https://curl.haxx.se/libcurl/c/CURLOPT_MAX_RECV_SPEED_LARGE.html>
+ * @param error Set should the timer have been cancelled.
+ */
+void GekkoFyre::CurlMulti::bw_tick(const boost::system::error_code &error)
+{
+    if (error || eh_vec.empty()) {
+        bw_timer_armed = false;
+        return;
+    }
 
-                    mutex.lock();
-                    routine_singleton::instance()->sendDlFinished(status_msg);
-                    mutex.unlock();
-                    return true;
-                }
-            }
-        } else {
-            throw std::runtime_error(tr("multi-handle is NULL!").toStdString());
+    GekkoFyre::GkBandwidth &bandwidth = GekkoFyre::GkBandwidth::instance();
+    bandwidth.rebalance();
+    for (auto conn = eh_vec.begin(); conn != eh_vec.end(); ++conn) {
+        GekkoFyre::GkCurl::CurlInit *ci = conn->second;
+        const curl_off_t rate = bandwidth.rate(*ci->bw_flow);
+        if (rate != ci->bw_rate) {
+            curl_easy_setopt(ci->conn_info->easy, CURLOPT_MAX_RECV_SPEED_LARGE, rate);
+            ci->bw_rate = rate;
         }
-    } catch (const std::exception &e) {
-        std::cerr << e.what() << std::endl;
-        return false;
     }
 
-    return false;
+    if (!paused_conns.empty() && bandwidth.allow()) {
+        resume_paused();
+    }
+
+    bw_timer.expires_from_now(boost::posix_time::millisec(FYREDL_BW_TICK_INTERVAL));
+    bw_timer.async_wait(&bw_tick);
+    return;
 }
 
 /**
@@ -218,63 +267,643 @@ bool GekkoFyre::CurlMulti::fileStream()
  * @param fileLoc The location of the download on the user's local storage.
  * @param resumeDl Whether a pre-existing download should be resumed that has previously been stopped part-way, failed
  * mid-transfer due to an internet outage, etc.
+ * @param contentLength The file size of the download, as given by the web-server, or zero if unknown.
+ * @param acceptRanges Whether the web-server supports byte-range requests, which is a must for segmented downloads.
+ * @param hashType The type of checksum to work out whilst the download is being written to local storage.
+ * @param mirrors Further URLs of the very same file, which are downloaded from alongside 'url'. May be empty.
+ * @param segments How far along each segment of the download was when it was last saved to the download history, which
+ * is only made use of when resuming a download that has not been started since FyreDL was last restarted. May be empty.
  */
-void GekkoFyre::CurlMulti::recvNewDl(const QString &url, const QString &fileLoc, const bool &resumeDl)
+void GekkoFyre::CurlMulti::recvNewDl(const QString &url, const QString &fileLoc, const bool &resumeDl,
+                                     const double &contentLength, const bool &acceptRanges,
+                                     const GekkoFyre::HashType &hashType, const QStringList &mirrors,
+                                     const std::vector<GekkoFyre::GkCurl::SegmentRange> &segments)
 {
     try {
-        if (gi == nullptr) {
-            // Global multi-handle does not exist, so create it
-            gi = new GekkoFyre::GkCurl::GlobalInfo;
-            gi->multi = curl_multi_init(); // Initiate the libcurl session
-            curl_multi_setopt(gi->multi, CURLMOPT_SOCKETFUNCTION, sock_cb);
-            curl_multi_setopt(gi->multi, CURLMOPT_SOCKETDATA, gi);
-            curl_multi_setopt(gi->multi, CURLMOPT_TIMERFUNCTION, multi_timer_cb);
-            curl_multi_setopt(gi->multi, CURLMOPT_TIMERDATA, gi);
-        }
-
-        std::string stat_uuid;
-        GekkoFyre::GkCurl::ActiveDownloads dl_stat;
-        for (auto const &entry : transfer_monitoring) {
-            if (fileLoc == entry.second.file_dest) {
-                stat_uuid = entry.first;
-                dl_stat = transfer_monitoring[stat_uuid];
-                break;
+        if (fileLoc.isEmpty() || url.isEmpty()) {
+            throw std::invalid_argument(tr("An invalid file location and/or URL has been given!").toStdString());
+        }
+
+        init_event_loop();
+
+        GekkoFyre::GkCurl::QueuedDl dl;
+        dl.url = url;
+        dl.file_loc = fileLoc;
+        dl.resume = resumeDl;
+        dl.content_length = contentLength;
+        dl.accept_ranges = acceptRanges;
+        dl.hash_type = hashType;
+        dl.priority = 0;
+        dl.host = GekkoFyre::GkBandwidth::hostOf(url.toStdString());
+        dl.seq = 0;
+        for (const auto &mirror: mirrors) {
+            dl.mirrors.push_back(mirror.toStdString());
+        }
+
+        dl.segments = segments;
+
+        // The multi-handle (and everything attached to it), along with the queue, is only ever touched from within the
+        // event loop's thread
+        io_service.post([=]() { enqueue_download(dl); });
+    } catch (const std::exception &e) {
+        QMessageBox::warning(nullptr, tr("Error!"), e.what(), QMessageBox::Ok);
+        return;
+    }
+
+    return;
+}
+
+/**
+ * @brief GekkoFyre::CurlMulti::start_download adds the connection(s) for a new or resumed download to the multi-handle,
+ * from within the event loop's thread.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date   2017-08-06
+ * @see GekkoFyre::CurlMulti::recvNewDl()
+ */
+void GekkoFyre::CurlMulti::start_download(const QString &url, const QString &fileLoc, const bool &resumeDl,
+                                          const double &contentLength, const bool &acceptRanges,
+                                          const GekkoFyre::HashType &hashType, const std::vector<std::string> &mirrors,
+                                          const std::vector<GekkoFyre::GkCurl::SegmentRange> &saved_segments)
+{
+    std::string stat_uuid;
+    GekkoFyre::GkCurl::ActiveDownloads dl_stat;
+    auto indexed = monitor_index.find(fileLoc.toStdString());
+    if (indexed != monitor_index.end()) {
+        stat_uuid = indexed->second;
+        dl_stat = transfer_monitoring.at(stat_uuid);
+    } else {
+        stat_uuid = createId();
+        GekkoFyre::GkCurl::ActiveDownloads dl_stat_temp;
+        dl_stat_temp.file_dest = fileLoc;
+        dl_stat_temp.isActive = false;
+        dl_stat_temp.content_length = contentLength;
+        dl_stat_temp.retries = 0;
+        dl_stat_temp.retry_pending = 0;
+        dl_stat_temp.generation = 0;
+        dl_stat_temp.item_key = std::hash<std::string>()(fileLoc.toStdString());
+        transfer_monitoring[stat_uuid] = dl_stat_temp;
+        monitor_index[fileLoc.toStdString()] = stat_uuid;
+        dl_stat = dl_stat_temp;
+    }
+
+    if (!dl_stat.isActive) {
+        // A resumed download is never truncated, no matter what is (or is not) known about how far along it is
+        const bool preallocated = (FYREDL_PREALLOCATE_FILES && contentLength > 0);
+        const bool fresh_start = !resumeDl;
+        if (fresh_start) {
+            if (preallocated && (double)GekkoFyre::CmnRoutines::freeDiskSpace(fileLoc) < contentLength) {
+                throw std::runtime_error(tr("Not enough free disk space for \"%1\"!").arg(fileLoc).toStdString());
             }
+
+            disk_writer->create_file(fileLoc.toStdString(), preallocated ? (curl_off_t)contentLength : 0);
         }
 
-        if (fileLoc.isEmpty() || url.isEmpty()) {
-            throw std::invalid_argument(tr("An invalid file location and/or URL has been given!").toStdString());
+        std::shared_ptr<GekkoFyre::GkCurl::StreamHash> &stream_hash = transfer_monitoring[stat_uuid].stream_hash;
+        if (fresh_start || stream_hash == nullptr || stream_hash->hash_type != hashType) {
+            stream_hash.reset();
+            if (hashType != GekkoFyre::HashType::None && hashType != GekkoFyre::HashType::CannotDetermine) {
+                // Only what is written in order from the very first byte can be added to the checksum as it goes. Should
+                // that not cover the whole file by the end (as with a resumed download, or segments that wrote ahead),
+                // then 'hash_result()' gives nothing back and the file is hashed in full by 'GkHashService' instead.
+                stream_hash = std::make_shared<GekkoFyre::GkCurl::StreamHash>();
+                stream_hash->hash = std::make_shared<QCryptographicHash>(
+                        GekkoFyre::CmnRoutines::convHashType_toAlgo(hashType));
+                stream_hash->hash_type = hashType;
+                stream_hash->hashed_to = 0;
+            }
         }
 
-        if (stat_uuid.empty()) {
-            std::string new_uuid = createId();
-            GekkoFyre::GkCurl::ActiveDownloads dl_stat_temp;
-            dl_stat_temp.file_dest = fileLoc;
-            dl_stat_temp.isActive = false;
-            transfer_monitoring[new_uuid] = dl_stat_temp;
-            dl_stat = dl_stat_temp;
+        // Having been started by hand, the download is given its full number of retries once again, along with every
+        // one of its mirrors
+        transfer_monitoring[stat_uuid].retries = 0;
+        std::vector<std::shared_ptr<GekkoFyre::GkCurl::Mirror>> &dl_mirrors = transfer_monitoring[stat_uuid].mirrors;
+        dl_mirrors.clear();
+        std::vector<std::string> mirror_urls = {url.toStdString()};
+        mirror_urls.insert(mirror_urls.end(), mirrors.begin(), mirrors.end());
+        for (auto const &mirror_url: mirror_urls) {
+            if (mirror_url.empty() || std::any_of(dl_mirrors.begin(), dl_mirrors.end(),
+                                                  [&](const std::shared_ptr<GekkoFyre::GkCurl::Mirror> &m) {
+                                                      return m->url == mirror_url; })) {
+                continue;
+            }
+
+            std::shared_ptr<GekkoFyre::GkCurl::Mirror> mirror = std::make_shared<GekkoFyre::GkCurl::Mirror>();
+            mirror->url = mirror_url;
+            mirror->dlspeed = 0;
+            mirror->conns = 0;
+            mirror->failures = 0;
+            mirror->dead = false;
+            dl_mirrors.push_back(mirror);
         }
 
-        if ((!stat_uuid.empty() && !dl_stat.isActive) || (stat_uuid.empty())) {
-            if (resumeDl) {
-                ++active_downloads;
-                long byte_offset = GekkoFyre::CmnRoutines::getFileSize(fileLoc.toStdString());
-                new_conn(url, fileLoc, gi, byte_offset);
+        if (!fresh_start && dl_stat.segments.empty() && !saved_segments.empty() &&
+                GekkoFyre::CmnRoutines::getFileSize(fileLoc.toStdString()) >= 0) {
+            // Nothing is known of the download since FyreDL was last restarted, so its segments are taken from the
+            // download history instead, so long as they still fit the file as it stands upon the web-server and there
+            // is something left of them to fetch
+            bool saved_ok = true;
+            bool saved_left = false;
+            for (auto const &saved: saved_segments) {
+                if (saved.range_begin < 0 || saved.range_end < saved.range_begin || saved.written < 0 ||
+                        (contentLength > 0 && saved.range_end >= (curl_off_t)contentLength)) {
+                    saved_ok = false;
+                    break;
+                }
+
+                if ((saved.range_begin + saved.written) <= saved.range_end) {
+                    saved_left = true;
+                }
+            }
+
+            if (saved_ok && saved_left) {
+                for (auto const &saved: saved_segments) {
+                    std::shared_ptr<GekkoFyre::GkCurl::CurlSegment> seg = std::make_shared<GekkoFyre::GkCurl::CurlSegment>();
+                    seg->range_begin = saved.range_begin;
+                    seg->range_end = saved.range_end;
+                    seg->received = saved.written;
+                    seg->written = saved.written;
+                    seg->dlspeed = 0;
+                    seg->complete = false;
+                    dl_stat.segments.push_back(seg);
+                }
+
+                transfer_monitoring[stat_uuid].segments = dl_stat.segments;
+            }
+        }
+
+        // Only by splitting the download into segments can more than one mirror be drawn upon at once
+        const curl_off_t seg_count = std::max((curl_off_t)FYREDL_CONN_SEGMENT_COUNT, (curl_off_t)dl_mirrors.size());
+        if (!fresh_start && !dl_stat.segments.empty()) {
+            // Pick up each unfinished segment from where it left off, which is only as far as what truly made it onto
+            // the disk
+            disk_writer->clear_failed(fileLoc.toStdString());
+            for (auto const &seg: dl_stat.segments) {
+                seg->received = seg->written;
+                seg->complete = ((seg->range_begin + seg->written) > seg->range_end);
+                if (!seg->complete) {
+                    std::shared_ptr<GekkoFyre::GkCurl::Mirror> mirror = pick_mirror(stat_uuid);
+                    new_conn((mirror != nullptr) ? QString::fromStdString(mirror->url) : url, fileLoc, gi, stat_uuid,
+                             0L, seg);
+                }
+            }
+        } else if (fresh_start && acceptRanges && seg_count > 1 && contentLength >= FYREDL_CONN_SEGMENT_MIN_SIZE) {
+            new_segmented_conn(url, fileLoc, gi, stat_uuid, contentLength, seg_count);
+        } else if (fresh_start && preallocated) {
+            // A single segment spanning the whole file, so that how much of it has been written is kept track of
+            new_segmented_conn(url, fileLoc, gi, stat_uuid, contentLength, 1);
+        } else if (!fresh_start) {
+            long byte_offset = GekkoFyre::CmnRoutines::getFileSize(fileLoc.toStdString());
+            if (preallocated && acceptRanges && byte_offset >= (long)contentLength) {
+                // Having been reserved up-front, the file's size says nothing about how much of it has been downloaded,
+                // so the whole of it is fetched once more over the top of whatever is there
+                new_segmented_conn(url, fileLoc, gi, stat_uuid, contentLength, 1);
             } else {
-                ++active_downloads;
-                new_conn(url, fileLoc, gi, 0L);
+                new_conn(url, fileLoc, gi, stat_uuid, byte_offset);
             }
+        } else {
+            transfer_monitoring[stat_uuid].segments.clear();
+            new_conn(url, fileLoc, gi, stat_uuid, 0L);
+        }
+
+        // The segments are saved straight away, lest the download be resumed after a restart as though it were a
+        // single, contiguous stream (or with those of an earlier attempt that have since been done away with)
+        save_segments(stat_uuid);
+    }
+
+    return;
+}
+
+/**
+ * @brief GekkoFyre::CurlMulti::enqueue_download puts the given download at the back of the queue, from within the event
+ * loop's thread, and starts it straight away should there be a slot free for it.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date   2017-08-28
+ * @param dl The download in question.
+ * @see GekkoFyre::CurlMulti::promote()
+ */
+void GekkoFyre::CurlMulti::enqueue_download(const GekkoFyre::GkCurl::QueuedDl &dl)
+{
+    const std::string file_loc = dl.file_loc.toStdString();
+    if (active_dls.find(file_loc) != active_dls.end()) {
+        // The download already holds a slot, be it transferring or waiting upon the disk
+        return;
+    }
 
-            fileStream();
+    for (auto &queued: dl_queue) {
+        if (queued.file_loc == dl.file_loc) {
+            // Started once more whilst still waiting, so only the details are brought up to date
+            const int priority = queued.priority;
+            const unsigned long long seq = queued.seq;
+            queued = dl;
+            queued.priority = priority;
+            queued.seq = seq;
+            return;
         }
-    } catch (const std::exception &e) {
-        QMessageBox::warning(nullptr, tr("Error!"), e.what(), QMessageBox::Ok);
+    }
+
+    GekkoFyre::GkCurl::QueuedDl item = dl;
+    item.seq = queue_seq++;
+    auto priority = dl_priority.find(file_loc);
+    if (priority != dl_priority.end()) {
+        item.priority = priority->second;
+    }
+
+    dl_queue.push_back(item);
+    promote();
+    return;
+}
+
+/**
+ * @brief GekkoFyre::CurlMulti::dequeue_download takes the given download back out of the queue, should it still be
+ * waiting there.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date   2017-08-28
+ * @param file_loc The location of the download on the user's local storage.
+ * @return Whether the download was found within the queue.
+ */
+bool GekkoFyre::CurlMulti::dequeue_download(const std::string &file_loc)
+{
+    for (auto it = dl_queue.begin(); it != dl_queue.end(); ++it) {
+        if (it->file_loc.toStdString() == file_loc) {
+            dl_queue.erase(it);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief GekkoFyre::CurlMulti::promote starts as many queued downloads as there are slots free for, whether overall
+ * ('FYREDL_QUEUE_MAX_ACTIVE') or for the host each download is from ('FYREDL_QUEUE_MAX_PER_HOST'). A download that has
+ * to wait upon a busy host does not hold up those behind it from other hosts.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date   2017-08-28
+ * @see GekkoFyre::CurlMulti::queue_before(), GekkoFyre::CurlMulti::release_slot()
+ */
+void GekkoFyre::CurlMulti::promote()
+{
+    while (!dl_queue.empty() && (FYREDL_QUEUE_MAX_ACTIVE <= 0 || (long)active_dls.size() < FYREDL_QUEUE_MAX_ACTIVE)) {
+        auto next = dl_queue.end();
+        for (auto it = dl_queue.begin(); it != dl_queue.end(); ++it) {
+            if (host_tripped(it->host)) {
+                continue;
+            }
+
+            if (FYREDL_QUEUE_MAX_PER_HOST > 0) {
+                auto host = host_active.find(it->host);
+                if (host != host_active.end() && host->second >= FYREDL_QUEUE_MAX_PER_HOST) {
+                    continue;
+                }
+            }
+
+            if (next == dl_queue.end() || queue_before(*it, *next)) {
+                next = it;
+            }
+        }
+
+        if (next == dl_queue.end()) {
+            // Everything that is left is waiting upon a busy host, or one that has been failing of late
+            break;
+        }
+
+        const GekkoFyre::GkCurl::QueuedDl dl = *next;
+        dl_queue.erase(next);
+        active_dls[dl.file_loc.toStdString()] = dl.host;
+        ++host_active[dl.host];
+
+        auto start = [dl]() {
+            if (active_dls.find(dl.file_loc.toStdString()) == active_dls.end()) {
+                // Stopped whilst waiting upon the disk
+                return;
+            }
+
+            try {
+                start_download(dl.url, dl.file_loc, dl.resume, dl.content_length, dl.accept_ranges, dl.hash_type,
+                               dl.mirrors, dl.segments);
+                mutex.lock();
+                routine_singleton::instance()->sendDlStarted(dl.file_loc);
+                mutex.unlock();
+            } catch (const std::exception &e) {
+                // Such as there not being enough free disk space, whereupon the download is handed back to the user
+                // rather than being left queued up forever
+                std::cerr << e.what() << std::endl;
+                release_slot(dl.file_loc.toStdString());
+                report_failure(dl.file_loc.toStdString(), dl.url.toStdString(), CURLE_WRITE_ERROR);
+            }
+        };
+
+        if (dl.resume) {
+            // Whatever was still buffered when the download was stopped has to reach the disk before the download can
+            // pick up from where it left off
+            disk_writer->barrier([=]() { io_service.post(start); });
+        } else {
+            start();
+        }
+    }
+
+    return;
+}
+
+/**
+ * @brief GekkoFyre::CurlMulti::release_slot gives up the slot held by the given download, once it has finished or been
+ * stopped, so that the next one in the queue may take its place.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date   2017-08-28
+ * @param file_loc The location of the download on the user's local storage.
+ */
+void GekkoFyre::CurlMulti::release_slot(const std::string &file_loc)
+{
+    auto active = active_dls.find(file_loc);
+    if (active == active_dls.end()) {
         return;
     }
 
+    auto host = host_active.find(active->second);
+    if (host != host_active.end() && --host->second <= 0) {
+        host_active.erase(host);
+    }
+
+    active_dls.erase(active);
+
+    // The next download is started afresh from the event loop, rather than from within whatever called upon us (such as
+    // whilst messages are still being read off of the multi-handle)
+    io_service.post(&promote);
     return;
 }
 
+/**
+ * @brief GekkoFyre::CurlMulti::report_failure lets the GUI know that the given download has been given up on without
+ * having been received in full, so that it is not taken to be complete. This waits upon whatever of it is still being
+ * written out, so that it may be resumed from where it truly left off.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date   2017-08-30
+ * @param file_loc The location of the download on the user's local storage.
+ * @param url The URL of the download.
+ * @param result Why the download was given up on.
+ */
+void GekkoFyre::CurlMulti::report_failure(const std::string &file_loc, const std::string &url, const CURLcode &result)
+{
+    GekkoFyre::GkCurl::DlStatusMsg status_msg;
+    status_msg.content_len = 0;
+    status_msg.url = QString::fromStdString(url);
+    status_msg.file_loc = file_loc;
+    status_msg.hash_type = GekkoFyre::HashType::None;
+    status_msg.result = result;
+
+    disk_writer->barrier([status_msg]() {
+        mutex.lock();
+        routine_singleton::instance()->sendDlFinished(status_msg);
+        mutex.unlock();
+    });
+
+    return;
+}
+
+/**
+ * @brief GekkoFyre::CurlMulti::queue_before says whether one queued download ought to start before another. A higher
+ * priority always goes first, and those of the same priority go in the order they were queued up in, unless
+ * 'FYREDL_QUEUE_SIZE_AWARE' is set whereupon the smallest go first.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date   2017-08-28
+ */
+bool GekkoFyre::CurlMulti::queue_before(const GekkoFyre::GkCurl::QueuedDl &a, const GekkoFyre::GkCurl::QueuedDl &b)
+{
+    if (a.priority != b.priority) {
+        return (a.priority > b.priority);
+    }
+
+    if (FYREDL_QUEUE_SIZE_AWARE) {
+        // Downloads of an unknown size are taken to be the largest of them all
+        const double a_size = (a.content_length > 0) ? a.content_length : std::numeric_limits<double>::max();
+        const double b_size = (b.content_length > 0) ? b.content_length : std::numeric_limits<double>::max();
+        if (a_size != b_size) {
+            return (a_size < b_size);
+        }
+    }
+
+    return (a.seq < b.seq);
+}
+
+/**
+ * @brief GekkoFyre::CurlMulti::is_transient says whether a failed transfer is worth trying again, such as after a
+ * timeout (which includes falling below 'FYREDL_CONN_LOW_SPEED_CUTOUT'), a dropped connection or a server-side error.
+ * Anything that would only fail the same way once more, such as a missing file or a full disk, is not.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date   2017-08-29
+ * @note   <https://curl.haxx.se/libcurl/c/libcurl-errors.html>
+ *         <https://tools.ietf.org/html/rfc7231#section-6.6>
+ * @param code The result of the transfer, as given by libcurl.
+ * @param resp_code The last response code given by the web-server, if any.
+ */
+bool GekkoFyre::CurlMulti::is_transient(const CURLcode &code, const long &resp_code)
+{
+    switch (code) {
+        case CURLE_COULDNT_RESOLVE_PROXY:
+        case CURLE_COULDNT_RESOLVE_HOST:
+        case CURLE_COULDNT_CONNECT:
+        case CURLE_OPERATION_TIMEDOUT:
+        case CURLE_SSL_CONNECT_ERROR:
+        case CURLE_GOT_NOTHING:
+        case CURLE_SEND_ERROR:
+        case CURLE_RECV_ERROR:
+        case CURLE_PARTIAL_FILE:
+        #if LIBCURL_VERSION_NUM >= 0x072600
+        case CURLE_HTTP2:
+        #endif
+        #if LIBCURL_VERSION_NUM >= 0x073100
+        case CURLE_HTTP2_STREAM:
+        #endif
+            return true;
+        case CURLE_HTTP_RETURNED_ERROR:
+            // Request Timeout, Too Many Requests, and any error on the part of the web-server itself
+            return (resp_code == 408 || resp_code == 429 || resp_code >= 500);
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief GekkoFyre::CurlMulti::host_tripped says whether the given host has failed too many times in a row of late,
+ * whereupon nothing more is attempted from it until 'FYREDL_RETRY_BREAKER_COOLDOWN' has passed.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date   2017-08-29
+ * @note   <https://martinfowler.com/bliki/CircuitBreaker.html>
+ */
+bool GekkoFyre::CurlMulti::host_tripped(const std::string &host)
+{
+    auto health = host_health.find(host);
+    return (health != host_health.end() && health->second.open_until > std::chrono::steady_clock::now());
+}
+
+/**
+ * @brief GekkoFyre::CurlMulti::pick_mirror chooses which of a download's mirrors the next connection ought to fetch from.
+ * Each mirror is expected to give a new connection its measured speed per connection, shared out between those it
+ * already has, and whichever would give the most is chosen. Those yet to be measured are taken to be as fast as the
+ * fastest one that has been, so that every mirror is tried out early on.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date   2017-08-30
+ * @param monitor_id The key of the download in question, within 'GekkoFyre::CurlMulti::transfer_monitoring'.
+ * @param avoid A mirror that is not to be chosen, such as the one that has just failed, if any.
+ * @return The mirror to fetch from, or 'nullptr' should there be none left that are fit for use.
+ */
+std::shared_ptr<GekkoFyre::GkCurl::Mirror> GekkoFyre::CurlMulti::pick_mirror(const std::string &monitor_id,
+                                                                            const std::shared_ptr<GekkoFyre::GkCurl::Mirror> &avoid)
+{
+    const GekkoFyre::GkCurl::ActiveDownloads &monitor = transfer_monitoring.at(monitor_id);
+    double fastest = 1.0;
+    for (auto const &mirror: monitor.mirrors) {
+        fastest = std::max(fastest, mirror->dlspeed);
+    }
+
+    std::shared_ptr<GekkoFyre::GkCurl::Mirror> best;
+    double best_score = 0;
+    for (auto const &mirror: monitor.mirrors) {
+        if (mirror->dead || mirror == avoid || host_tripped(GekkoFyre::GkBandwidth::hostOf(mirror->url))) {
+            continue;
+        }
+
+        const double expected = (mirror->dlspeed > 0) ? mirror->dlspeed : fastest;
+        const double score = (expected / (double)(std::max(mirror->conns, 0) + 1));
+        if (best == nullptr || score > best_score) {
+            best = mirror;
+            best_score = score;
+        }
+    }
+
+    return best;
+}
+
+/**
+ * @brief GekkoFyre::CurlMulti::fail_over counts a failure against the given mirror, giving up on it for the rest of the
+ * download should it have failed for good or 'FYREDL_MIRROR_MAX_FAILURES' times in a row, and then chooses another
+ * mirror for the failed connection to carry on with.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date   2017-08-30
+ * @param monitor_id The key of the download in question, within 'GekkoFyre::CurlMulti::transfer_monitoring'.
+ * @param failed The mirror that the failed connection was fetching from, if known.
+ * @param permanent Whether the failure would only happen once again were the same mirror to be tried, such as with a
+ * missing file.
+ * @return Another mirror to carry on with, or 'nullptr' should there be no other left.
+ */
+std::shared_ptr<GekkoFyre::GkCurl::Mirror> GekkoFyre::CurlMulti::fail_over(const std::string &monitor_id,
+                                                                          const std::shared_ptr<GekkoFyre::GkCurl::Mirror> &failed,
+                                                                          const bool &permanent)
+{
+    if (failed != nullptr) {
+        if (++failed->failures >= FYREDL_MIRROR_MAX_FAILURES || permanent) {
+            failed->dead = true;
+        }
+
+        // Having proven itself unreliable, the mirror's speed is no longer trusted
+        failed->dlspeed = 0;
+    }
+
+    return pick_mirror(monitor_id, failed);
+}
+
+/**
+ * @brief GekkoFyre::CurlMulti::schedule_retry tries the given connection of a download again after a transient failure,
+ * picking up from wherever it left off. Each retry in a row waits twice as long as the one before it, with some random
+ * jitter so that many downloads that failed together do not all come back at once. Should the host have failed
+ * 'FYREDL_RETRY_BREAKER_THRESHOLD' times in a row, then it is left alone until 'FYREDL_RETRY_BREAKER_COOLDOWN' has passed.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date   2017-08-29
+ * @note   <https://www.awsarchitectureblog.com/2015/03/backoff.html>
+ *         <https://curl.haxx.se/libcurl/c/CURLOPT_RESUME_FROM_LARGE.html>
+ *         <https://curl.haxx.se/libcurl/c/CURLINFO_RETRY_AFTER.html>
+ * @param monitor_id The key of the download in question, within 'GekkoFyre::CurlMulti::transfer_monitoring'.
+ * @param url The effective URL of the download.
+ * @param file_loc The location of the download on the user's local storage.
+ * @param segment The byte-range that failed, if the download is a segmented one, which carries on from however much of
+ * it has already been written.
+ * @param file_offset Where to carry on from within the file, should the download not be a segmented one.
+ * @param made_progress Whether the failed connection received anything at all, in which case the count of retries
+ * starts over.
+ * @param retry_after How many seconds the web-server asked us to wait, if it did so.
+ * @return Whether the connection is to be tried again, or the download has run out of retries.
+ */
+bool GekkoFyre::CurlMulti::schedule_retry(const std::string &monitor_id, const std::string &url,
+                                          const std::string &file_loc,
+                                          const std::shared_ptr<GekkoFyre::GkCurl::CurlSegment> &segment,
+                                          const curl_off_t &file_offset, const bool &made_progress,
+                                          const long &retry_after)
+{
+    GekkoFyre::GkCurl::ActiveDownloads &monitor = transfer_monitoring.at(monitor_id);
+    if (made_progress) {
+        monitor.retries = 0;
+    }
+
+    if (monitor.retries >= FYREDL_RETRY_MAX_ATTEMPTS) {
+        std::cerr << tr("Giving up on \"%1\" after %2 retries.").arg(QString::fromStdString(file_loc))
+                .arg(QString::number(monitor.retries)).toStdString() << std::endl;
+        return false;
+    }
+
+    static std::mt19937 rng(std::random_device{}());
+    const int attempt = monitor.retries++;
+    const long ceiling = std::min((long)FYREDL_RETRY_MAX_DELAY, (FYREDL_RETRY_BASE_DELAY << std::min(attempt, 20)));
+    std::uniform_int_distribution<long> jitter((ceiling / 2), ceiling);
+    long delay = std::max(jitter(rng), (retry_after * 1000L));
+
+    const std::string host = GekkoFyre::GkBandwidth::hostOf(url);
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    GekkoFyre::GkCurl::HostHealth &health = host_health[host];
+    if (++health.failures >= FYREDL_RETRY_BREAKER_THRESHOLD && health.open_until <= now) {
+        std::cerr << tr("Host \"%1\" has failed %2 times in a row, leaving it alone for a while.")
+                .arg(QString::fromStdString(host)).arg(QString::number(health.failures)).toStdString() << std::endl;
+        health.open_until = now + std::chrono::milliseconds(FYREDL_RETRY_BREAKER_COOLDOWN);
+
+        // Whatever is queued up from the host is given its chance once the host has been left alone for long enough
+        std::shared_ptr<boost::asio::deadline_timer> reopen = std::make_shared<boost::asio::deadline_timer>(io_service);
+        reopen->expires_from_now(boost::posix_time::millisec(FYREDL_RETRY_BREAKER_COOLDOWN));
+        reopen->async_wait([reopen](const boost::system::error_code &error) {
+            if (!error) {
+                promote();
+            }
+        });
+    }
+
+    if (health.open_until > now) {
+        delay = std::max(delay, (long)std::chrono::duration_cast<std::chrono::milliseconds>(health.open_until - now).count());
+    }
+
+    std::cerr << tr("Trying \"%1\" again in %2 ms (retry %3 of %4).").arg(QString::fromStdString(file_loc))
+            .arg(QString::number(delay)).arg(QString::number(monitor.retries))
+            .arg(QString::number(FYREDL_RETRY_MAX_ATTEMPTS)).toStdString() << std::endl;
+
+    ++monitor.retry_pending;
+    const unsigned long generation = monitor.generation;
+    std::shared_ptr<boost::asio::deadline_timer> timer = std::make_shared<boost::asio::deadline_timer>(io_service);
+    timer->expires_from_now(boost::posix_time::millisec(delay));
+    timer->async_wait([=](const boost::system::error_code &error) {
+        auto retry_monitor = transfer_monitoring.find(monitor_id);
+        if (error || retry_monitor == transfer_monitoring.end() || retry_monitor->second.generation != generation) {
+            // The download has been stopped in the meantime
+            return;
+        }
+
+        --retry_monitor->second.retry_pending;
+        try {
+            new_conn(QString::fromStdString(url), QString::fromStdString(file_loc), gi, monitor_id, file_offset,
+                     segment);
+        } catch (const std::exception &e) {
+            std::cerr << e.what() << std::endl;
+            if (retry_monitor->second.conn_ids.empty() && retry_monitor->second.retry_pending == 0) {
+                // Nothing is left of the download to carry on with, so give up its slot and leave it to be resumed
+                // by hand
+                retry_monitor->second.isActive = false;
+                release_slot(file_loc);
+                report_failure(file_loc, url, CURLE_COULDNT_CONNECT);
+            }
+        }
+
+        Q_UNUSED(timer);
+    });
+
+    return true;
+}
+
 void GekkoFyre::CurlMulti::mcode_or_die(const char *where, CURLMcode code)
 {
     if(CURLM_OK != code) {
@@ -317,57 +946,310 @@ void GekkoFyre::CurlMulti::mcode_or_die(const char *where, CURLMcode code)
 }
 
 /**
- * @brief GekkoFyre::CurlMulti::check_multi_info checks for completed transfers, and removes their easy
+ * @brief GekkoFyre::CurlMulti::acquire_easy hands out an easy handle for a new connection, reusing one that an earlier
+ * connection has finished with where possible.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date   2017-08-26
+ * @note   <https://curl.haxx.se/libcurl/c/curl_easy_reset.html>
+ *         <https://curl.haxx.se/libcurl/c/CURLOPT_SHARE.html>
+ * @return An easy handle with every option at its default, other than being attached to the global share.
+ * @see GekkoFyre::CurlMulti::release_easy()
+ */
+CURL *GekkoFyre::CurlMulti::acquire_easy()
+{
+    CURL *easy = nullptr;
+    if (!idle_easy.empty()) {
+        easy = idle_easy.back();
+        idle_easy.pop_back();
+    } else {
+        easy = curl_easy_init();
+        if (easy == nullptr) {
+            throw std::runtime_error(tr("'curl_easy_init()' failed, exiting!").toStdString());
+        }
+    }
+
+    curl_easy_setopt(easy, CURLOPT_SHARE, gi->share);
+    return easy;
+}
+
+/**
+ * @brief GekkoFyre::CurlMulti::release_easy takes back an easy handle that has been removed from the multi-handle. It
+ * is reset and kept for the next connection to use, unless 'FYREDL_CONN_POOL_SIZE' handles are idle already.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date   2017-08-26
+ * @note   The connection itself has gone back into the multi-handle's cache by now, so it is reused by whichever
+ * handle next asks for the same host, regardless of which handle that happens to be.
+ * @param easy The easy handle in question, which must no longer be attached to the multi-handle.
+ */
+void GekkoFyre::CurlMulti::release_easy(CURL *easy)
+{
+    if (easy == nullptr) {
+        return;
+    }
+
+    if (idle_easy.size() < (size_t)FYREDL_CONN_POOL_SIZE) {
+        curl_easy_reset(easy);
+        idle_easy.push_back(easy);
+    } else {
+        curl_easy_cleanup(easy);
+    }
+
+    return;
+}
+
+/**
+ * @brief GekkoFyre::CurlMulti::check_multi_info checks for completed transfers, and removes their easy handles. A
+ * download is only reported as finished once the last of its segments (if it has any) has come to an end.
  * @note  <https://curl.haxx.se/libcurl/c/asiohiper.html>
+ *        <https://curl.haxx.se/libcurl/c/curl_multi_info_read.html>
  * @param g
  */
 void GekkoFyre::CurlMulti::check_multi_info(GekkoFyre::GkCurl::GlobalInfo *g)
 {
-    char *eff_url;
-    CURLMsg *msg;
-    int msgs_left;
-    GekkoFyre::GkCurl::ConnInfo *conn;
-    CURL *easy;
-    // CURLcode res;
-
-    std::cout << QString("REMAINING: %1\n").arg(QString::number(g->still_running)).toStdString();
-
-    while((msg = curl_multi_info_read(g->multi, &msgs_left))) {
-        if(msg->msg == CURLMSG_DONE) {
-            easy = msg->easy_handle;
-            // res = msg->data.result;
-            curl_easy_getinfo(easy, CURLINFO_PRIVATE, &conn);
-            curl_easy_getinfo(easy, CURLINFO_EFFECTIVE_URL, &eff_url);
-            std::cerr << QString("DONE: %1 => %2\n").arg(eff_url).arg(conn->error).toStdString();
-            curl_multi_remove_handle(g->multi, easy);
-            conn->url.clear();
-            curl_easy_cleanup(easy);
-            delete conn;
+    CURLMsg *msg; // For picking up messages with the transfer status
+    int msgs_left = 0; // How many messages are left
+
+    while ((msg = curl_multi_info_read(g->multi, &msgs_left))) {
+        if (msg->msg == CURLMSG_DONE) {
+            // Should anything below throw before the connection has been done away with, then the easy handle is still
+            // taken off of the multi-handle, rather than being leaked along with everything that it holds onto
+            std::unique_ptr<CURL, std::function<void(CURL *)>> done_easy(msg->easy_handle, [](CURL *easy) {
+                try {
+                    char *done_priv = nullptr;
+                    curl_easy_getinfo(easy, CURLINFO_PRIVATE, &done_priv);
+                    GekkoFyre::GkCurl::CurlInit *done_ci = reinterpret_cast<GekkoFyre::GkCurl::CurlInit *>(done_priv);
+                    if (done_ci != nullptr && eh_vec.find(done_ci->conn_id) != eh_vec.end()) {
+                        del_conn(done_ci->conn_id);
+                    } else {
+                        curl_multi_remove_handle(gi->multi, easy);
+                        curl_easy_cleanup(easy);
+                    }
+                } catch (const std::exception &e) {
+                    std::cerr << e.what() << std::endl;
+                }
+            });
+
+            // Every easy handle carries a pointer back to its own 'CurlInit', so no searching is needed here
+            // https://curl.haxx.se/libcurl/c/CURLINFO_PRIVATE.html
+            char *priv = nullptr;
+            curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &priv);
+            GekkoFyre::GkCurl::CurlInit *curl_struct = reinterpret_cast<GekkoFyre::GkCurl::CurlInit *>(priv);
+            if (curl_struct == nullptr) {
+                // Display an error so that we do not read into uninitialized memory!
+                throw std::runtime_error(tr("Warning, 'ptr_uuid' is empty!").toStdString());
+            }
+
+            const std::string ptr_uuid = curl_struct->conn_id;
+            const std::string stat_uuid = curl_struct->monitor_id;
+            auto monitor = transfer_monitoring.find(stat_uuid);
+            if (monitor == transfer_monitoring.end()) {
+                // Display an error so that we do not read into uninitialized memory!
+                throw std::runtime_error(tr("Warning, 'stat_uuid' is empty!").toStdString());
+            }
+
+            GekkoFyre::GkCurl::DlStatusMsg status_msg;
+            status_msg.hash_type = GekkoFyre::HashType::None;
+            status_msg.result = CURLE_OK;
+            bool xfer_ok = true;
+            bool retry = false;
+            long resp_code = 0;
+            curl_easy_getinfo(msg->easy_handle, CURLINFO_RESPONSE_CODE, &resp_code);
+
+            // Should the local disk have refused the data, then neither the mirror nor the host are to blame for it
+            const bool disk_failed = disk_writer->has_failed(curl_struct->file_buf.fd);
+            if (curl_struct->segment != nullptr) {
+                // A segment aborts its own transfer once its range has been written in full, so a write error is
+                // expected here and is not a failure as such
+                std::shared_ptr<GekkoFyre::GkCurl::CurlSegment> seg = curl_struct->segment;
+                seg->complete = ((seg->range_begin + seg->received) > seg->range_end);
+                seg->dlspeed = 0;
+                if (!seg->complete) {
+                    std::cerr << tr("Segment [%1-%2] of \"%3\" did not complete: %4")
+                            .arg(QString::number(seg->range_begin)).arg(QString::number(seg->range_end))
+                            .arg(monitor->second.file_dest).arg(curl_struct->conn_info->error).toStdString() << std::endl;
+                    retry = (!disk_failed && is_transient(msg->data.result, resp_code));
+                } else if (!disk_failed) {
+                    // Rather than let this connection go idle, have it take over half of whatever the slowest of the
+                    // remaining segments has left to do
+                    steal_segment(ptr_uuid, g);
+                }
+
+                status_msg.content_len = monitor->second.content_length;
+            } else {
+                if (msg->data.result != CURLE_OK) {
+                    std::cerr << curl_struct->conn_info->error << std::endl;
+                    xfer_ok = false;
+                    retry = (!disk_failed && is_transient(msg->data.result, resp_code));
+                }
+
+                double content_length = 0;
+                curl_easy_getinfo(curl_struct->conn_info->easy, CURLINFO_CONTENT_LENGTH_DOWNLOAD, &content_length);
+                std::memcpy(&status_msg.content_len, &content_length, sizeof(double));
+            }
+
+            // Everything needed to try again has to be taken before the connection is freed up below
+            const std::string url = curl_struct->conn_info->url;
+            const std::string host = GekkoFyre::GkBandwidth::hostOf(url);
+            const std::shared_ptr<GekkoFyre::GkCurl::CurlSegment> segment = curl_struct->segment;
+            const std::shared_ptr<GekkoFyre::GkCurl::Mirror> mirror = curl_struct->mirror;
+            const bool failed = ((segment != nullptr) ? !segment->complete : !xfer_ok);
+            const GekkoFyre::GkCurl::FileStream &fs = curl_struct->file_buf;
+            const curl_off_t resume_from = (fs.offset + (curl_off_t)fs.buffer.size());
+            const bool made_progress = (resume_from > fs.start);
+            long retry_after = 0;
+            #if LIBCURL_VERSION_NUM >= 0x074200
+            if (retry) {
+                curl_off_t retry_after_secs = 0;
+                curl_easy_getinfo(msg->easy_handle, CURLINFO_RETRY_AFTER, &retry_after_secs);
+                retry_after = (long)retry_after_secs;
+            }
+            #endif
+
+            if (!retry && !failed) {
+                host_health.erase(host);
+            }
+
+            // The transfer has either completed successfully or been aborted! Either way, the handle is no longer
+            // needed.
+            status_msg.url = QString::fromStdString(url);
+            status_msg.file_loc = curl_struct->prog.file_dest;
+            del_conn(ptr_uuid);
+            done_easy.release();
+
+            if (failed && disk_failed) {
+                // Another mirror would fare no better, so the download is left for the user to resume once they have
+                // seen to the disk
+                status_msg.result = CURLE_WRITE_ERROR;
+            } else if (failed) {
+                status_msg.result = (msg->data.result != CURLE_OK) ? msg->data.result : CURLE_PARTIAL_FILE;
+
+                // Another mirror carries on straight away from the very byte that this one left off at, and only once
+                // there are none left to turn to is the same one tried again after a while
+                std::shared_ptr<GekkoFyre::GkCurl::Mirror> next = fail_over(stat_uuid, mirror, !retry);
+                bool resumed = false;
+                if (next != nullptr) {
+                    std::cerr << tr("Carrying on with \"%1\" from the mirror, \"%2\".")
+                            .arg(QString::fromStdString(status_msg.file_loc))
+                            .arg(QString::fromStdString(next->url)).toStdString() << std::endl;
+                    try {
+                        new_conn(QString::fromStdString(next->url), QString::fromStdString(status_msg.file_loc), g,
+                                 stat_uuid, (segment != nullptr) ? 0L : resume_from, segment);
+                        resumed = true;
+                    } catch (const std::exception &e) {
+                        std::cerr << e.what() << std::endl;
+                    }
+                }
+
+                if (!resumed && retry) {
+                    schedule_retry(stat_uuid, url, status_msg.file_loc, segment, (segment != nullptr) ? 0L : resume_from,
+                                   made_progress, retry_after);
+                }
+            }
+
+            // Only the last connection of a download to finish reports the download as a whole to be finished, and
+            // not whilst any of them are still waiting to be tried again
+            if (monitor->second.conn_ids.empty() && monitor->second.retry_pending == 0) {
+                bool all_segments = true;
+                for (auto const &seg: monitor->second.segments) {
+                    if (!seg->complete) {
+                        all_segments = false;
+                        break;
+                    }
+                }
+
+                if (!all_segments && status_msg.result == CURLE_OK) {
+                    // An earlier segment was given up on, even though this last one finished
+                    status_msg.result = CURLE_PARTIAL_FILE;
+                }
+
+                std::shared_ptr<GekkoFyre::GkCurl::StreamHash> stream_hash;
+                if (status_msg.result == CURLE_OK) {
+                    // There is nothing left to resume, so the segments are done away with from the download history too
+                    stream_hash = monitor->second.stream_hash;
+                    monitor->second.segments.clear();
+                    save_segments(stat_uuid);
+                    monitor_index.erase(monitor->second.file_dest.toStdString());
+                    transfer_monitoring.erase(monitor);
+                } else {
+                    // Keep hold of the segments so that resuming the download only fetches what is still missing
+                    std::cerr << tr("Giving up on \"%1\" for now: %2").arg(QString::fromStdString(status_msg.file_loc))
+                            .arg(curl_easy_strerror(status_msg.result)).toStdString() << std::endl;
+                    monitor->second.isActive = false;
+                    save_segments(stat_uuid, true);
+                }
+
+                release_slot(status_msg.file_loc);
+
+                // The download is only finished as far as anyone else is concerned once it is on disk in full, at which
+                // point its checksum may be finished off, should it have been streamed in full. Otherwise the file is hashed
+                // by the hashing service rather than being read back in on the writer's thread. A download that was
+                // given up on is reported all the same, so that it may be resumed by hand.
+                disk_writer->barrier([status_msg, stream_hash]() mutable {
+                    if (disk_writer->has_failed(status_msg.file_loc) && status_msg.result == CURLE_OK) {
+                        // One of the last buffers to be written out did not make it onto the disk
+                        status_msg.result = CURLE_WRITE_ERROR;
+                    }
+
+                    disk_writer->clear_failed(status_msg.file_loc);
+                    if (stream_hash != nullptr && status_msg.result == CURLE_OK) {
+                        status_msg.checksum = disk_writer->hash_result(status_msg.file_loc, *stream_hash);
+                        status_msg.hash_type = stream_hash->hash_type;
+                    }
+
+                    mutex.lock();
+                    routine_singleton::instance()->sendDlFinished(status_msg);
+                    mutex.unlock();
+                });
+            }
         }
     }
+
+    return;
 }
 
 /**
- * @brief GekkoFyre::CurlMulti::event_cb is called by asio when there is an action on a socket.
+ * @brief GekkoFyre::CurlMulti::event_cb is called by asio when there is an action on a socket. Asio only ever reports
+ * upon a readiness once, so the socket is watched again afterwards if libcurl still wants to know about it.
  * @note  <https://curl.haxx.se/libcurl/c/asiohiper.html>
  * @param g
- * @param tcp_socket
- * @param action
+ * @param s The socket in question.
+ * @param action Whether the socket became readable ('CURL_POLL_IN') or writable ('CURL_POLL_OUT').
+ * @param error Any error reported by asio whilst waiting upon the socket.
  */
-void GekkoFyre::CurlMulti::event_cb(GekkoFyre::GkCurl::GlobalInfo *g, boost::asio::ip::tcp::socket *tcp_socket, int action)
+void GekkoFyre::CurlMulti::event_cb(GekkoFyre::GkCurl::GlobalInfo *g, curl_socket_t s, int action,
+                                    const boost::system::error_code &error)
 {
-    std::cout << QString("event_cb: action=%1\n").arg(QString::number(action)).toStdString();
+    if (error == boost::asio::error::operation_aborted) {
+        // The socket has been closed from underneath us, and its descriptor may already belong to another one
+        return;
+    }
+
+    // The socket may well have been closed, or libcurl may have lost interest in it, whilst we were waiting
+    auto wanted = socket_actions.find(s);
+    if (wanted == socket_actions.end() || socket_map.find(s) == socket_map.end() ||
+            (wanted->second != action && wanted->second != CURL_POLL_INOUT)) {
+        return;
+    }
 
     CURLMcode rc;
-    rc = curl_multi_socket_action(g->multi, tcp_socket->native_handle(), action, &g->still_running);
+    rc = curl_multi_socket_action(g->multi, s, (error ? CURL_CSELECT_ERR : action), &g->still_running);
 
     mcode_or_die("event_cb: curl_multi_socket_action", rc);
     check_multi_info(g);
 
-    if(g->still_running <= 0) {
-        std::cout << QString("last transfer done, kill timeout\n").toStdString();
+    if (g->still_running <= 0) {
         timer.cancel();
     }
+
+    // Keep on watching, provided the socket has neither been closed nor had its action changed in the meantime
+    wanted = socket_actions.find(s);
+    auto it = socket_map.find(s);
+    if (!error && wanted != socket_actions.end() && it != socket_map.end() &&
+            (wanted->second == action || wanted->second == CURL_POLL_INOUT)) {
+        watch_socket(g, s, it->second, action);
+    }
+
+    return;
 }
 
 /**
@@ -388,110 +1270,94 @@ void GekkoFyre::CurlMulti::timer_cb(const boost::system::error_code &error, Gekk
 }
 
 /**
- * @brief GekkoFyre::CurlMulti::multi_timer_cb updates the event timer after curl_multi library calls.
+ * @brief GekkoFyre::CurlMulti::multi_timer_cb updates the event timer after curl_multi library calls. The socket action
+ * is never called from within here directly, as libcurl does not allow for that; a timeout of zero merely expires the
+ * timer straight away instead.
  * @note  <https://curl.haxx.se/libcurl/c/asiohiper.html>
+ *        <https://curl.haxx.se/libcurl/c/CURLMOPT_TIMERFUNCTION.html>
  * @param multi
- * @param timeout_ms
+ * @param timeout_ms The timeout in milliseconds, or '-1' if the timer is to be deleted.
  * @param g
  * @return
  */
 int GekkoFyre::CurlMulti::multi_timer_cb(CURLM *multi, long timeout_ms, GekkoFyre::GkCurl::GlobalInfo *g)
 {
     Q_UNUSED(multi);
-    // std::cout << QString("multi_timer_cb: timeout_ms %1\n").arg(QString::number(timeout_ms)).toStdString();
 
     // Cancel running timer
     timer.cancel();
 
-    if (timeout_ms > 0) {
+    if (timeout_ms >= 0) {
         // Update timer
         timer.expires_from_now(boost::posix_time::millisec(timeout_ms));
         timer.async_wait(boost::bind(&timer_cb, _1, g));
-    } else {
-        // Call timeout function immediately
-        boost::system::error_code error; /*success*/
-        timer_cb(error, g);
     }
 
     return 0;
 }
 
-void GekkoFyre::CurlMulti::remsock(int *f, GekkoFyre::GkCurl::GlobalInfo *g)
+void GekkoFyre::CurlMulti::remsock(curl_socket_t s, GekkoFyre::GkCurl::GlobalInfo *g)
 {
     Q_UNUSED(g);
-    if (f) {
-        free (f);
+    socket_actions.erase(s);
+}
+
+/**
+ * @brief GekkoFyre::CurlMulti::watch_socket asks asio to let us know, just the once, when the given socket becomes
+ * readable or writable.
+ * @note  <http://www.boost.org/doc/libs/1_64_0/doc/html/boost_asio/overview/core/reactor.html>
+ */
+void GekkoFyre::CurlMulti::watch_socket(GekkoFyre::GkCurl::GlobalInfo *g, curl_socket_t s,
+                                        boost::asio::ip::tcp::socket *tcp_socket, int action)
+{
+    if (action == CURL_POLL_IN) {
+        tcp_socket->async_read_some(boost::asio::null_buffers(), boost::bind(&event_cb, g, s, CURL_POLL_IN, _1));
+    } else if (action == CURL_POLL_OUT) {
+        tcp_socket->async_write_some(boost::asio::null_buffers(), boost::bind(&event_cb, g, s, CURL_POLL_OUT, _1));
     }
 }
 
-void GekkoFyre::CurlMulti::setsock(int *fdp, curl_socket_t s, CURL *e, int act, GekkoFyre::GkCurl::GlobalInfo *g)
+void GekkoFyre::CurlMulti::setsock(curl_socket_t s, CURL *e, int act, int oldact, GekkoFyre::GkCurl::GlobalInfo *g)
 {
     Q_UNUSED(e);
-    std::cout << QString("netsock: socket=%1, act=%2\n").arg(QString::number(s)).arg(QString::number(act)).toStdString();
-
     std::map<curl_socket_t, boost::asio::ip::tcp::socket *>::iterator it = socket_map.find(s);
 
     if (it == socket_map.end()) {
-        std::cout << QString("socket %1 is a c-ares socket, ignoring\n").arg(QString::number(s)).toStdString();
+        // This socket was not opened by us (i.e. it belongs to c-ares), so there is nothing to watch
         return;
     }
 
-    boost::asio::ip::tcp::socket * tcp_socket = it->second;
-    *fdp = act;
+    boost::asio::ip::tcp::socket *tcp_socket = it->second;
+    socket_actions[s] = act;
 
-    if (act == CURL_POLL_IN) {
-        std::cout << QString("watching for socket to become readable\n").toStdString();
-        tcp_socket->async_read_some(boost::asio::null_buffers(),
-                                    boost::bind(&event_cb, g, tcp_socket, act));
-    } else if (act == CURL_POLL_OUT) {
-        std::cout << QString("watching for socket to become writable\n").toStdString();
-        tcp_socket->async_write_some(boost::asio::null_buffers(),
-                                     boost::bind(&event_cb, g, tcp_socket, act));
-    } else if (act == CURL_POLL_INOUT) {
-        std::cout << QString("watching for socket to become readable AND writable\n").toStdString();
-        tcp_socket->async_read_some(boost::asio::null_buffers(),
-                                    boost::bind(&event_cb, g, tcp_socket, act));
-        tcp_socket->async_write_some(boost::asio::null_buffers(),
-                                     boost::bind(&event_cb, g, tcp_socket, act));
+    // Only start watching for what was not already being watched, as any pending wait re-arms itself in 'event_cb()'
+    if ((act == CURL_POLL_IN || act == CURL_POLL_INOUT) && oldact != CURL_POLL_IN && oldact != CURL_POLL_INOUT) {
+        watch_socket(g, s, tcp_socket, CURL_POLL_IN);
     }
-}
-
-void GekkoFyre::CurlMulti::addsock(curl_socket_t s, CURL *easy, int action, GekkoFyre::GkCurl::GlobalInfo *g)
-{
-    // fdp is used to store current action
-    int *fdp = (int *) calloc(sizeof(int), 1);
 
-    setsock(fdp, s, easy, action, g);
-    curl_multi_assign(g->multi, s, fdp);
+    if ((act == CURL_POLL_OUT || act == CURL_POLL_INOUT) && oldact != CURL_POLL_OUT && oldact != CURL_POLL_INOUT) {
+        watch_socket(g, s, tcp_socket, CURL_POLL_OUT);
+    }
 }
 
 int GekkoFyre::CurlMulti::sock_cb(CURL *e, curl_socket_t s, int what, void *cbp, void *sockp)
 {
-    std::cout << QString("sock_cb: socket=%1, what=%2\n").arg(QString::number(s)).arg(QString::number(what)).toStdString();
-
+    Q_UNUSED(sockp);
     GekkoFyre::GkCurl::GlobalInfo *g = (GekkoFyre::GkCurl::GlobalInfo*) cbp;
-    int *actionp = (int *) sockp;
-    const char *whatstr[] = { "none", "IN", "OUT", "INOUT", "REMOVE" };
-
-    std::cout << QString("socket callback: s=%1 what=%2\n").arg(QString::number(s)).arg(whatstr[what]).toStdString();
 
     if (what == CURL_POLL_REMOVE) {
-        remsock(actionp, g);
+        remsock(s, g);
     } else {
-        if (!actionp) {
-            std::cout << QString("Adding data: %1\n").arg(whatstr[what]).toStdString();
-            addsock(s, e, what, g);
-        } else {
-            std::cout << QString("Changing action from %1 to %2\n").arg(whatstr[*actionp]).arg(whatstr[what]).toStdString();
-            setsock(actionp, s, e, what, g);
-        }
+        auto wanted = socket_actions.find(s);
+        setsock(s, e, what, (wanted == socket_actions.end()) ? CURL_POLL_NONE : wanted->second, g);
     }
 
     return 0;
 }
 
 /**
- * @brief GekkoFyre::CurlMulti::curl_xferinfo details the progress of the download or upload.
+ * @brief GekkoFyre::CurlMulti::curl_xferinfo details the progress of the download or upload. The statistics are handed
+ * over to the GUI through 'xfer_ring' rather than by way of a signal, so that the event loop never has to wait upon it.
  * @note  <https://curl.haxx.se/libcurl/c/progressfunc.html>
  *        <https://curl.haxx.se/libcurl/c/chkspeed.html>
  * @param p
@@ -505,63 +1371,108 @@ int GekkoFyre::CurlMulti::curl_xferinfo(void *p, curl_off_t dltotal, curl_off_t
 {
     Q_UNUSED(dltotal);
     Q_UNUSED(ultotal);
-    GekkoFyre::GkCurl::CurlProgressPtr *prog = static_cast<GekkoFyre::GkCurl::CurlProgressPtr *>(p);
+    GekkoFyre::GkCurl::CurlInit *ci = static_cast<GekkoFyre::GkCurl::CurlInit *>(p);
+    GekkoFyre::GkCurl::CurlProgressPtr *prog = &ci->prog;
+
+    double dlspeed = 0;
+    double upspeed = 0;
+    curl_easy_getinfo(prog->curl, CURLINFO_SPEED_DOWNLOAD, &dlspeed);
+    curl_easy_getinfo(prog->curl, CURLINFO_SPEED_UPLOAD, &upspeed);
+    if (ci->segment != nullptr) {
+        ci->segment->dlspeed = dlspeed;
+    }
+
+    if (ci->mirror != nullptr && dlnow > 0) {
+        // Having delivered something, the mirror's earlier failures are forgiven
+        GekkoFyre::GkCurl::Mirror &mirror = *ci->mirror;
+        mirror.failures = 0;
+        mirror.dead = false;
+        if (dlspeed > 0) {
+            mirror.dlspeed = (mirror.dlspeed <= 0) ? dlspeed : ((FYREDL_MIRROR_SPEED_SMOOTHING * dlspeed) +
+                    ((1.0 - FYREDL_MIRROR_SPEED_SMOOTHING) * mirror.dlspeed));
+        }
+    }
 
-    /* Under certain circumstances it may be desirable for certain functionality
-       to only run every N seconds, in order to do this the transaction time can
-       be used */
-    std::time_t now = std::time(nullptr);
-    if (now - lastTime < 1) {
+    // Each download is only sampled every so often, no matter how many connections it has
+    auto monitor = transfer_monitoring.find(ci->monitor_id);
+    if (monitor == transfer_monitoring.end()) {
         return 0;
     }
 
-    if (active_downloads < 1) {
-        return -1;
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (!monitor->second.segments.empty() &&
+            (now - monitor->second.last_saved) >= std::chrono::milliseconds(FYREDL_SEGMENT_SAVE_INTERVAL)) {
+        save_segments(ci->monitor_id);
     }
 
-    lastTime = now;
-    double dlspeed = 0;
-    double upspeed = 0;
-    curl_easy_getinfo(prog->curl, CURLINFO_SPEED_DOWNLOAD, &dlspeed);
-    curl_easy_getinfo(prog->curl, CURLINFO_SPEED_UPLOAD, &upspeed);
+    if ((now - monitor->second.last_sample) < std::chrono::milliseconds(FYREDL_STATS_SAMPLE_INTERVAL)) {
+        return 0;
+    }
 
-    GekkoFyre::GkCurl::CurlDlStats dl_stat;
-    dl_stat.dlnow = dlspeed;
-    dl_stat.dltotal = dlnow;
-    dl_stat.upnow = upspeed;
-    dl_stat.uptotal = ulnow;
-    prog->stat.push_back(dl_stat);
+    if (active_dls.empty()) {
+        return -1;
+    }
 
-    mutex.lock();
-    routine_singleton::instance()->sendXferStats(*prog);
-    mutex.unlock();
+    monitor->second.last_sample = now;
+
+    GekkoFyre::GkCurl::XferSample sample;
+    sample.item = monitor->second.item_key;
+    sample.stat.dlnow = dlspeed;
+    sample.stat.dltotal = dlnow;
+    sample.stat.upnow = upspeed;
+    sample.stat.uptotal = ulnow;
+    sample.stat.cur_time = std::time(nullptr);
+
+    if (ci->segment != nullptr) {
+        // Report on the download as a whole rather than just this one segment of it
+        sample.stat.dlnow = 0;
+        sample.stat.dltotal = 0;
+        for (auto const &seg: monitor->second.segments) {
+            sample.stat.dlnow += seg->dlspeed;
+            sample.stat.dltotal += seg->written;
+        }
+    }
 
+    // Never waits upon the GUI. Should it have fallen that far behind, then the sample is dropped as a newer one will
+    // soon follow.
+    xfer_ring.push(sample);
     return 0;
 }
 
+/**
+ * @brief GekkoFyre::CurlMulti::nextXferSample takes the oldest of the transfer statistics that are waiting upon the GUI,
+ * as handed over by curl_xferinfo(). Only ever to be called from the GUI's own thread.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date   2017-08-31
+ * @param sample Where to put the statistics.
+ * @return Whether there were any statistics waiting.
+ * @see MainWindow::drainXferStats()
+ */
+bool GekkoFyre::CurlMulti::nextXferSample(GekkoFyre::GkCurl::XferSample &sample)
+{
+    return xfer_ring.pop(sample);
+}
+
 curl_socket_t GekkoFyre::CurlMulti::opensocket(void *clientp, curlsocktype purpose, curl_sockaddr *address)
 {
     Q_UNUSED(clientp);
     curl_socket_t sockfd = CURL_SOCKET_BAD;
 
-    // Restrict to IPv4
-    if (purpose == CURLSOCKTYPE_IPCXN && address->family == AF_INET) {
+    if (purpose == CURLSOCKTYPE_IPCXN && (address->family == AF_INET || address->family == AF_INET6)) {
         // Create a tcp socket object
         boost::asio::ip::tcp::socket *tcp_socket = new boost::asio::ip::tcp::socket(io_service);
 
         // Open it and get the native handle
         boost::system::error_code ec;
-        tcp_socket->open(boost::asio::ip::tcp::v4(), ec);
+        tcp_socket->open((address->family == AF_INET6) ? boost::asio::ip::tcp::v6() : boost::asio::ip::tcp::v4(), ec);
 
         if (ec) {
-            // An error has occured
-            std::ostringstream oss;
-            oss << std::endl << "Couldn't open socket [" << ec << "][" << ec.message() << "]";
-            std::cerr << QString("ERROR: Returning CURL_SOCKET_BAD to signal error.\n").toStdString();
-            throw std::runtime_error(oss.str());
+            // An error has occured, which we may not throw through libcurl itself
+            std::cerr << QString("Couldn't open socket [%1][%2]").arg(QString::number(ec.value()))
+                    .arg(QString::fromStdString(ec.message())).toStdString() << std::endl;
+            delete tcp_socket;
         } else {
             sockfd = tcp_socket->native_handle();
-            std::cout << QString("Opened socket %1\n").arg(QString::number(sockfd)).toStdString();
 
             // Save it for monitoring
             socket_map.insert(std::pair<curl_socket_t, boost::asio::ip::tcp::socket *>(sockfd, tcp_socket));
@@ -574,8 +1485,6 @@ curl_socket_t GekkoFyre::CurlMulti::opensocket(void *clientp, curlsocktype purpo
 int GekkoFyre::CurlMulti::close_socket(void *clientp, curl_socket_t item)
 {
     Q_UNUSED(clientp);
-    std::cout << QString("close_socket: %1\n").arg(QString::number(item)).toStdString();
-
     std::map<curl_socket_t, boost::asio::ip::tcp::socket *>::iterator it = socket_map.find(item);
 
     if (it != socket_map.end()) {
@@ -583,12 +1492,40 @@ int GekkoFyre::CurlMulti::close_socket(void *clientp, curl_socket_t item)
         socket_map.erase(it);
     }
 
+    socket_actions.erase(item);
     return 0;
 }
 
+/**
+ * @brief GekkoFyre::CurlMulti::count_written gives the disk writer something to call once a buffer of the given segment
+ * has been dealt with, so that the segment's progress only ever counts what has truly made it onto the disk. Whatever
+ * failed to be written is then fetched once more should the download be resumed.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date   2017-09-01
+ * @param segment The byte-range that the buffer belongs to, if any.
+ * @param length The size of the buffer, in bytes.
+ * @return A function to be handed over to 'GekkoFyre::GkAsyncWriter::submit()', or 'nullptr' if there is no segment.
+ */
+std::function<void(const bool &written)> GekkoFyre::CurlMulti::count_written(const std::shared_ptr<GekkoFyre::GkCurl::CurlSegment> &segment,
+                                                                             const curl_off_t &length)
+{
+    if (segment == nullptr || length <= 0) {
+        return nullptr;
+    }
+
+    return [segment, length](const bool &written) {
+        if (written) {
+            // Called from within the writer's thread, whereas the segment is only ever touched from the event loop's
+            io_service.post([segment, length]() { segment->written += length; });
+        }
+    };
+}
+
 /**
  * @brief GekkoFyre::CurlMulti::curl_write_file_callback can be used to download data into a local file
- * on the user's storage.
+ * on the user's storage. The data is only gathered up here, and each buffer is handed over to 'disk_writer' once it is
+ * full, so that the event loop never has to wait upon the disk. Should the disk fall too far behind, the transfer is
+ * paused until a buffer has been freed up again.
  * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
  * @date   2016-11
  * @note   <https://linustechtips.com/main/topic/663949-libcurl-curlopt_writefunction-callback-function-error/>
@@ -598,19 +1535,68 @@ int GekkoFyre::CurlMulti::close_socket(void *clientp, curl_socket_t item)
  *         <https://gist.github.com/rsms/771059>
  *         <http://stackoverflow.com/questions/21126950/asynchronously-writing-to-a-file-in-c-unix>
  *         <https://linux.die.net/man/7/aio>
+ *         <https://curl.haxx.se/libcurl/c/CURLOPT_WRITEFUNCTION.html>
+ *         <https://curl.haxx.se/libcurl/c/curl_easy_pause.html>
  * @param buffer
  * @param size
  * @param nmemb
  * @param userdata
- * @return
+ * @return The amount of bytes taken care of. Anything less than what was given aborts the transfer, which is how a
+ * segment brings itself to a halt once its byte-range has been written in full. 'CURL_WRITEFUNC_PAUSE' has libcurl hold
+ * onto the data and hand it over once more after the transfer has been resumed.
  */
 size_t GekkoFyre::CurlMulti::curl_write_file_callback(char *buffer, size_t size, size_t nmemb, void *userdata)
 {
-    GekkoFyre::GkCurl::FileStream *fs = static_cast<GekkoFyre::GkCurl::FileStream *>(userdata);
+    GekkoFyre::GkCurl::CurlInit *ci = static_cast<GekkoFyre::GkCurl::CurlInit *>(userdata);
+    GekkoFyre::GkCurl::FileStream *fs = &ci->file_buf;
     size_t buf_size = (size * nmemb);
-    fs->astream->write(buffer, (long)buf_size);
-    fs->astream->flush();
-    return buf_size;
+    size_t to_write = buf_size;
+
+    if (ci->segment != nullptr) {
+        long resp_code = 0;
+        curl_easy_getinfo(ci->conn_info->easy, CURLINFO_RESPONSE_CODE, &resp_code);
+        if (resp_code == 200 && fs->start != 0) {
+            // The web-server has ignored our byte-range request and is sending the whole file instead, which would
+            // overwrite the other segments. Were we to start from the beginning anyway, then this is of no concern.
+            return 0;
+        }
+
+        curl_off_t remaining = ci->segment->range_end - (ci->segment->range_begin + ci->segment->received) + 1;
+        if (remaining <= 0) {
+            return 0;
+        }
+
+        to_write = std::min(buf_size, (size_t)remaining);
+    }
+
+    if (!GekkoFyre::GkBandwidth::instance().allow()) {
+        // The global bandwidth has run dry, so nothing is taken from this chunk until it has been topped back up
+        paused_conns.push_back(ci->conn_id);
+        return CURL_WRITEFUNC_PAUSE;
+    }
+
+    if (disk_writer->has_failed(fs->fd)) {
+        std::cerr << tr("Unable to write to \"%1\": %2").arg(QString::fromStdString(fs->file_loc))
+                .arg(QString::fromStdString(disk_writer->error(fs->fd))).toStdString() << std::endl;
+        return 0;
+    }
+
+    if (!fs->buffer.empty() && (fs->buffer.size() + to_write) > WRITE_BUFFER_SIZE) {
+        if (!disk_writer->submit(fs->fd, fs->offset, fs->buffer, false,
+                                 count_written(ci->segment, (curl_off_t)fs->buffer.size()))) {
+            // Nothing has been taken from this chunk as of yet, so libcurl may safely give it to us again later on
+            paused_conns.push_back(ci->conn_id);
+            return CURL_WRITEFUNC_PAUSE;
+        }
+    }
+
+    fs->buffer.insert(fs->buffer.end(), buffer, buffer + to_write);
+    GekkoFyre::GkBandwidth::instance().consume(*ci->bw_flow, to_write);
+    if (ci->segment != nullptr) {
+        ci->segment->received += to_write;
+    }
+
+    return to_write;
 }
 
 /**
@@ -627,62 +1613,99 @@ size_t GekkoFyre::CurlMulti::curl_write_file_callback(char *buffer, size_t size,
  * @param url Refers to the effective URL of the download in question.
  * @param fileLoc Where the download is to be stored on the user's local storage.
  * @param global A global, static struct containing important information about the download's operations.
- * @param data_expected The expected file-size of the download in question.
+ * @param monitor_id The key of the download in question, within 'GekkoFyre::CurlMulti::transfer_monitoring'.
  * @param file_offset An offset, measured in bytes, of where you want to start the download from. Used for resuming
  * downloads that have been paused, for example. Set to '0' to start the transfer from the beginning, and greater than
  * zero (specifically, set to the byte-index) to resume a download.
+ * @param segment The byte-range to fetch, if this connection is but one segment of a download. The file offset is then
+ * taken from the segment itself.
+ * @return The key of the new connection, within 'GekkoFyre::CurlMulti::eh_vec'.
  */
 std::string GekkoFyre::CurlMulti::new_conn(const QString &url, const QString &fileLoc,
                                            GekkoFyre::GkCurl::GlobalInfo *global,
-                                           const curl_off_t &file_offset)
+                                           const std::string &monitor_id,
+                                           const curl_off_t &file_offset,
+                                           const std::shared_ptr<GekkoFyre::GkCurl::CurlSegment> &segment)
 {
-    std::string uuid = createId();
-    GekkoFyre::GkCurl::CurlInit *ci;
-    ci = new GekkoFyre::GkCurl::CurlInit;
+    // The arguments are checked before anything is allocated, so that there is nothing to be handed back should they
+    // turn out to be no good
+    if (fileLoc.isEmpty()) {
+        throw std::invalid_argument(tr("An invalid file location has been given (empty parameter)!").toStdString());
+    }
 
-    ci->conn_info = new GekkoFyre::GkCurl::ConnInfo;
-    ci->conn_info->easy = curl_easy_init();
+    if (segment == nullptr && file_offset < 0) {
+        throw std::invalid_argument(tr("An invalid (negative) file-offset has been given! Value: %1")
+                                            .arg(QString::number(file_offset)).toStdString());
+    }
 
-    if (ci->conn_info->easy == nullptr) {
-        throw std::runtime_error(tr("'curl_easy_init()' failed, exiting!").toStdString());
+    auto monitor = transfer_monitoring.find(monitor_id);
+    if (monitor == transfer_monitoring.end()) {
+        throw std::runtime_error(tr("Warning, 'stat_uuid' is empty!").toStdString());
     }
 
+    std::string uuid = createId();
+    std::unique_ptr<GekkoFyre::GkCurl::CurlInit> ci(new GekkoFyre::GkCurl::CurlInit);
+    ci->conn_id = uuid;
+    ci->monitor_id = monitor_id;
+    ci->segment = segment;
+    ci->file_buf.fd = -1;
+
+    std::unique_ptr<GekkoFyre::GkCurl::ConnInfo> conn_info(new GekkoFyre::GkCurl::ConnInfo);
+    ci->conn_info = conn_info.get();
+    ci->conn_info->easy = acquire_easy();
+    ci->bw_rate = 0;
+
+    // Should anything below throw before 'eh_vec' has taken ownership of the connection, then the easy handle goes back
+    // into the pool and the file is closed once more, rather than either of them being leaked
+    bool added = false;
+    std::unique_ptr<CURL, std::function<void(CURL *)>> easy_guard(ci->conn_info->easy, [&](CURL *easy) {
+        if (added) {
+            curl_multi_remove_handle(global->multi, easy);
+        }
+
+        release_easy(easy);
+        if (ci->bw_flow != nullptr) {
+            GekkoFyre::GkBandwidth::instance().removeFlow(ci->bw_flow);
+        }
+
+        if (ci->file_buf.fd >= 0) {
+            disk_writer->close(ci->file_buf.fd);
+        }
+    });
+
     // Maximum time, in seconds, to allow the connection phase before a timeout occurs
     curl_easy_setopt(ci->conn_info->easy, CURLOPT_CONNECTTIMEOUT, FYREDL_CONN_TIMEOUT);
 
     ci->conn_info->url = url.toStdString();
     curl_easy_setopt(ci->conn_info->easy, CURLOPT_URL, ci->conn_info->url.c_str());
-
-    if (!fileLoc.isEmpty()) {
-        ci->file_buf.file_loc = fileLoc.toStdString();
-    } else {
-        throw std::invalid_argument(tr("An invalid file location has been given (empty parameter)!").toStdString());
-    }
+    ci->file_buf.file_loc = fileLoc.toStdString();
 
     // Initialize these variables, even if they're not used... as it generates spurious errors otherwise.
     ci->mem_chunk.memory = "";
     ci->mem_chunk.size = 0;
 
-    // http://stackoverflow.com/questions/18031357/why-the-constructor-of-stdostream-is-protected
-    // TODO: Fix the memory leak hereinafter!
-    ci->file_buf.astream = std::make_shared<std::ofstream>();
-    if (file_offset == 0 && ci->file_buf.astream != nullptr) {
-        ci->file_buf.astream->open(ci->file_buf.file_loc, std::ofstream::out | std::ios::app | std::ios::binary);
-    } else if (file_offset > 0 && ci->file_buf.astream != nullptr) {
-        ci->file_buf.astream->open(ci->file_buf.file_loc, std::ofstream::out | std::ios::app | std::ios::ate | std::ios::binary);
-    } else {
-        throw std::invalid_argument(tr("An invalid (negative) file-offset has been given! Value: %1")
-                                            .arg(QString::number(file_offset)).toStdString());
-    }
+    // Every write is made at an explicit offset, so segments may all share the one file without getting in the way of
+    // each other
+    ci->file_buf.offset = (segment != nullptr) ? (segment->range_begin + segment->received) : file_offset;
+
+    // The file has already been created (and truncated, if need be) by 'start_download()'
+    ci->file_buf.start = ci->file_buf.offset;
+    ci->file_buf.fd = disk_writer->open(ci->file_buf.file_loc, false, monitor->second.stream_hash);
+    ci->file_buf.buffer.reserve(WRITE_BUFFER_SIZE);
 
     // Send all data to this function, via file streaming
     // NOTE: On Windows, 'CURLOPT_WRITEFUNCTION' /must/ be set, otherwise a crash will occur!
     curl_easy_setopt(ci->conn_info->easy, CURLOPT_WRITEFUNCTION, &curl_write_file_callback);
 
     // We pass our 'chunk' struct to the callback function
-    curl_easy_setopt(ci->conn_info->easy, CURLOPT_WRITEDATA, &ci->file_buf);
-
-    if (file_offset > 0) {
+    curl_easy_setopt(ci->conn_info->easy, CURLOPT_WRITEDATA, ci.get());
+
+    if (segment != nullptr) {
+        // https://curl.haxx.se/libcurl/c/CURLOPT_RANGE.html
+        std::ostringstream range;
+        range << (segment->range_begin + segment->received) << "-" << segment->range_end;
+        curl_easy_setopt(ci->conn_info->easy, CURLOPT_RANGE, range.str().c_str());
+    } else if (file_offset > 0) {
         // This is for resuming transfers, when given the correct byte-offset, otherwise set to '0' for new transfers
         curl_easy_setopt(ci->conn_info->easy, CURLOPT_RESUME_FROM_LARGE, file_offset);
     }
@@ -709,7 +1732,7 @@ std::string GekkoFyre::CurlMulti::new_conn(const QString &url, const QString &fi
     curl_easy_setopt(ci->conn_info->easy, CURLOPT_XFERINFOFUNCTION, &GekkoFyre::CurlMulti::curl_xferinfo);
     // Pass the struct pointer into the xferinfo function, but note that this is an
     // alias to CURLOPT_PROGRESSDATA
-    curl_easy_setopt(ci->conn_info->easy, CURLOPT_XFERINFODATA, &ci->prog);
+    curl_easy_setopt(ci->conn_info->easy, CURLOPT_XFERINFODATA, ci.get());
 
     #else
     #error "Libcurl needs to be of version 7.32.0 or later! Certain features are missing otherwise..."
@@ -727,6 +1750,11 @@ std::string GekkoFyre::CurlMulti::new_conn(const QString &url, const QString &fi
     // The maximum redirection limit goes here
     curl_easy_setopt(ci->conn_info->easy, CURLOPT_MAXREDIRS, 12L);
 
+    // An error page is not written out to disk as though it were the file itself, and its response code is kept so that
+    // the failure may be told apart from one that is worth trying again
+    // https://curl.haxx.se/libcurl/c/CURLOPT_FAILONERROR.html
+    curl_easy_setopt(ci->conn_info->easy, CURLOPT_FAILONERROR, 1L);
+
     // Enable TCP keep-alive for this transfer
     // https://curl.haxx.se/libcurl/c/CURLOPT_TCP_KEEPALIVE.html
     curl_easy_setopt(ci->conn_info->easy, CURLOPT_TCP_KEEPALIVE, 1L);
@@ -735,7 +1763,7 @@ std::string GekkoFyre::CurlMulti::new_conn(const QString &url, const QString &fi
 
     curl_easy_setopt(ci->conn_info->easy, CURLOPT_VERBOSE, FYREDL_LIBCURL_VERBOSE);
     curl_easy_setopt(ci->conn_info->easy, CURLOPT_ERRORBUFFER, ci->conn_info->error);
-    curl_easy_setopt(ci->conn_info->easy, CURLOPT_PRIVATE, ci->conn_info);
+    curl_easy_setopt(ci->conn_info->easy, CURLOPT_PRIVATE, ci.get());
     curl_easy_setopt(ci->conn_info->easy, CURLOPT_LOW_SPEED_TIME, FYREDL_CONN_LOW_SPEED_TIME);
     curl_easy_setopt(ci->conn_info->easy, CURLOPT_LOW_SPEED_LIMIT, FYREDL_CONN_LOW_SPEED_CUTOUT);
 
@@ -745,27 +1773,212 @@ std::string GekkoFyre::CurlMulti::new_conn(const QString &url, const QString &fi
     // Call this function to close a socket
     curl_easy_setopt(ci->conn_info->easy, CURLOPT_CLOSESOCKETFUNCTION, close_socket);
 
+    #if LIBCURL_VERSION_NUM >= 0x072f00
+    if (global->multiplex) {
+        // HTTP/2 is negotiated by way of TLS, and so plain 'http://' (as well as any web-server that does not offer it)
+        // carries on with HTTP/1.1. Rather than open up a connection of its own, the transfer waits to see whether
+        // one that is already being made to the same host can be multiplexed over.
+        // https://curl.haxx.se/libcurl/c/CURLOPT_HTTP_VERSION.html
+        // https://curl.haxx.se/libcurl/c/CURLOPT_PIPEWAIT.html
+        curl_easy_setopt(ci->conn_info->easy, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+        curl_easy_setopt(ci->conn_info->easy, CURLOPT_PIPEWAIT, 1L);
+    }
+    #endif
+
+    // Every connection of a download shares in the same per-download limit and weight
+    ci->bw_flow = GekkoFyre::GkBandwidth::instance().addFlow(fileLoc.toStdString(),
+                                                            GekkoFyre::GkBandwidth::hostOf(ci->conn_info->url));
+
     std::cout << QString("Adding easy to multi (%1)\n").arg(url).toStdString();
     ci->conn_info->curl_res = curl_multi_add_handle(global->multi, ci->conn_info->easy);
+    added = (ci->conn_info->curl_res == CURLM_OK);
     mcode_or_die("new_conn: curl_multi_add_handle", ci->conn_info->curl_res);
 
-    std::string stat_uuid;
-    for (auto const &entry : transfer_monitoring) {
-        if (fileLoc == entry.second.file_dest) {
-            stat_uuid = entry.first;
+    // Whichever mirror the URL belongs to has this connection counted against it, so that further segments are spread
+    // out across the others
+    for (auto const &mirror: monitor->second.mirrors) {
+        if (mirror->url == ci->conn_info->url) {
+            ci->mirror = mirror;
+            ++mirror->conns;
             break;
         }
     }
 
-    if (stat_uuid.empty()) {
-        throw std::runtime_error(tr("Warning, 'stat_uuid' is empty!").toStdString());
+    // The container takes ownership of 'ci' from here on, along with the easy handle and file that it holds onto
+    easy_guard.release();
+    conn_info.release();
+    eh_vec.insert(uuid, ci.release());
+    monitor->second.isActive = true;
+    monitor->second.conn_ids.push_back(uuid);
+
+    if (!bw_timer_armed) {
+        bw_timer_armed = true;
+        bw_timer.expires_from_now(boost::posix_time::millisec(FYREDL_BW_TICK_INTERVAL));
+        bw_timer.async_wait(&bw_tick);
     }
 
-    transfer_monitoring[stat_uuid].isActive = true;
-    eh_vec[uuid] = *ci;
     return uuid;
 }
 
+/**
+ * @brief GekkoFyre::CurlMulti::new_segmented_conn splits a download into the given number of byte-ranges of roughly
+ * equal size, and instantiates a new connection for each one of them so that they may all transfer in parallel.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date   2017-08-02
+ * @note   <https://curl.haxx.se/libcurl/c/CURLOPT_RANGE.html>
+ *         <https://tools.ietf.org/html/rfc7233>
+ * @param url Refers to the effective URL of the download in question.
+ * @param fileLoc Where the download is to be stored on the user's local storage.
+ * @param global A global, static struct containing important information about the download's operations.
+ * @param monitor_id The key of the download in question, within 'GekkoFyre::CurlMulti::transfer_monitoring'.
+ * @param content_length The file size of the download, as given by the web-server.
+ * @param seg_count How many segments to split the download into, which is usually 'FYREDL_CONN_SEGMENT_COUNT'.
+ */
+void GekkoFyre::CurlMulti::new_segmented_conn(const QString &url, const QString &fileLoc,
+                                              GekkoFyre::GkCurl::GlobalInfo *global, const std::string &monitor_id,
+                                              const double &content_length, const curl_off_t &seg_count)
+{
+    const curl_off_t total = (curl_off_t)content_length;
+    const curl_off_t seg_size = (total / seg_count);
+    if (seg_size < 1) {
+        throw std::invalid_argument(tr("Unable to split download, \"%1\", into segments!").arg(fileLoc).toStdString());
+    }
+
+    GekkoFyre::GkCurl::ActiveDownloads &monitor = transfer_monitoring.at(monitor_id);
+    monitor.segments.clear();
+    for (curl_off_t i = 0; i < seg_count; ++i) {
+        std::shared_ptr<GekkoFyre::GkCurl::CurlSegment> seg = std::make_shared<GekkoFyre::GkCurl::CurlSegment>();
+        seg->range_begin = (i * seg_size);
+        seg->range_end = (i == (seg_count - 1)) ? (total - 1) : (((i + 1) * seg_size) - 1);
+        seg->received = 0;
+        seg->written = 0;
+        seg->dlspeed = 0;
+        seg->complete = false;
+        monitor.segments.push_back(seg);
+    }
+
+    for (auto const &seg: monitor.segments) {
+        // Each segment goes to whichever mirror is expected to do the most with it, given how many connections it
+        // already has
+        std::shared_ptr<GekkoFyre::GkCurl::Mirror> mirror = pick_mirror(monitor_id);
+        new_conn((mirror != nullptr) ? QString::fromStdString(mirror->url) : url, fileLoc, global, monitor_id, 0L, seg);
+    }
+
+    return;
+}
+
+/**
+ * @brief GekkoFyre::CurlMulti::steal_segment is called when a segment has finished its byte-range, so that the now
+ * idle connection may split the live segment which is expected to finish last (i.e. the most bytes left to transfer at
+ * the slowest speed) and take over the back half of its range. This way every connection of a download finishes at
+ * roughly the same time, instead of the whole download waiting upon a single, slow tail.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date   2017-08-04
+ * @param conn_id The key of the connection that has just finished its own segment, within
+ * 'GekkoFyre::CurlMulti::eh_vec'.
+ * @param global A global, static struct containing important information about the download's operations.
+ * @return Whether a new connection was made to fetch part of another segment's byte-range.
+ */
+bool GekkoFyre::CurlMulti::steal_segment(const std::string &conn_id, GekkoFyre::GkCurl::GlobalInfo *global)
+{
+    const GekkoFyre::GkCurl::CurlInit &idle = eh_vec.at(conn_id);
+    GekkoFyre::GkCurl::ActiveDownloads &monitor = transfer_monitoring.at(idle.monitor_id);
+    std::shared_ptr<GekkoFyre::GkCurl::CurlSegment> victim;
+    double victim_eta = 0;
+    for (auto const &live_id : monitor.conn_ids) {
+        const std::shared_ptr<GekkoFyre::GkCurl::CurlSegment> &seg = eh_vec.at(live_id).segment;
+        if (live_id == conn_id || seg == nullptr) {
+            continue;
+        }
+
+        curl_off_t remaining = seg->range_end - (seg->range_begin + seg->received) + 1;
+        if (remaining < (FYREDL_CONN_SEGMENT_MIN_STEAL * 2)) {
+            continue;
+        }
+
+        // Segments that have yet to report a speed are treated as crawling along at a byte per second
+        double eta = ((double)remaining / std::max(seg->dlspeed, 1.0));
+        if (eta > victim_eta) {
+            victim = seg;
+            victim_eta = eta;
+        }
+    }
+
+    if (victim == nullptr) {
+        return false;
+    }
+
+    // The victim's write callback never writes past its (now reduced) 'range_end', and brings its own transfer to a
+    // halt once that has been reached
+    const curl_off_t next_byte = victim->range_begin + victim->received;
+    const curl_off_t split = next_byte + ((victim->range_end - next_byte + 1) / 2);
+
+    std::shared_ptr<GekkoFyre::GkCurl::CurlSegment> seg = std::make_shared<GekkoFyre::GkCurl::CurlSegment>();
+    seg->range_begin = split;
+    seg->range_end = victim->range_end;
+    seg->received = 0;
+    seg->written = 0;
+    seg->dlspeed = 0;
+    seg->complete = false;
+    victim->range_end = (split - 1);
+
+    monitor.segments.push_back(seg);
+
+    // The idle connection is about to go, so the range it takes over is fetched from whichever mirror has proven to be
+    // the fastest, rather than necessarily the one it was fetching from
+    if (idle.mirror != nullptr) {
+        --idle.mirror->conns;
+    }
+
+    std::shared_ptr<GekkoFyre::GkCurl::Mirror> mirror = pick_mirror(idle.monitor_id);
+    if (idle.mirror != nullptr) {
+        ++idle.mirror->conns;
+    }
+
+    new_conn(QString::fromStdString((mirror != nullptr) ? mirror->url : idle.conn_info->url),
+             QString::fromStdString(idle.file_buf.file_loc), global, idle.monitor_id, 0L, seg);
+    return true;
+}
+
+/**
+ * @brief GekkoFyre::CurlMulti::del_conn removes the given connection from the multi-handle and frees everything that
+ * is associated with it. Whatever it still has buffered is handed over to the disk writer, which then closes the file
+ * once it has been written out.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date   2017-08-02
+ * @param conn_id The key of the connection in question, within 'GekkoFyre::CurlMulti::eh_vec'.
+ */
+void GekkoFyre::CurlMulti::del_conn(const std::string &conn_id)
+{
+    auto conn = eh_vec.find(conn_id);
+    if (conn != eh_vec.end()) {
+        auto monitor = transfer_monitoring.find(conn->second->monitor_id);
+        if (monitor != transfer_monitoring.end()) {
+            std::vector<std::string> &conn_ids = monitor->second.conn_ids;
+            conn_ids.erase(std::remove(conn_ids.begin(), conn_ids.end(), conn_id), conn_ids.end());
+        }
+
+        curl_multi_remove_handle(gi->multi, conn->second->conn_info->easy);
+        release_easy(conn->second->conn_info->easy);
+        GekkoFyre::GkBandwidth::instance().removeFlow(conn->second->bw_flow);
+        if (conn->second->mirror != nullptr) {
+            --conn->second->mirror->conns;
+        }
+
+        GekkoFyre::GkCurl::FileStream &fs = conn->second->file_buf;
+        if (fs.fd >= 0) {
+            disk_writer->submit(fs.fd, fs.offset, fs.buffer, true,
+                                count_written(conn->second->segment, (curl_off_t)fs.buffer.size()));
+            disk_writer->close(fs.fd);
+        }
+
+        delete conn->second->conn_info;
+        eh_vec.erase(conn);
+    }
+
+    return;
+}
+
 /**
  * @brief GekkoFyre::CurlMulti::createUUID generates a unique UUID and returns the value.
  * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
@@ -794,8 +2007,8 @@ std::string GekkoFyre::CurlMulti::createId()
 }
 
 /**
- * @brief GekkoFyre::CurlMulti::recvStopDl stops a download via GekkoFyre::CurlMulti::fileStream by
- * intermittently looking at a variable that contains the status information.
+ * @brief GekkoFyre::CurlMulti::recvStopDl stops a download by removing each of its connections from the multi-handle,
+ * which is done from within the event loop's thread.
  * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
  * @date 2016-11-09
  * @note <https://curl.haxx.se/libcurl/c/curl_multi_remove_handle.html>
@@ -804,38 +2017,144 @@ std::string GekkoFyre::CurlMulti::createId()
  */
 void GekkoFyre::CurlMulti::recvStopDl(const QString &fileLoc)
 {
-    std::string ptr_uuid;
-    GekkoFyre::GkCurl::CurlInit *curl_struct;
-    for (auto const &entry : eh_vec) {
-        // http://www.boost.org/doc/libs/1_49_0/libs/ptr_container/doc/ptr_container.html
-        if (fileLoc.toStdString() == entry.second->file_buf.file_loc) {
-            ptr_uuid = entry.first;
-            curl_struct = &eh_vec[ptr_uuid];
-            break;
+    // Everything that is looked at in order to stop the download belongs to the event loop's thread, and this slot is
+    // not necessarily called from within it
+    init_event_loop();
+    io_service.post([=]() {
+        try {
+            stop_download(fileLoc);
+        } catch (const std::exception &e) {
+            std::cerr << e.what() << std::endl;
+        }
+    });
+
+    return;
+}
+
+/**
+ * @brief GekkoFyre::CurlMulti::recvDlPriority sets the priority of the given download within the queue. Downloads of a
+ * higher priority are started before any others that are waiting, though nothing that is already transferring is
+ * stopped to make way for them.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-28
+ * @param fileLoc The location of the download on the user's local storage.
+ * @param priority The priority in question, where every download starts out at zero.
+ */
+void GekkoFyre::CurlMulti::recvDlPriority(const QString &fileLoc, const int &priority)
+{
+    init_event_loop();
+    io_service.post([=]() {
+        dl_priority[fileLoc.toStdString()] = priority;
+        for (auto &queued: dl_queue) {
+            if (queued.file_loc == fileLoc) {
+                queued.priority = priority;
+            }
         }
+    });
+
+    return;
+}
+
+/**
+ * @brief GekkoFyre::CurlMulti::stop_download does the actual stopping of a download on behalf of recvStopDl().
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-06
+ * @param fileLoc
+ * @see GekkoFyre::CurlMulti::recvStopDl()
+ */
+void GekkoFyre::CurlMulti::stop_download(const QString &fileLoc)
+{
+    if (dequeue_download(fileLoc.toStdString())) {
+        // It had yet to start, so there is nothing more to stop
+        return;
     }
 
     std::string stat_uuid;
     GekkoFyre::GkCurl::ActiveDownloads dl_stat;
-    for (auto const &entry : transfer_monitoring) {
-        if (fileLoc == entry.second.file_dest) {
-            stat_uuid = entry.first;
-            dl_stat = transfer_monitoring[stat_uuid];
-            break;
+    auto indexed = monitor_index.find(fileLoc.toStdString());
+    if (indexed != monitor_index.end()) {
+        stat_uuid = indexed->second;
+        dl_stat = transfer_monitoring.at(stat_uuid);
+    }
+
+    // A segmented download has more than the one connection to bring to a halt
+    const std::vector<std::string> ptr_uuids = dl_stat.conn_ids;
+    if (ptr_uuids.empty() && active_dls.find(fileLoc.toStdString()) != active_dls.end()) {
+        // Its slot is held whilst it waits upon the disk to catch up before resuming, or whilst it waits to be tried
+        // again, and giving that up is enough for it not to carry on at all
+        if (!stat_uuid.empty()) {
+            GekkoFyre::GkCurl::ActiveDownloads &monitor = transfer_monitoring.at(stat_uuid);
+            monitor.isActive = false;
+            monitor.retry_pending = 0;
+            ++monitor.generation;
         }
+
+        release_slot(fileLoc.toStdString());
+        return;
     }
 
-    if (ptr_uuid.empty() || stat_uuid.empty()) {
+    if (ptr_uuids.empty() || stat_uuid.empty()) {
         // Display an error so that we do not read into uninitialized memory!
         throw std::runtime_error(tr("Warning, either 'ptr_uuid' or 'stat_uuid' is empty!").toStdString());
     }
 
     if (dl_stat.isActive) {
-        transfer_monitoring[stat_uuid].isActive = false;
-        --active_downloads;
+        GekkoFyre::GkCurl::ActiveDownloads &monitor = transfer_monitoring.at(stat_uuid);
+        monitor.isActive = false;
+        monitor.retry_pending = 0;
+        ++monitor.generation;
+        release_slot(fileLoc.toStdString());
         // https://curl.haxx.se/libcurl/c/curl_multi_add_handle.html
-        curl_multi_remove_handle(gi->multi, curl_struct->conn_info->easy);
+        // The segments themselves are kept within 'transfer_monitoring', so that they may be resumed later on
+        for (auto const &ptr_uuid: ptr_uuids) {
+            del_conn(ptr_uuid);
+        }
+
+        save_segments(stat_uuid, true);
+    }
+
+    return;
+}
+
+/**
+ * @brief GekkoFyre::CurlMulti::save_segments hands how far along each segment of the given download is over to the GUI,
+ * so that it is kept within the download's record and may be resumed from there even after FyreDL has been restarted.
+ * Only what is known to have been written to local storage is counted, so the download is never picked up from any
+ * further along than it truly is.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-09-02
+ * @param monitor_id The key of the download in question, within 'transfer_monitoring'.
+ * @param settle Whether to first wait upon whatever of the download is still being written out, as when it has just
+ * been stopped or given up on.
+ */
+void GekkoFyre::CurlMulti::save_segments(const std::string &monitor_id, const bool &settle)
+{
+    if (settle) {
+        // Each buffer is counted towards its segment from within the event loop once it has been written, and those
+        // still being written are all counted by the time this makes its way back around
+        disk_writer->barrier([monitor_id]() { io_service.post([monitor_id]() { save_segments(monitor_id); }); });
+        return;
+    }
+
+    auto monitor = transfer_monitoring.find(monitor_id);
+    if (monitor == transfer_monitoring.end()) {
+        // The download has since finished, whereupon its segments were already done away with
+        return;
     }
 
+    std::vector<GekkoFyre::GkCurl::SegmentRange> segments;
+    segments.reserve(monitor->second.segments.size());
+    for (auto const &seg: monitor->second.segments) {
+        GekkoFyre::GkCurl::SegmentRange saved;
+        saved.range_begin = seg->range_begin;
+        saved.range_end = seg->range_end;
+        saved.written = seg->written;
+        segments.push_back(saved);
+    }
+
+    monitor->second.last_saved = std::chrono::steady_clock::now();
+    mutex.lock();
+    routine_singleton::instance()->sendDlSegments(monitor->second.file_dest, segments);
+    mutex.unlock();
     return;
 }
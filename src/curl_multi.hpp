@@ -44,6 +44,9 @@
 #define FYREDL_CURLMULTI_HPP
 
 #include "default_var.hpp"
+#include "async_writer.hpp"
+#include "bandwidth.hpp"
+#include "stat_ring.hpp"
 #include "singleton_emit.hpp"
 #include <boost/exception/all.hpp>
 #include <boost/asio.hpp>
@@ -51,10 +54,12 @@
 #include <boost/ptr_container/ptr_unordered_map.hpp>
 #include <string>
 #include <fstream>
+#include <memory>
 #include <unordered_map>
 #include <QObject>
 #include <QString>
 #include <QDateTime>
+#include <QStringList>
 #include <QMutex>
 #include <qmetatype.h>
 
@@ -70,7 +75,7 @@ public:
     CurlMulti();
     ~CurlMulti();
 
-    static bool fileStream();
+    static bool nextXferSample(GekkoFyre::GkCurl::XferSample &sample);
 
 public slots:
     /* 1.0) Create new easy-handle
@@ -79,49 +84,102 @@ public slots:
      * 3.0) When transfers are done, delete the easy-handle
      */
 
-    void recvNewDl(const QString &url, const QString &fileLoc, const bool &resumeDl);
+    void recvNewDl(const QString &url, const QString &fileLoc, const bool &resumeDl, const double &contentLength,
+                   const bool &acceptRanges, const GekkoFyre::HashType &hashType, const QStringList &mirrors,
+                   const std::vector<GekkoFyre::GkCurl::SegmentRange> &segments);
     void recvStopDl(const QString &fileLoc);
+    void recvDlPriority(const QString &fileLoc, const int &priority);
 
 signals:
-    void sendXferStats(const GekkoFyre::GkCurl::CurlProgressPtr &dl_stat);
+    void sendDlStarted(const QString &fileLoc);
     void sendDlFinished(const GekkoFyre::GkCurl::DlStatusMsg &status);
+    void sendDlSegments(const QString &fileLoc, const std::vector<GekkoFyre::GkCurl::SegmentRange> &segments);
 
 private:
     // http://stackoverflow.com/questions/10333854/how-to-handle-a-map-with-pointers
     // https://theboostcpplibraries.com/boost.pointer_container
     static boost::ptr_unordered_map<std::string, GekkoFyre::GkCurl::CurlInit> eh_vec; // Easy handle mapped to a ID, for managing each connection
     static std::unordered_map<std::string, GekkoFyre::GkCurl::ActiveDownloads> transfer_monitoring;
+    static std::unordered_map<std::string, std::string> monitor_index; // File destination mapped to its key within 'transfer_monitoring'
     static GekkoFyre::GkCurl::GlobalInfo *gi;
+    static std::unique_ptr<GekkoFyre::GkAsyncWriter> disk_writer;
+    static std::vector<std::string> paused_conns; // Connections that have been paused whilst the disk catches up
+    static std::vector<CURL *> idle_easy; // Easy handles that have been reset and are waiting to be reused
     static QMutex mutex;
-    static short active_downloads;
+    static std::vector<GekkoFyre::GkCurl::QueuedDl> dl_queue; // Downloads waiting upon a free slot before they may start
+    static std::unordered_map<std::string, std::string> active_dls; // File destination of each download holding a slot, mapped to its host
+    static std::unordered_map<std::string, long> host_active; // How many slots are held by downloads from each host
+    static std::unordered_map<std::string, int> dl_priority; // File destination mapped to the priority given to it, if any
+    static unsigned long long queue_seq;
+    static std::unordered_map<std::string, GekkoFyre::GkCurl::HostHealth> host_health; // Hosts that have failed of late
+    static GekkoFyre::GkStatRing<GekkoFyre::GkCurl::XferSample, FYREDL_STATS_RING_SIZE> xfer_ring; // Transfer statistics waiting upon the GUI
 
     static std::string createId();
 
+    static void init_event_loop();
+    static void resume_paused();
+    static void bw_tick(const boost::system::error_code &error);
+    static void start_download(const QString &url, const QString &fileLoc, const bool &resumeDl,
+                               const double &contentLength, const bool &acceptRanges,
+                               const GekkoFyre::HashType &hashType, const std::vector<std::string> &mirrors,
+                               const std::vector<GekkoFyre::GkCurl::SegmentRange> &saved_segments);
+    static void stop_download(const QString &fileLoc);
+    static void save_segments(const std::string &monitor_id, const bool &settle = false);
+    static void enqueue_download(const GekkoFyre::GkCurl::QueuedDl &dl);
+    static bool dequeue_download(const std::string &file_loc);
+    static void promote();
+    static void release_slot(const std::string &file_loc);
+    static void report_failure(const std::string &file_loc, const std::string &url, const CURLcode &result);
+    static bool queue_before(const GekkoFyre::GkCurl::QueuedDl &a, const GekkoFyre::GkCurl::QueuedDl &b);
+    static bool is_transient(const CURLcode &code, const long &resp_code);
+    static bool host_tripped(const std::string &host);
+    static bool schedule_retry(const std::string &monitor_id, const std::string &url, const std::string &file_loc,
+                               const std::shared_ptr<GekkoFyre::GkCurl::CurlSegment> &segment,
+                               const curl_off_t &file_offset, const bool &made_progress, const long &retry_after);
+    static std::shared_ptr<GekkoFyre::GkCurl::Mirror> pick_mirror(const std::string &monitor_id,
+                                                                  const std::shared_ptr<GekkoFyre::GkCurl::Mirror> &avoid = nullptr);
+    static std::shared_ptr<GekkoFyre::GkCurl::Mirror> fail_over(const std::string &monitor_id,
+                                                                const std::shared_ptr<GekkoFyre::GkCurl::Mirror> &failed,
+                                                                const bool &permanent);
+
     static void mcode_or_die(const char *where, CURLMcode code);
+    static CURL *acquire_easy();
+    static void release_easy(CURL *easy);
 
     static void check_multi_info(GekkoFyre::GkCurl::GlobalInfo *g);
-    static void event_cb(GekkoFyre::GkCurl::GlobalInfo *g, boost::asio::ip::tcp::socket *tcp_socket, int action);
+    static void event_cb(GekkoFyre::GkCurl::GlobalInfo *g, curl_socket_t s, int action,
+                         const boost::system::error_code &error);
     static void timer_cb(const boost::system::error_code &error, GekkoFyre::GkCurl::GlobalInfo *g);
     static int multi_timer_cb(CURLM *multi, long timeout_ms, GekkoFyre::GkCurl::GlobalInfo *g);
 
-    static void remsock(int *f, GekkoFyre::GkCurl::GlobalInfo *g);
-    static void setsock(int *fdp, curl_socket_t s, CURL *e, int act, GekkoFyre::GkCurl::GlobalInfo *g);
-    static void addsock(curl_socket_t s, CURL *easy, int action, GekkoFyre::GkCurl::GlobalInfo *g);
+    static void remsock(curl_socket_t s, GekkoFyre::GkCurl::GlobalInfo *g);
+    static void watch_socket(GekkoFyre::GkCurl::GlobalInfo *g, curl_socket_t s, boost::asio::ip::tcp::socket *tcp_socket,
+                             int action);
+    static void setsock(curl_socket_t s, CURL *e, int act, int oldact, GekkoFyre::GkCurl::GlobalInfo *g);
     static int sock_cb(CURL *e, curl_socket_t s, int what, void *cbp, void *sockp); // https://curl.haxx.se/libcurl/c/CURLMOPT_SOCKETFUNCTION.html
 
     static int curl_xferinfo(void *p, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow); // https://curl.haxx.se/libcurl/c/CURLOPT_PROGRESSFUNCTION.html
     static curl_socket_t opensocket(void *clientp, curlsocktype purpose, struct curl_sockaddr *address); // https://curl.haxx.se/libcurl/c/CURLOPT_OPENSOCKETFUNCTION.html
     static int close_socket(void *clientp, curl_socket_t item); // https://curl.haxx.se/libcurl/c/CURLOPT_CLOSESOCKETFUNCTION.html
     static size_t curl_write_file_callback(char *buffer, size_t size, size_t nmemb, void *userdata);
+    static std::function<void(const bool &written)> count_written(const std::shared_ptr<GekkoFyre::GkCurl::CurlSegment> &segment,
+                                                                  const curl_off_t &length);
     static std::string new_conn(const QString &url, const QString &fileLoc, GekkoFyre::GkCurl::GlobalInfo *global,
-                                const curl_off_t &file_offset = 0L);
+                                const std::string &monitor_id, const curl_off_t &file_offset = 0L,
+                                const std::shared_ptr<GekkoFyre::GkCurl::CurlSegment> &segment = nullptr);
+    static void new_segmented_conn(const QString &url, const QString &fileLoc, GekkoFyre::GkCurl::GlobalInfo *global,
+                                   const std::string &monitor_id, const double &content_length,
+                                   const curl_off_t &seg_count);
+    static void del_conn(const std::string &conn_id);
+    static bool steal_segment(const std::string &conn_id, GekkoFyre::GkCurl::GlobalInfo *global);
 
 };
     typedef SingletonEmit<CurlMulti> routine_singleton;
 }
 
 // This is required for signaling, otherwise QVariant does not know the type.
-Q_DECLARE_METATYPE(GekkoFyre::GkCurl::CurlProgressPtr);
 Q_DECLARE_METATYPE(GekkoFyre::GkCurl::DlStatusMsg);
+Q_DECLARE_METATYPE(GekkoFyre::HashType);
+Q_DECLARE_METATYPE(std::vector<GekkoFyre::GkCurl::SegmentRange>);
 
 #endif // FYREDL_CURLMULTI_HPP
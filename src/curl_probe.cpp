@@ -0,0 +1,354 @@
+/**
+ **  ______             ______ _
+ **  |  ___|            |  _  \ |
+ **  | |_ _   _ _ __ ___| | | | |
+ **  |  _| | | | '__/ _ \ | | | |
+ **  | | | |_| | | |  __/ |/ /| |____
+ **  \_|  \__, |_|  \___|___/ \_____/
+ **        __/ |
+ **       |___/
+ **
+ **   Thank you for using "FyreDL" for your download management needs!
+ **   Copyright (C) 2016-2017. GekkoFyre.
+ **
+ **
+ **   FyreDL is free software: you can redistribute it and/or modify
+ **   it under the terms of the GNU General Public License as published by
+ **   the Free Software Foundation, either version 3 of the License, or
+ **   (at your option) any later version.
+ **
+ **   FyreDL is distributed in the hope that it will be useful,
+ **   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **   GNU General Public License for more details.
+ **
+ **   You should have received a copy of the GNU General Public License
+ **   along with FyreDL.  If not, see <http://www.gnu.org/licenses/>.
+ **
+ **
+ **   The latest source code updates can be obtained from [ 1 ] below at your
+ **   discretion. A web-browser or the 'git' application may be required.
+ **
+ **   [ 1 ] - https://github.com/GekkoFyre/FyreDL
+ **
+ ********************************************************************************/
+
+
+/**
+ * @file curl_probe.cpp
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-25
+ * @brief Probes the headers of many URLs at once, upon a single multi-handle, whereby name resolving, TLS sessions and
+ * connections are all reused between them.
+ */
+
+#include "curl_probe.hpp"
+#include "curl_easy.hpp"
+#include <cstring>
+#include <cctype>
+#include <exception>
+#include <stdexcept>
+
+/**
+ * @brief GekkoFyre::GkCurlProbe::GkCurlProbe sets up the multi-handle, along with the share-handle through which the DNS
+ * cache and TLS sessions are shared between every probe, and then starts up the thread that does all of the probing.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-25
+ * @note <https://curl.haxx.se/libcurl/c/libcurl-share.html>
+ *       <https://curl.haxx.se/libcurl/c/CURLMOPT_MAX_HOST_CONNECTIONS.html>
+ * @param max_active How many probes may be in the midst of transferring at once. The rest wait their turn.
+ */
+GekkoFyre::GkCurlProbe::GkCurlProbe(const long &max_active) : max_probes(max_active), stopping(false)
+{
+    GekkoFyre::CurlEasy::globalInit();
+
+    multi = curl_multi_init();
+    if (multi == nullptr) {
+        throw std::runtime_error("'curl_multi_init()' failed, exiting!");
+    }
+
+    // Probes to the same host wait upon one another rather than each opening a connection of their own, so that they
+    // may all reuse the connections that are kept alive within the multi-handle's cache
+    #if LIBCURL_VERSION_NUM >= 0x071e00
+    curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, FYREDL_PROBE_MAX_HOST_CONNS);
+    curl_multi_setopt(multi, CURLMOPT_MAXCONNECTS, max_probes);
+    #endif
+
+    share = curl_share_init();
+    if (share == nullptr) {
+        curl_multi_cleanup(multi);
+        throw std::runtime_error("'curl_share_init()' failed, exiting!");
+    }
+
+    curl_share_setopt(share, CURLSHOPT_LOCKFUNC, lock_cb);
+    curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, unlock_cb);
+    curl_share_setopt(share, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+
+    worker = std::thread(&GkCurlProbe::run, this);
+}
+
+GekkoFyre::GkCurlProbe::~GkCurlProbe()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+
+    cond.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+
+    curl_multi_cleanup(multi);
+    curl_share_cleanup(share);
+}
+
+/**
+ * @brief GekkoFyre::GkCurlProbe::instance is the probing service that is shared throughout FyreDL, so that every probe
+ * benefits from the connections and sessions that have been built up by those before it.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-25
+ */
+GekkoFyre::GkCurlProbe &GekkoFyre::GkCurlProbe::instance()
+{
+    static GkCurlProbe probe_service;
+    return probe_service;
+}
+
+/**
+ * @brief GekkoFyre::GkCurlProbe::probe queues up a HEAD request for the given URL, returning straight away.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-25
+ * @param url The web-address of the file in question.
+ * @return The outcome of the probe, once it has finished. Should libcurl itself fail then 'status_ok' is false, with the
+ * error code within 'response_code' and the error message within 'effective_url', as per CurlEasy::curlGrabInfo().
+ */
+std::future<GekkoFyre::GkCurl::CurlInfoExt> GekkoFyre::GkCurlProbe::probe(const std::string &url)
+{
+    std::unique_ptr<ProbeJob> job(new ProbeJob);
+    job->url = url;
+    job->accept_ranges = false;
+    job->error[0] = '\0';
+    std::future<GekkoFyre::GkCurl::CurlInfoExt> result = job->result.get_future();
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        pending.push_back(std::move(job));
+    }
+
+    cond.notify_one();
+    return result;
+}
+
+void GekkoFyre::GkCurlProbe::run()
+{
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            if (active.empty()) {
+                // Nothing is transferring, so there is nothing for libcurl to do until another probe arrives
+                cond.wait(lock, [this]() { return stopping || !pending.empty(); });
+            }
+
+            if (stopping) {
+                break;
+            }
+
+            while (!pending.empty() && (long)active.size() < max_probes) {
+                std::unique_ptr<ProbeJob> job = std::move(pending.front());
+                pending.pop_front();
+                start_probe(std::move(job));
+            }
+        }
+
+        int running = 0;
+        curl_multi_perform(multi, &running);
+
+        int msgs_left = 0;
+        CURLMsg *msg;
+        while ((msg = curl_multi_info_read(multi, &msgs_left)) != nullptr) {
+            if (msg->msg == CURLMSG_DONE) {
+                finish_probe(msg->easy_handle, msg->data.result);
+            }
+        }
+
+        if (!active.empty()) {
+            // Wakes up early for any activity upon the sockets, but not for newly queued probes, hence the short timeout
+            int numfds = 0;
+            curl_multi_wait(multi, nullptr, 0, 50, &numfds);
+        }
+    }
+
+    // Anything that is still outstanding is abandoned
+    for (auto &job: active) {
+        curl_multi_remove_handle(multi, job.first);
+        curl_easy_cleanup(job.first);
+        job.second->result.set_exception(std::make_exception_ptr(std::runtime_error("Probe of \"" + job.second->url + "\" was abandoned!")));
+    }
+
+    active.clear();
+    for (auto &job: pending) {
+        job->result.set_exception(std::make_exception_ptr(std::runtime_error("Probe of \"" + job->url + "\" was abandoned!")));
+    }
+
+    pending.clear();
+    return;
+}
+
+/**
+ * @brief GekkoFyre::GkCurlProbe::start_probe creates an easy-handle for the given probe and adds it to the multi-handle.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-25
+ */
+void GekkoFyre::GkCurlProbe::start_probe(std::unique_ptr<ProbeJob> job)
+{
+    CURL *easy = curl_easy_init();
+    if (easy == nullptr) {
+        job->result.set_exception(std::make_exception_ptr(std::runtime_error("'curl_easy_init()' failed, exiting!")));
+        return;
+    }
+
+    curl_easy_setopt(easy, CURLOPT_URL, job->url.c_str());
+    curl_easy_setopt(easy, CURLOPT_SHARE, share);
+
+    // Grab only the header
+    curl_easy_setopt(easy, CURLOPT_NOBODY, 1L);
+    curl_easy_setopt(easy, CURLOPT_NOPROGRESS, 1L);
+    curl_easy_setopt(easy, CURLOPT_HEADERFUNCTION, &header_cb);
+    curl_easy_setopt(easy, CURLOPT_HEADERDATA, job.get());
+    curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, &discard_cb);
+
+    curl_easy_setopt(easy, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(easy, CURLOPT_MAXREDIRS, 12L);
+    curl_easy_setopt(easy, CURLOPT_USERAGENT, FYREDL_USER_AGENT);
+    curl_easy_setopt(easy, CURLOPT_CONNECTTIMEOUT, FYREDL_CONN_TIMEOUT);
+    curl_easy_setopt(easy, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(easy, CURLOPT_ERRORBUFFER, job->error);
+    curl_easy_setopt(easy, CURLOPT_LOW_SPEED_TIME, 3L);
+    curl_easy_setopt(easy, CURLOPT_LOW_SPEED_LIMIT, 10L);
+
+    CURLMcode rc = curl_multi_add_handle(multi, easy);
+    if (rc != CURLM_OK) {
+        curl_easy_cleanup(easy);
+        job->result.set_exception(std::make_exception_ptr(std::runtime_error(curl_multi_strerror(rc))));
+        return;
+    }
+
+    active.emplace(easy, std::move(job));
+    return;
+}
+
+/**
+ * @brief GekkoFyre::GkCurlProbe::finish_probe gathers up the outcome of a probe once libcurl is done with it, and hands
+ * it back to whoever had asked for it.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-25
+ */
+void GekkoFyre::GkCurlProbe::finish_probe(CURL *easy, const CURLcode &code)
+{
+    auto it = active.find(easy);
+    if (it == active.end()) {
+        return;
+    }
+
+    std::unique_ptr<ProbeJob> job = std::move(it->second);
+    active.erase(it);
+
+    GekkoFyre::GkCurl::CurlInfoExt info;
+    if (code != CURLE_OK) {
+        info.response_code = code;
+        info.effective_url = (job->error[0] != '\0') ? job->error : curl_easy_strerror(code);
+        info.status_ok = false;
+        info.elapsed = -1;
+        info.content_length = -1;
+        info.accept_ranges = false;
+    } else {
+        long rescode = 0;
+        double elapsed = 0, content_length = 0;
+        char *effec_url = nullptr;
+        curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &rescode);
+        curl_easy_getinfo(easy, CURLINFO_TOTAL_TIME, &elapsed);
+        curl_easy_getinfo(easy, CURLINFO_EFFECTIVE_URL, &effec_url);
+        curl_easy_getinfo(easy, CURLINFO_CONTENT_LENGTH_DOWNLOAD, &content_length);
+
+        info.response_code = rescode;
+        info.elapsed = elapsed;
+        info.content_length = content_length;
+        info.effective_url = (effec_url != nullptr) ? effec_url : job->url;
+        info.status_ok = true;
+        info.accept_ranges = job->accept_ranges;
+    }
+
+    // The connection itself stays behind within the multi-handle's cache, ready for the next probe to the same host
+    curl_multi_remove_handle(multi, easy);
+    curl_easy_cleanup(easy);
+
+    job->result.set_value(info);
+    return;
+}
+
+void GekkoFyre::GkCurlProbe::lock_cb(CURL *handle, curl_lock_data data, curl_lock_access access, void *userptr)
+{
+    (void)handle;
+    (void)access;
+    static_cast<GkCurlProbe *>(userptr)->share_mtx[data].lock();
+    return;
+}
+
+void GekkoFyre::GkCurlProbe::unlock_cb(CURL *handle, curl_lock_data data, void *userptr)
+{
+    (void)handle;
+    static_cast<GkCurlProbe *>(userptr)->share_mtx[data].unlock();
+    return;
+}
+
+/**
+ * @brief GekkoFyre::GkCurlProbe::header_cb looks at each header as it arrives. Only the headers of the final response
+ * matter, should any redirects have been followed along the way.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-25
+ * @note <https://curl.haxx.se/libcurl/c/CURLOPT_HEADERFUNCTION.html>
+ */
+size_t GekkoFyre::GkCurlProbe::header_cb(char *buffer, size_t size, size_t nitems, void *userdata)
+{
+    ProbeJob *job = static_cast<ProbeJob *>(userdata);
+    const size_t realsize = (size * nitems);
+    auto starts_with = [&](const char *prefix) {
+        const size_t len = std::strlen(prefix);
+        if (realsize < len) {
+            return false;
+        }
+
+        for (size_t i = 0; i < len; ++i) {
+            if (std::tolower((unsigned char)buffer[i]) != prefix[i]) {
+                return false;
+            }
+        }
+
+        return true;
+    };
+
+    if (starts_with("http/")) {
+        // The start of another response
+        job->accept_ranges = false;
+    } else if (starts_with("accept-ranges:")) {
+        std::string value(buffer + 14, realsize - 14);
+        for (auto &c: value) {
+            c = (char)std::tolower((unsigned char)c);
+        }
+
+        job->accept_ranges = (value.find("bytes") != std::string::npos);
+    }
+
+    return realsize;
+}
+
+size_t GekkoFyre::GkCurlProbe::discard_cb(char *ptr, size_t size, size_t nmemb, void *userdata)
+{
+    (void)ptr;
+    (void)userdata;
+    return (size * nmemb);
+}
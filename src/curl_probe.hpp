@@ -0,0 +1,104 @@
+/**
+ **  ______             ______ _
+ **  |  ___|            |  _  \ |
+ **  | |_ _   _ _ __ ___| | | | |
+ **  |  _| | | | '__/ _ \ | | | |
+ **  | | | |_| | | |  __/ |/ /| |____
+ **  \_|  \__, |_|  \___|___/ \_____/
+ **        __/ |
+ **       |___/
+ **
+ **   Thank you for using "FyreDL" for your download management needs!
+ **   Copyright (C) 2016-2017. GekkoFyre.
+ **
+ **
+ **   FyreDL is free software: you can redistribute it and/or modify
+ **   it under the terms of the GNU General Public License as published by
+ **   the Free Software Foundation, either version 3 of the License, or
+ **   (at your option) any later version.
+ **
+ **   FyreDL is distributed in the hope that it will be useful,
+ **   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **   GNU General Public License for more details.
+ **
+ **   You should have received a copy of the GNU General Public License
+ **   along with FyreDL.  If not, see <http://www.gnu.org/licenses/>.
+ **
+ **
+ **   The latest source code updates can be obtained from [ 1 ] below at your
+ **   discretion. A web-browser or the 'git' application may be required.
+ **
+ **   [ 1 ] - https://github.com/GekkoFyre/FyreDL
+ **
+ ********************************************************************************/
+
+
+/**
+ * @file curl_probe.hpp
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-25
+ * @brief Probes the headers of many URLs at once, upon a single multi-handle, whereby name resolving, TLS sessions and
+ * connections are all reused between them.
+ */
+
+#ifndef FYREDL_CURL_PROBE_HPP
+#define FYREDL_CURL_PROBE_HPP
+
+#include "default_var.hpp"
+#include <string>
+#include <deque>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <future>
+
+extern "C" {
+#include <curl/curl.h>
+}
+
+namespace GekkoFyre {
+class GkCurlProbe {
+public:
+    GkCurlProbe(const GkCurlProbe&) = delete;
+    GkCurlProbe &operator=(const GkCurlProbe&) = delete;
+
+    explicit GkCurlProbe(const long &max_active = FYREDL_PROBE_MAX_ACTIVE);
+    ~GkCurlProbe();
+
+    static GkCurlProbe &instance();
+    std::future<GekkoFyre::GkCurl::CurlInfoExt> probe(const std::string &url);
+
+private:
+    struct ProbeJob {
+        std::string url;
+        std::promise<GekkoFyre::GkCurl::CurlInfoExt> result;
+        bool accept_ranges;
+        char error[CURL_ERROR_SIZE];
+    };
+
+    CURLM *multi;
+    CURLSH *share;
+    std::mutex share_mtx[CURL_LOCK_DATA_LAST];   // One apiece for each kind of data that is shared between handles
+    long max_probes;                             // How many probes may be in the midst of transferring at once
+    std::deque<std::unique_ptr<ProbeJob>> pending;
+    std::unordered_map<CURL *, std::unique_ptr<ProbeJob>> active; // Only ever touched by the probing thread
+    std::mutex mtx;
+    std::condition_variable cond;
+    std::thread worker;
+    bool stopping;
+
+    void run();
+    void start_probe(std::unique_ptr<ProbeJob> job);
+    void finish_probe(CURL *easy, const CURLcode &code);
+
+    static void lock_cb(CURL *handle, curl_lock_data data, curl_lock_access access, void *userptr);
+    static void unlock_cb(CURL *handle, curl_lock_data data, void *userptr);
+    static size_t header_cb(char *buffer, size_t size, size_t nitems, void *userdata);
+    static size_t discard_cb(char *ptr, size_t size, size_t nmemb, void *userdata);
+};
+}
+
+#endif // FYREDL_CURL_PROBE_HPP
@@ -0,0 +1,176 @@
+/**
+ **  ______             ______ _
+ **  |  ___|            |  _  \ |
+ **  | |_ _   _ _ __ ___| | | | |
+ **  |  _| | | | '__/ _ \ | | | |
+ **  | | | |_| | | |  __/ |/ /| |____
+ **  \_|  \__, |_|  \___|___/ \_____/
+ **        __/ |
+ **       |___/
+ **
+ **   Thank you for using "FyreDL" for your download management needs!
+ **   Copyright (C) 2016-2017. GekkoFyre.
+ **
+ **
+ **   FyreDL is free software: you can redistribute it and/or modify
+ **   it under the terms of the GNU General Public License as published by
+ **   the Free Software Foundation, either version 3 of the License, or
+ **   (at your option) any later version.
+ **
+ **   FyreDL is distributed in the hope that it will be useful,
+ **   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **   GNU General Public License for more details.
+ **
+ **   You should have received a copy of the GNU General Public License
+ **   along with FyreDL.  If not, see <http://www.gnu.org/licenses/>.
+ **
+ **
+ **   The latest source code updates can be obtained from [ 1 ] below at your
+ **   discretion. A web-browser or the 'git' application may be required.
+ **
+ **   [ 1 ] - https://github.com/GekkoFyre/FyreDL
+ **
+ ********************************************************************************/
+
+/**
+ * @file db_record.cpp
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-18
+ * @brief A compact, versioned binary format for the records that make up the download history, stored as one value
+ * per download item within the Google LevelDB database.
+ */
+
+#include "db_record.hpp"
+#include <cstring>
+#include <stdexcept>
+
+GekkoFyre::GkRecordWriter::GkRecordWriter(const uint8_t &record_type, const uint8_t &version, const size_t &size_hint)
+{
+    buf.reserve(size_hint);
+    buf.push_back(static_cast<char>(record_type));
+    buf.push_back(static_cast<char>(version));
+}
+
+void GekkoFyre::GkRecordWriter::put_u8(const uint8_t &value)
+{
+    put_raw(value, sizeof(uint8_t));
+}
+
+void GekkoFyre::GkRecordWriter::put_i32(const int32_t &value)
+{
+    put_raw(static_cast<uint32_t>(value), sizeof(uint32_t));
+}
+
+void GekkoFyre::GkRecordWriter::put_i64(const int64_t &value)
+{
+    put_raw(static_cast<uint64_t>(value), sizeof(uint64_t));
+}
+
+void GekkoFyre::GkRecordWriter::put_f64(const double &value)
+{
+    uint64_t bits;
+    static_assert(sizeof(bits) == sizeof(value), "A 'double' must be 64-bits wide!");
+    std::memcpy(&bits, &value, sizeof(bits));
+    put_raw(bits, sizeof(uint64_t));
+}
+
+void GekkoFyre::GkRecordWriter::put_str(const std::string &value)
+{
+    put_raw(static_cast<uint32_t>(value.size()), sizeof(uint32_t));
+    buf.append(value);
+}
+
+const std::string &GekkoFyre::GkRecordWriter::data() const noexcept
+{
+    return buf;
+}
+
+/**
+ * @brief GekkoFyre::GkRecordWriter::put_raw writes out the lowest 'width' bytes of a value, least significant byte
+ * first, so that records are the same no matter the endianness of the machine that wrote them.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-18
+ */
+void GekkoFyre::GkRecordWriter::put_raw(const uint64_t &value, const size_t &width)
+{
+    for (size_t i = 0; i < width; ++i) {
+        buf.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+    }
+
+    return;
+}
+
+/**
+ * @brief GekkoFyre::GkRecordReader::GkRecordReader checks the header of a record before any of its fields are read.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-18
+ * @param data The record, as read from the database. It must outlive this object, as it is not copied.
+ * @param record_type The type of record that is expected.
+ */
+GekkoFyre::GkRecordReader::GkRecordReader(const std::string &data, const uint8_t &record_type)
+{
+    pos = data.data();
+    end = data.data() + data.size();
+    if (data.size() < 2 || static_cast<uint8_t>(pos[0]) != record_type) {
+        throw std::runtime_error("Record is either truncated or not of the expected type!");
+    }
+
+    ver = static_cast<uint8_t>(pos[1]);
+    pos += 2;
+}
+
+uint8_t GekkoFyre::GkRecordReader::version() const noexcept
+{
+    return ver;
+}
+
+uint8_t GekkoFyre::GkRecordReader::get_u8()
+{
+    return static_cast<uint8_t>(get_raw(sizeof(uint8_t)));
+}
+
+int32_t GekkoFyre::GkRecordReader::get_i32()
+{
+    return static_cast<int32_t>(static_cast<uint32_t>(get_raw(sizeof(uint32_t))));
+}
+
+int64_t GekkoFyre::GkRecordReader::get_i64()
+{
+    return static_cast<int64_t>(get_raw(sizeof(uint64_t)));
+}
+
+double GekkoFyre::GkRecordReader::get_f64()
+{
+    uint64_t bits = get_raw(sizeof(uint64_t));
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+std::string GekkoFyre::GkRecordReader::get_str()
+{
+    size_t length = static_cast<uint32_t>(get_raw(sizeof(uint32_t)));
+    if (static_cast<size_t>(end - pos) < length) {
+        throw std::runtime_error("Record is truncated!");
+    }
+
+    std::string value(pos, length);
+    pos += length;
+    return value;
+}
+
+uint64_t GekkoFyre::GkRecordReader::get_raw(const size_t &width)
+{
+    if (static_cast<size_t>(end - pos) < width) {
+        throw std::runtime_error("Record is truncated!");
+    }
+
+    uint64_t value = 0;
+    for (size_t i = 0; i < width; ++i) {
+        value |= (static_cast<uint64_t>(static_cast<uint8_t>(pos[i])) << (i * 8));
+    }
+
+    pos += width;
+    return value;
+}
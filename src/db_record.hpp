@@ -0,0 +1,98 @@
+/**
+ **  ______             ______ _
+ **  |  ___|            |  _  \ |
+ **  | |_ _   _ _ __ ___| | | | |
+ **  |  _| | | | '__/ _ \ | | | |
+ **  | | | |_| | | |  __/ |/ /| |____
+ **  \_|  \__, |_|  \___|___/ \_____/
+ **        __/ |
+ **       |___/
+ **
+ **   Thank you for using "FyreDL" for your download management needs!
+ **   Copyright (C) 2016-2017. GekkoFyre.
+ **
+ **
+ **   FyreDL is free software: you can redistribute it and/or modify
+ **   it under the terms of the GNU General Public License as published by
+ **   the Free Software Foundation, either version 3 of the License, or
+ **   (at your option) any later version.
+ **
+ **   FyreDL is distributed in the hope that it will be useful,
+ **   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **   GNU General Public License for more details.
+ **
+ **   You should have received a copy of the GNU General Public License
+ **   along with FyreDL.  If not, see <http://www.gnu.org/licenses/>.
+ **
+ **
+ **   The latest source code updates can be obtained from [ 1 ] below at your
+ **   discretion. A web-browser or the 'git' application may be required.
+ **
+ **   [ 1 ] - https://github.com/GekkoFyre/FyreDL
+ **
+ ********************************************************************************/
+
+/**
+ * @file db_record.hpp
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-18
+ * @brief A compact, versioned binary format for the records that make up the download history, stored as one value
+ * per download item within the Google LevelDB database.
+ */
+
+#ifndef FYREDL_DB_RECORD_HPP
+#define FYREDL_DB_RECORD_HPP
+
+#include <string>
+#include <cstdint>
+
+namespace GekkoFyre {
+/**
+ * @brief GekkoFyre::GkRecordWriter builds up a record, field by field. Every record begins with a one byte type and a
+ * one byte version, after which come the fields themselves: integers are fixed-width and little-endian, while strings
+ * are prefixed with their length as a 32-bit integer.
+ */
+class GkRecordWriter {
+public:
+    explicit GkRecordWriter(const uint8_t &record_type, const uint8_t &version, const size_t &size_hint = 128);
+
+    void put_u8(const uint8_t &value);
+    void put_i32(const int32_t &value);
+    void put_i64(const int64_t &value);
+    void put_f64(const double &value);
+    void put_str(const std::string &value);
+
+    const std::string &data() const noexcept;
+
+private:
+    std::string buf;
+
+    void put_raw(const uint64_t &value, const size_t &width);
+};
+
+/**
+ * @brief GekkoFyre::GkRecordReader reads back the fields of a record in the same order that they were written. Any
+ * attempt to read past the end of the record, or a record of the wrong type, throws an exception.
+ */
+class GkRecordReader {
+public:
+    explicit GkRecordReader(const std::string &data, const uint8_t &record_type);
+
+    uint8_t version() const noexcept;
+    uint8_t get_u8();
+    int32_t get_i32();
+    int64_t get_i64();
+    double get_f64();
+    std::string get_str();
+
+private:
+    const char *pos;
+    const char *end;
+    uint8_t ver;
+
+    uint64_t get_raw(const size_t &width);
+};
+}
+
+#endif // FYREDL_DB_RECORD_HPP
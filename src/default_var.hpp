@@ -54,10 +54,12 @@
 #include <memory>
 #include <vector>
 #include <ctime>
+#include <chrono>
 #include <cassert>
 #include <cstdlib>
 #include <tuple>
 #include <QString>
+#include <QCryptographicHash>
 #include <QtCharts>
 #include <QLineSeries>
 #include <QVariant>
@@ -94,6 +96,44 @@ extern "C" {
 #define FYREDL_CONN_TIMEOUT 60L                          // The duration, in seconds, until a timeout occurs when attempting to make a connection.
 #define FYREDL_CONN_LOW_SPEED_CUTOUT 512L                // The average transfer speed in bytes per second to be considered below before connection cut-off.
 #define FYREDL_CONN_LOW_SPEED_TIME 10L                   // The number of seconds that the transfer speed should be below 'FYREDL_CONN_LOW_SPEED_CUTOUT' before connection cut-off.
+#define FYREDL_CONN_SEGMENT_COUNT 4L                     // The number of byte-ranges (and thus connections) a HTTP(S)/FTP(S) download is split into, if the server supports it. Set to '1L' to disable segmented downloads.
+#define FYREDL_CONN_SEGMENT_MIN_SIZE (4L * 1024L * 1024L) // Downloads smaller than this, in bytes, are never split into segments as the extra connections would cost more than they gain.
+#define FYREDL_CONN_SEGMENT_MIN_STEAL (512L * 1024L)     // The smallest byte-range, in bytes, that an idle connection will take over from a segment which is still transferring.
+#define FYREDL_CONN_MAX_HOST_CONNS 8L                    // The number of connections that downloads may open up to any one host, with any further transfers waiting upon a free one. Set to '0L' for no limit.
+#define FYREDL_CONN_MAX_CACHED 64L                       // The number of finished, but still open, connections that are kept around for the next download from the same host to reuse.
+#define FYREDL_CONN_POOL_SIZE 32                         // The number of idle easy handles kept around to be reused by new connections, rather than freed and allocated anew.
+#define FYREDL_CONN_HTTP2_MULTIPLEX false                // Whether downloads from the same host are multiplexed over a single HTTP/2 connection, where the web-server supports it. Anything else falls back to HTTP/1.1.
+#define FYREDL_CONN_HTTP2_MAX_STREAMS 100L               // The number of downloads that may be multiplexed over any one HTTP/2 connection at once, with the rest waiting upon a free stream.
+#define FYREDL_BW_DOWN_LIMIT 0L                          // The download rate, in bytes per second, shared between every HTTP(S)/FTP(S) and BitTorrent transfer. Set to '0L' for no limit.
+#define FYREDL_BW_UP_LIMIT 0L                            // The upload rate, in bytes per second, of every BitTorrent transfer put together. Set to '0L' for no limit.
+#define FYREDL_BW_HOST_LIMIT 0L                          // The download rate, in bytes per second, of any one host unless it has a limit of its own. Set to '0L' for no limit.
+#define FYREDL_BW_ITEM_LIMIT 0L                          // The download rate, in bytes per second, of any one download unless it has a limit of its own. Set to '0L' for no limit.
+#define FYREDL_BW_BURST 0.5                              // How many seconds worth of the global download rate may be received in a single burst.
+#define FYREDL_BW_TICK_INTERVAL 100L                     // How often, in milliseconds, transfers that have been paused for want of bandwidth are given the chance to resume.
+#define FYREDL_BW_REBALANCE_INTERVAL 1000L               // How often, in milliseconds, the global download rate is divided up anew between the transfers that are drawing upon it.
+#define FYREDL_BW_GROWTH 1.5                             // How much faster than it is currently receiving that a transfer is allotted, so that it has room to speed up.
+#define FYREDL_BW_MIN_RATE (16L * 1024L)                 // The lowest rate, in bytes per second, that a transfer is allotted whilst there is enough of the global rate to go around.
+#define FYREDL_BW_TORRENT_ITEM "BitTorrent"              // The name under which every BitTorrent transfer, as a whole, is given its per-download limit and weight.
+#define FYREDL_QUEUE_MAX_ACTIVE 8L                       // The number of HTTP(S)/FTP(S) downloads that may be transferring at once, with the rest waiting in the queue. Set to '0L' for no limit.
+#define FYREDL_QUEUE_MAX_PER_HOST 2L                     // The number of HTTP(S)/FTP(S) downloads from any one host that may be transferring at once. Set to '0L' for no limit.
+#define FYREDL_QUEUE_SIZE_AWARE false                    // Whether queued downloads of the same priority start smallest first, rather than in the order they were started in.
+#define FYREDL_RETRY_MAX_ATTEMPTS 8                      // The number of times in a row that a download is tried again after a transient failure, before giving up. Any progress made resets the count.
+#define FYREDL_RETRY_BASE_DELAY 1000L                    // The delay, in milliseconds, before the first retry of a download. Each retry thereafter waits twice as long, give or take some jitter.
+#define FYREDL_RETRY_MAX_DELAY (5L * 60L * 1000L)        // The longest delay, in milliseconds, before a download is tried again.
+#define FYREDL_RETRY_BREAKER_THRESHOLD 5                 // The number of transient failures in a row from any one host before no more downloads are attempted from it for a while.
+#define FYREDL_RETRY_BREAKER_COOLDOWN (2L * 60L * 1000L) // How long, in milliseconds, that a host is left alone once it has failed 'FYREDL_RETRY_BREAKER_THRESHOLD' times in a row.
+#define FYREDL_MIRROR_MAX_FAILURES 3                     // The number of failures in a row after which a mirror is no longer used for the rest of the download, so long as another mirror is left.
+#define FYREDL_MIRROR_SPEED_SMOOTHING 0.3                // How much weight the latest measured speed of a mirror is given against those before it, between '0.0' and '1.0'.
+#define FYREDL_STATS_SAMPLE_INTERVAL 1000L               // How often, in milliseconds, each HTTP(S)/FTP(S) download hands its transfer statistics over to the GUI.
+#define FYREDL_STATS_DRAIN_INTERVAL 250L                 // How often, in milliseconds, the GUI takes in whatever transfer statistics have been handed over to it, keeping only the latest of each download.
+#define FYREDL_STATS_RING_SIZE 1024                      // DO NOT MODIFY! Unless it is kept a power of two. How many samples of transfer statistics may be waiting upon the GUI at once, before any more are dropped.
+#define FYREDL_SEGMENT_SAVE_INTERVAL 10000L              // How often, in milliseconds, the progress of each segment of a HTTP(S)/FTP(S) download is saved to the download history, so that it may be resumed after FyreDL has been restarted.
+#define FYREDL_PREALLOCATE_FILES false                   // Whether to reserve the whole of a HTTP(S)/FTP(S) download on local storage before it begins, provided its size is known. Avoids fragmentation and fails early if there is not enough space.
+#define FYREDL_DB_GROUP_COMMIT true                      // Whether writes to the download history that arrive at the same time are committed together under a single disk sync, rather than one sync apiece.
+#define FYREDL_IMPORT_PROBE_WINDOW 32                    // The number of URLs that are probed at once whilst importing a list of them from a CSV file.
+#define FYREDL_IMPORT_BATCH_SIZE 256                     // The number of imported URLs that are inserted and committed to the download history together.
+#define FYREDL_PROBE_MAX_ACTIVE 32L                      // The number of HEAD requests (i.e. to check that a URL exists) that may be in the midst of transferring at once.
+#define FYREDL_PROBE_MAX_HOST_CONNS 4L                   // The number of connections that HEAD requests may open up to any one host, with the rest reusing them in turn.
 #define FYREDL_EST_WAIT_TIME_PRECISION 3                 // The significant digit precision of the estimated wait time counter for each active transfer
 #define FYREDL_UNIQUE_ID_DIGIT_COUNT 32                  // The 'unique identifier' serial number that is given to each download item. This determines how many digits are allocated to this identifier and thus, how much RAM is used for storage thereof.
 #define FYREDL_DEFAULT_RESOLUTION_WIDTH 1920.0
@@ -114,15 +154,29 @@ extern "C" {
 
 // Download and File I/O
 #define WRITE_BUFFER_SIZE (CURL_MAX_WRITE_SIZE * 8) // Measured in bytes, see <https://curl.haxx.se/libcurl/c/CURLOPT_BUFFERSIZE.html>
-#define CURL_MAX_WAIT_MSECS (15 * 1000) // Measured in milliseconds
+#define WRITE_BUFFER_MAX_COUNT 64UL                 // How many filled write-buffers may await the disk at once, across all downloads, before transfers are paused
 #define FREE_DSK_SPACE_MULTIPLIER 3
+#define FYREDL_HASH_BLOCK_SIZE (4UL * 1024UL * 1024UL) // How much of a file, in bytes, is read in at a time when working out its checksum
+#define FYREDL_HASH_MAX_THREADS 4U                   // The most files that may have their checksums worked out at once, in the background
 
 // LevelDB configuration
 #define LEVELDB_CFG_CACHE_SIZE 32UL * 1024UL * 1024UL
 #define LEVELDB_CFG_LOCK_FILE_NAME "LOCK"
 
-#define LEVELDB_STORE_UNIQUE_ID "store-unique-id"
+#define LEVELDB_STORE_UNIQUE_ID "store-unique-id" // The older index of every Unique ID, as a single CSV blob. Only read so that it may be converted over
+#define LEVELDB_PREFIX_UNIQUE_ID "uid_"           // Every Unique ID has a key of its own with this prefix, holding the download's path and whether it's a torrent
+#define LEVELDB_PREFIX_FILE_PATH "path_"          // The reverse of the above, with the download's path as the key and its Unique ID as the value
 
+#define LEVELDB_KEY_CURL_RECORD "curl-record"   // Everything about a HTTP(S)/FTP(S) download, as one binary record (see 'GkRecordWriter')
+#define LEVELDB_KEY_TORRENT_RECORD "to-record"  // Everything about a BitTorrent download, its files and trackers included, as one binary record
+#define LEVELDB_RECORD_TYPE_CURL 0x01
+#define LEVELDB_RECORD_TYPE_TORRENT 0x02
+#define LEVELDB_RECORD_TYPE_UNIQUE_ID 0x03
+#define LEVELDB_RECORD_TYPE_FILE_PATH 0x04
+#define LEVELDB_RECORD_VERSION 3                // Increase this whenever the layout of a record changes, and have the decoders accept the older layouts
+
+// The older layout of the history, where each field had a key of its own. These are only read so that they may be
+// converted over into records.
 #define LEVELDB_KEY_CURL_STAT "curl-stat"                     // The download status (i.e., downloading, completed, unknown, etc.)
 #define LEVELDB_KEY_CURL_INSERT_DATE "curl-insrt-date"        // Date and time upon which the download was added to the XML history file
 #define LEVELDB_KEY_CURL_COMPLT_DATE "curl-complt-date"       // Date and time upon which the download was completed
@@ -181,10 +235,11 @@ extern "C" {
 #define TAB_INDEX_LOG 4
 
 // Comma Separated Value related information
-#define URL_ADD_CSV_NUM_COLS 3
+#define URL_ADD_CSV_NUM_COLS 4
 #define URL_ADD_CSV_FIELD_URL "url"
 #define URL_ADD_CSV_FIELD_DEST "destination"
 #define URL_ADD_CSV_FIELD_HASH "hash"
+#define URL_ADD_CSV_FIELD_MIRRORS "mirrors" // Further URLs of the same file, separated by whitespace
 
 #define LEVELDB_CSV_UNIQUE_ID_COLS 3
 #define LEVELDB_CSV_UID_KEY "unique-id"
@@ -238,7 +293,8 @@ namespace GekkoFyre {
         Paused,
         Stopped,
         Unknown,
-        Invalid
+        Invalid,
+        Queued              // Waiting upon a free slot before it may start downloading
     };
 
     enum DownloadType {
@@ -350,24 +406,116 @@ namespace GekkoFyre {
         };
     }
 
+    namespace GkBw {
+        // A time of day during which the global bandwidth limits differ from the usual ones
+        struct Window {
+            int begin;              // Minutes past local midnight at which the window opens, inclusive
+            int end;                // Minutes past local midnight at which the window closes, exclusive. Should this be before 'begin', then the window spans midnight.
+            curl_off_t down_limit;  // The global download rate within the window, in bytes per second, or '0' for no limit
+            curl_off_t up_limit;    // The global upload rate within the window, in bytes per second, or '0' for no limit
+        };
+
+        // A single stream of data that draws upon the global bandwidth, be it a connection or the BitTorrent session
+        struct Flow {
+            std::string item;       // The download this flow belongs to, by which per-download limits and weights are looked up
+            std::string host;       // The host this flow is receiving from, by which per-host limits are looked up
+            curl_off_t bytes;       // Bytes received since the global rate was last divided up
+            double measured;        // The smoothed receive rate, in bytes per second
+            curl_off_t rate;        // The rate allotted to this flow, in bytes per second, or '0' for no limit
+            bool reported;          // Whether 'measured' is reported by the flow itself, rather than worked out from 'bytes'
+        };
+    }
+
     namespace GkCurl {
         // http://stackoverflow.com/questions/18031357/why-the-constructor-of-stdostream-is-protected
         struct FileStream {
             std::string file_loc;   // Name to store file as if download /and/ disk writing is successful
-            std::shared_ptr<std::ofstream> astream; // I/O stream
+            int fd;                 // File descriptor, as given by 'GekkoFyre::GkAsyncWriter::open()'
+            curl_off_t start;       // Where within the file this connection began writing
+            curl_off_t offset;      // Where within the file the contents of 'buffer' are to be written
+            std::vector<char> buffer; // Data that has yet to be handed over to the disk writer
         };
 
         // Global information, common to all connections
         struct GlobalInfo {
             CURLM *multi;
+            CURLSH *share;          // Name resolves and TLS sessions, shared between every easy handle of 'multi'
+            bool multiplex;         // Whether transfers to the same host are multiplexed over HTTP/2
             int still_running;
         };
 
+        // A single byte-range of a segmented download, which is fetched by its own easy handle
+        struct CurlSegment {
+            curl_off_t range_begin; // The first byte of this segment within the file, inclusive
+            curl_off_t range_end;   // The last byte of this segment within the file, inclusive
+            curl_off_t received;    // How many bytes of this range have been taken off of the connection thus far, whether or not they are on disk yet
+            curl_off_t written;     // How many bytes of this range are known to have been written to local storage thus far
+            double dlspeed;         // The most recently measured download speed of this segment, in bytes per second
+            bool complete;          // Whether the entire range has been received, and handed over to be written to local storage
+        };
+
+        // A segment of a download as it is kept within the download history, so that it may be picked up from where it
+        // left off once FyreDL has been restarted
+        struct SegmentRange {
+            curl_off_t range_begin; // The first byte of the segment within the file, inclusive
+            curl_off_t range_end;   // The last byte of the segment within the file, inclusive
+            curl_off_t written;     // How many bytes of the range were known to be on local storage when it was saved
+        };
+
+        // One of the URLs that a download may be fetched from, along with how well it has been doing thus far
+        struct Mirror {
+            std::string url;        // The URL of the download upon this mirror
+            double dlspeed;         // The smoothed download speed of a single connection to this mirror, in bytes per second, or zero if not yet measured
+            int conns;              // How many connections of the download are currently fetching from this mirror
+            int failures;           // Failures in a row, since the mirror last delivered anything
+            bool dead;              // Whether the mirror has been given up on for the rest of the download
+        };
+
+        // The checksum of a download, which is added to as each buffer is written out to local storage rather than by reading
+        // the whole file back in once it has finished. Only ever touched from within the disk writer's thread.
+        struct StreamHash {
+            std::shared_ptr<QCryptographicHash> hash;
+            GekkoFyre::HashType hash_type;
+            curl_off_t hashed_to;   // Every byte of the file before this offset has been added to 'hash'
+        };
+
         // Monitors which downloads are actively transferring data. A hack to get things working correctly with regard
         // to being able to halt/pause downloads in libcurl.
         struct ActiveDownloads {
-            QString file_dest; // The file destination of the download on local storage
-            bool isActive;     // Whether the download is actively transferring data to local storage or not
+            QString file_dest;      // The file destination of the download on local storage
+            bool isActive;          // Whether the download is actively transferring data to local storage or not
+            double content_length;  // The file size of the download, as given by the web-server, if known
+            std::vector<std::shared_ptr<CurlSegment>> segments; // The byte-ranges of the download, if it is a segmented one
+            std::vector<std::shared_ptr<Mirror>> mirrors; // Every URL the download may be fetched from, the first being the one it was started with
+            std::vector<std::string> conn_ids; // The keys of every live connection of the download, within 'CurlMulti::eh_vec'
+            std::shared_ptr<StreamHash> stream_hash; // The checksum of the download, as worked out whilst it is being written
+            int retries;            // How many times in a row the download has been tried again, without making any progress
+            int retry_pending;      // How many of the download's connections are waiting to be tried again
+            unsigned long generation; // Bumped whenever the download is stopped, so that any retries still waiting know to give up
+            std::size_t item_key;   // The hash of 'file_dest', by which the GUI tells apart the statistics of each download
+            std::chrono::steady_clock::time_point last_sample; // When the statistics of the download were last handed over to the GUI
+            std::chrono::steady_clock::time_point last_saved; // When the segments of the download were last handed over to be saved
+        };
+
+        // How reliable a host has been of late, so that one which keeps failing is left alone for a while
+        struct HostHealth {
+            int failures;           // Transient failures in a row
+            std::chrono::steady_clock::time_point open_until; // No new transfers are made to the host before this time
+        };
+
+        // A download that is waiting upon a free slot before it may start transferring
+        struct QueuedDl {
+            QString url;            // The effective URL of the download
+            QString file_loc;       // The location of the download on local storage
+            bool resume;            // Whether the download is to pick up from where it left off
+            double content_length;  // The file size of the download, as given by the web-server, or zero if unknown
+            bool accept_ranges;     // Whether the web-server supports byte-range requests
+            GekkoFyre::HashType hash_type; // The type of checksum to work out whilst the download is being written
+            int priority;           // Downloads of a higher priority are started first
+            std::string host;       // The host the download is from, by which the per-host limit is counted
+            std::vector<std::string> mirrors; // Further URLs that the download may also be fetched from
+            std::vector<SegmentRange> segments; // How far along each segment of the download was when it was last saved, if at all
+            unsigned long long seq; // The order in which the download was queued up
         };
 
         struct MemoryStruct {
@@ -395,6 +543,7 @@ namespace GekkoFyre {
             double elapsed;            // Total time in seconds for the previous transfer (including name resolving, TCP connect, etc.)
             std::string effective_url; // In cases when you've asked libcurl to follow redirects, it may very well not be the same value you set with 'CURLOPT_URL'
             double content_length;     // The size of the download, i.e. content length
+            bool accept_ranges;        // Whether the web-server has advertised support for byte-range requests
         };
 
         struct CurlDlStats {
@@ -405,15 +554,23 @@ namespace GekkoFyre {
             std::time_t cur_time; // Time since epoch at which these statistics were gathered (for charting facilities)
         };
 
+        // The statistics of a download at a single point in time, as handed over to the GUI
+        struct XferSample {
+            std::size_t item;     // The hash of the download's location on local storage, as given by 'std::hash<std::string>'
+            CurlDlStats stat;     // The statistics of the download as a whole
+        };
+
         struct DlStatusMsg {
             double content_len;   // The content-length of the finished download
             QString url;          // The URL of the download in question
             std::string file_loc; // The full location of where the file is being saved to disk
+            GekkoFyre::HashType hash_type; // The type of checksum given in 'checksum'
+            QString checksum;     // The checksum of the download in hexadecimal, as worked out whilst downloading, or empty if there is none
+            CURLcode result;      // CURLE_OK if the download was received in full, otherwise why it was given up on
         };
 
         struct [[deprecated("use 'Global::DownloadInfo' instead, which is more universal")]] CurlProgressPtr {
             CURL *curl;                    // Easy interface pointer
-            std::vector<CurlDlStats> stat; // Download statistics struct
             std::string url;               // The URL in question
             std::string file_dest;         // The destination of where the download is being saved to disk
             bool timer_set;                // Whether the timer, 'timer_begin' has been set for this object or not
@@ -431,6 +588,8 @@ namespace GekkoFyre {
             std::string hash_val_given;          // The value of the hash, if a type is specified in 'CurlDlInfo::hash_type', given by the user
             std::string hash_val_rtrnd;          // Same as above, but calculated from the local file when, presumably, successfully downloaded
             GekkoFyre::HashVerif hash_succ_type; // Whether the calculated hash matched the given hash or not
+            std::vector<std::string> mirrors;    // Further URLs of the same file (such as from a Metalink), fetched from alongside 'ext_info.effective_url'
+            std::vector<SegmentRange> segments;  // How far along each segment of an unfinished download is, or empty if it has none
         };
 
         struct CurlInit {
@@ -438,6 +597,12 @@ namespace GekkoFyre {
             MemoryStruct mem_chunk;
             FileStream file_buf;
             CurlProgressPtr prog;
+            std::string conn_id;                  // The key of this handle itself, within 'CurlMulti::eh_vec'
+            std::string monitor_id;               // The key of the download this handle belongs to, within 'CurlMulti::transfer_monitoring'
+            std::shared_ptr<CurlSegment> segment; // The byte-range fetched by this handle, or 'nullptr' if it fetches the whole file
+            std::shared_ptr<Mirror> mirror;       // The mirror this handle is fetching from
+            std::shared_ptr<GkBw::Flow> bw_flow;  // This handle's share of the global bandwidth
+            curl_off_t bw_rate;                   // The rate last given to 'CURLOPT_MAX_RECV_SPEED_LARGE', or '0' for no limit
         };
     }
 
@@ -45,14 +45,24 @@
 #include "./../default_var.hpp"
 #include "./../curl_multi.hpp"
 #include "./../curl_easy.hpp"
+#include "./../curl_probe.hpp"
 #include "./../../utils/fast-cpp-csv-parser/csv.h"
 #include <boost/filesystem.hpp>
 #include <boost/exception/all.hpp>
 #include <exception>
 #include <stdexcept>
+#include <deque>
+#include <future>
+#include <chrono>
+#include <algorithm>
 #include <QMessageBox>
+#include <QProgressDialog>
+#include <QCoreApplication>
 #include <QFileDialog>
 #include <QDir>
+#include <QFile>
+#include <QRegExp>
+#include <QXmlStreamReader>
 
 namespace fs = boost::filesystem;
 AddURL::AddURL(const GekkoFyre::GkFile::FileDb &database, QWidget *parent) :
@@ -210,143 +220,388 @@ void AddURL::on_buttonBox_accepted()
                                      0, 0, 0, 0, GekkoFyre::DownloadStatus::Stopped, gk_torrent_data.general.magnet_uri, gk_torrent_data.general.down_dest,
                                      GekkoFyre::HashType::None, "", 0, true, "", gk_torrent_data.general.unique_id, GekkoFyre::DownloadType::Torrent);
                     return AddURL::done(QDialog::Accepted);
+                } else if (boost_csv_file.extension().string() == ".meta4" ||
+                        boost_csv_file.extension().string() == ".metalink") {
+                    // #############################
+                    // # Process the Metalink file #
+                    // #############################
+                    importMetalink(csv_file, ui->file_dest_lineEdit->text());
+                    return AddURL::done(QDialog::Accepted);
                 } else {
                     // ########################
                     // # Process the CSV file #
                     // ########################
-                    io::CSVReader<URL_ADD_CSV_NUM_COLS> in(csv_file.toStdString());
-                    in.read_header(io::ignore_missing_column, URL_ADD_CSV_FIELD_URL, URL_ADD_CSV_FIELD_DEST, URL_ADD_CSV_FIELD_HASH); // If a column with a name is not in the file but is in the argument list, then read_row will not modify the corresponding variable.
-                    if (!in.has_column(URL_ADD_CSV_FIELD_URL)) {
-                        throw std::invalid_argument(tr("Error reading CSV file! Is it formatted correctly?\n\n%1")
-                                                            .arg(csv_file).toStdString());
-                    }
+                    importCsvFile(csv_file, ui->file_dest_lineEdit->text());
+                    return AddURL::done(QDialog::Accepted);
+                }
+            }
+        } catch (const std::exception &e) {
+            QMessageBox::warning(this, tr("Error!"), QString("%1").arg(e.what()), QMessageBox::Ok);
+            return AddURL::done(QDialog::Rejected);
+        }
+    }
+}
 
-                    QString csv_file_dest = ui->file_dest_lineEdit->text();
-                    if (!in.has_column(URL_ADD_CSV_FIELD_DEST) && csv_file_dest.isEmpty()) {
-                        throw std::invalid_argument(tr("No destination provided either in dialog or CSV file!")
-                                                            .toStdString());
-                    }
+/**
+ * @brief AddURL::importCsvFile imports a (potentially very large) list of URLs from a CSV file. Rows are read in as they
+ * are needed rather than all at once, and the URLs are probed concurrently through the shared probing service, with no
+ * more than 'FYREDL_IMPORT_PROBE_WINDOW' of them outstanding at any one time. The results are handed over in batches of
+ * 'FYREDL_IMPORT_BATCH_SIZE', to be inserted into the model and committed to the database together, whilst the
+ * GUI is kept responsive throughout.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-24
+ * @note <https://github.com/ben-strasser/fast-cpp-csv-parser>
+ * @param csv_file The CSV file to import.
+ * @param csv_file_dest The directory to download to, should the CSV file not specify a destination itself.
+ */
+void AddURL::importCsvFile(const QString &csv_file, const QString &csv_file_dest)
+{
+    io::CSVReader<URL_ADD_CSV_NUM_COLS> in(csv_file.toStdString());
+    in.read_header(io::ignore_missing_column, URL_ADD_CSV_FIELD_URL, URL_ADD_CSV_FIELD_DEST, URL_ADD_CSV_FIELD_HASH,
+                   URL_ADD_CSV_FIELD_MIRRORS); // If a column with a name is not in the file but is in the argument list, then read_row will not modify the corresponding variable.
+    if (!in.has_column(URL_ADD_CSV_FIELD_URL)) {
+        throw std::invalid_argument(tr("Error reading CSV file! Is it formatted correctly?\n\n%1")
+                                            .arg(csv_file).toStdString());
+    }
 
-                    struct CsvImport {
-                        std::string url;
-                        std::string dest;
-                        std::string hash;
-                    };
-
-                    std::vector<CsvImport> csv_vec;
-                    std::string url, dest, hash = { "" };
-                    bool has_col_hash = false;
-                    if (in.has_column(URL_ADD_CSV_FIELD_HASH)) { has_col_hash = true; }
-
-                    while (in.read_row(url, dest, hash)) {
-                        // Handle the imported CSV data
-                        CsvImport csv_import;
-                        csv_import.url = url;
-                        csv_import.dest = dest;
-
-                        // Set default values for the hash(es), only, if none specified by the user
-                        if (has_col_hash) {
-                            csv_import.hash = hash;
-                        } else {
-                            csv_import.hash = "";
-                        }
+    const bool has_col_dest = in.has_column(URL_ADD_CSV_FIELD_DEST);
+    const bool has_col_hash = in.has_column(URL_ADD_CSV_FIELD_HASH);
+    const bool has_col_mirrors = in.has_column(URL_ADD_CSV_FIELD_MIRRORS);
+    if (!has_col_dest && csv_file_dest.isEmpty()) {
+        throw std::invalid_argument(tr("No destination provided either in dialog or CSV file!")
+                                            .toStdString());
+    }
 
-                        // Temporarily push the struct, CsvImport, onto the std::vector<CsvImport>()
-                        csv_vec.push_back(csv_import);
-                    }
+    QProgressDialog progress(tr("Importing URLs..."), tr("Cancel"), 0, 0, this);
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(500);
+
+    std::deque<std::pair<CsvImport, std::future<GekkoFyre::GkCurl::CurlInfoExt>>> in_flight;
+    std::vector<GekkoFyre::GkCurl::CurlDlInfo> batch;
+    batch.reserve(FYREDL_IMPORT_BATCH_SIZE);
+    size_t imported = 0;
+    bool rows_left = true;
+
+    while (rows_left || !in_flight.empty()) {
+        // Keep the window of probes full, reading in only as many rows as are needed to do so
+        while (rows_left && in_flight.size() < (size_t)FYREDL_IMPORT_PROBE_WINDOW) {
+            CsvImport row;
+            if (!in.read_row(row.url, row.dest, row.hash, row.mirrors)) {
+                rows_left = false;
+                break;
+            }
 
-                    // Process the now imported CSV data from std::vector<CsvImport>()
-                    for (size_t i = 0; i < csv_vec.size(); ++i) {
-                        // Check that the file exists with a '200' return code from the web-server
-                        info = GekkoFyre::CurlEasy::verifyFileExists(QString::fromStdString(csv_vec.at(i).url));
-                        if (info.response_code == 200) {
-                            // ###############
-                            // The URL exists!
-                            // ###############
+            if (!has_col_dest) { row.dest.clear(); }
+            if (!has_col_hash) { row.hash.clear(); }
+            if (!has_col_mirrors) { row.mirrors.clear(); }
 
-                            // Now check it for more detailed information
-                            info_ext = GekkoFyre::CurlEasy::curlGrabInfo(QString::fromStdString(csv_vec.at(i).url));
+            std::future<GekkoFyre::GkCurl::CurlInfoExt> probe = GekkoFyre::GkCurlProbe::instance().probe(row.url);
+            in_flight.emplace_back(std::move(row), std::move(probe));
+        }
 
-                            dl_info.unique_id = routines->createId(FYREDL_UNIQUE_ID_DIGIT_COUNT);
-                            dl_info.dlStatus = GekkoFyre::DownloadStatus::Stopped;
+        if (in_flight.empty()) {
+            break;
+        }
 
-                            // Make one final check and assign the appropriate values
-                            if (in.has_column(URL_ADD_CSV_FIELD_DEST)) {
-                                dl_info.file_loc = csv_vec.at(i).dest;
-                            } else if (!csv_file_dest.isEmpty()) {
-                                std::ostringstream oss_path;
-                                oss_path << csv_file_dest.toStdString() << fs::path::preferred_separator
-                                         << routines->extractFilename(QString::fromStdString(info_ext.effective_url)).toStdString();
-                                dl_info.file_loc = oss_path.str();
-                            } else {
-                                throw std::invalid_argument(tr("No destination specified for: %1")
-                                                                    .arg(QString::fromStdString(csv_vec.at(i).url))
-                                                                    .toStdString());
-                            }
+        // Results are taken in the same order as the rows they came from, whilst the probes behind the oldest one carry on
+        std::future<GekkoFyre::GkCurl::CurlInfoExt> &probe = in_flight.front().second;
+        while (probe.wait_for(std::chrono::milliseconds(50)) != std::future_status::ready) {
+            QCoreApplication::processEvents();
+        }
 
-                            if (!csv_vec.at(i).hash.empty()) {
-                                dl_info.hash_type = GekkoFyre::HashType::CannotDetermine;
-                                dl_info.hash_val_given = csv_vec.at(i).hash;
-                            } else {
-                                dl_info.hash_type = GekkoFyre::HashType::None;
-                                dl_info.hash_val_given = "";
-                            }
+        batch.push_back(importRow(in_flight.front().first, probe.get(), csv_file_dest));
+        in_flight.pop_front();
+        ++imported;
 
-                            // Save this more detailed information
-                            dl_info.ext_info.content_length = info_ext.content_length;
-                            dl_info.ext_info.effective_url = info_ext.effective_url;
-                            dl_info.ext_info.response_code = info_ext.response_code;
-                            dl_info.ext_info.status_ok = info_ext.status_ok;
-                            dl_info.insert_timestamp = 0;
-                        } else {
-                            // #####################################
-                            // The URL does not exist! It's invalid.
-                            // #####################################
-                            dl_info.dlStatus = GekkoFyre::DownloadStatus::Invalid;
-                            dl_info.unique_id = routines->createId(FYREDL_UNIQUE_ID_DIGIT_COUNT);
+        if (batch.size() >= (size_t)FYREDL_IMPORT_BATCH_SIZE) {
+            emit sendDetailsBatch(batch);
+            batch.clear();
+            progress.setLabelText(tr("Importing URLs... %1 done so far.").arg(imported));
+            QCoreApplication::processEvents();
+        }
 
-                            if (!csv_file_dest.isEmpty()) {
-                                std::ostringstream oss_path;
-                                oss_path << csv_file_dest.toStdString() << fs::path::preferred_separator
-                                         << routines->extractFilename(QString::fromStdString(info_ext.effective_url)).toStdString();
-                                dl_info.file_loc = oss_path.str();
-                            } else if (in.has_column(URL_ADD_CSV_FIELD_DEST)) {
-                                dl_info.file_loc = csv_vec.at(i).dest;
-                            }
+        if (progress.wasCanceled()) {
+            // Whatever has already been probed is still imported, but no more rows are read in
+            rows_left = false;
+        }
+    }
 
-                            if (!csv_vec.at(i).hash.empty()) {
-                                dl_info.hash_type = GekkoFyre::HashType::CannotDetermine;
-                                dl_info.hash_val_given = csv_vec.at(i).hash;
-                            } else {
-                                dl_info.hash_type = GekkoFyre::HashType::None;
-                                dl_info.hash_val_given = "";
-                            }
+    if (!batch.empty()) {
+        emit sendDetailsBatch(batch);
+    }
 
-                            dl_info.ext_info.content_length = 0;
-                            dl_info.ext_info.effective_url = csv_vec.at(i).url;
-                            dl_info.ext_info.response_code = info.response_code;
-                            dl_info.ext_info.status_ok = false;
-                            dl_info.insert_timestamp = 0;
-                        }
+    return;
+}
 
-                        // Send any new details to the QTableView model/view routines, whereupon 'ui->downloadView' is
-                        // updated with the latest data.
-                        emit sendDetails(dl_info.ext_info.effective_url, dl_info.ext_info.content_length, 0, 0, 0,
-                                         0, dl_info.dlStatus, dl_info.ext_info.effective_url, dl_info.file_loc,
-                                         dl_info.hash_type, dl_info.hash_val_given, dl_info.ext_info.response_code,
-                                         dl_info.ext_info.status_ok, "", dl_info.unique_id, GekkoFyre::DownloadType::HTTP);
-                    }
+/**
+ * @brief AddURL::importRow works out the details of a single download from its row within the imported CSV file, and
+ * the outcome of probing its URL.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-24
+ * @param row The row, as read from the CSV file.
+ * @param info_ext The outcome of probing the URL given by the row.
+ * @param csv_file_dest The directory to download to, should the row not specify a destination itself.
+ * @return The details of the download, ready to be inserted.
+ */
+GekkoFyre::GkCurl::CurlDlInfo AddURL::importRow(const CsvImport &row, const GekkoFyre::GkCurl::CurlInfoExt &info_ext,
+                                                const QString &csv_file_dest)
+{
+    GekkoFyre::GkCurl::CurlDlInfo dl_info;
+    dl_info.unique_id = routines->createId(FYREDL_UNIQUE_ID_DIGIT_COUNT);
+    dl_info.insert_timestamp = 0;
+
+    // Check that the file exists with a '200' return code from the web-server
+    const bool exists = (info_ext.status_ok && info_ext.response_code == 200);
+    if (exists) {
+        dl_info.dlStatus = GekkoFyre::DownloadStatus::Stopped;
+        dl_info.ext_info.content_length = info_ext.content_length;
+        dl_info.ext_info.effective_url = info_ext.effective_url;
+        dl_info.ext_info.status_ok = true;
+    } else {
+        // The URL does not exist! It's invalid.
+        dl_info.dlStatus = GekkoFyre::DownloadStatus::Invalid;
+        dl_info.ext_info.content_length = 0;
+        dl_info.ext_info.effective_url = row.url;
+        dl_info.ext_info.status_ok = false;
+    }
 
-                    // Clear the 'temporary' struct-holding std::vector<CsvImport>()
-                    csv_vec.clear();
-                    return AddURL::done(QDialog::Accepted);
+    dl_info.ext_info.response_code = info_ext.response_code;
+
+    // Make one final check and assign the appropriate values
+    if (!row.dest.empty()) {
+        dl_info.file_loc = row.dest;
+    } else if (!csv_file_dest.isEmpty()) {
+        std::ostringstream oss_path;
+        oss_path << csv_file_dest.toStdString() << fs::path::preferred_separator
+                 << routines->extractFilename(QString::fromStdString(dl_info.ext_info.effective_url)).toStdString();
+        dl_info.file_loc = oss_path.str();
+    } else {
+        throw std::invalid_argument(tr("No destination specified for: %1").arg(QString::fromStdString(row.url))
+                                            .toStdString());
+    }
+
+    if (!row.hash.empty()) {
+        dl_info.hash_type = GekkoFyre::HashType::CannotDetermine;
+        dl_info.hash_val_given = row.hash;
+    } else {
+        dl_info.hash_type = GekkoFyre::HashType::None;
+        dl_info.hash_val_given = "";
+    }
+
+    const QStringList mirrors = QString::fromStdString(row.mirrors).split(QRegExp("\\s+"), QString::SkipEmptyParts);
+    for (const auto &mirror: mirrors) {
+        if (mirror.toStdString() != dl_info.ext_info.effective_url && mirror.toStdString() != row.url) {
+            dl_info.mirrors.push_back(mirror.toStdString());
+        }
+    }
+
+    return dl_info;
+}
+
+/**
+ * @brief AddURL::importMetalink imports every file described by a Metalink, each as a single download that is fetched
+ * from all of its mirrors at once. Of the URLs given for a file, the most preferred one that responds becomes the
+ * download's own URL and the rest are kept as its mirrors. Any checksum given is kept too, so that the download may be
+ * verified once it has finished.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-30
+ * @note <https://tools.ietf.org/html/rfc5854>
+ * @param metalink_file The Metalink file to import, whether it be of version 3.0 ('.metalink') or 4.0 ('.meta4').
+ * @param file_dest The directory to download to.
+ */
+void AddURL::importMetalink(const QString &metalink_file, const QString &file_dest)
+{
+    if (file_dest.isEmpty()) {
+        throw std::invalid_argument(tr("No destination provided for the Metalink file!").toStdString());
+    }
+
+    std::vector<MetalinkFile> files = parseMetalink(metalink_file);
+    if (files.empty()) {
+        throw std::invalid_argument(tr("The Metalink file does not describe any files that can be downloaded!\n\n%1")
+                                            .arg(metalink_file).toStdString());
+    }
+
+    QProgressDialog progress(tr("Importing Metalink..."), tr("Cancel"), 0, 0, this);
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(500);
+
+    // The most preferred URL of every file is probed all at once, with the others only being tried should it fail
+    std::vector<std::future<GekkoFyre::GkCurl::CurlInfoExt>> probes;
+    for (const auto &file: files) {
+        probes.push_back(GekkoFyre::GkCurlProbe::instance().probe(file.urls.front().second));
+    }
+
+    std::vector<GekkoFyre::GkCurl::CurlDlInfo> batch;
+    for (size_t i = 0; i < files.size() && !progress.wasCanceled(); ++i) {
+        const MetalinkFile &file = files.at(i);
+        size_t chosen = 0;
+        GekkoFyre::GkCurl::CurlInfoExt info_ext;
+        for (;;) {
+            std::future<GekkoFyre::GkCurl::CurlInfoExt> probe = (chosen == 0) ? std::move(probes.at(i)) :
+                    GekkoFyre::GkCurlProbe::instance().probe(file.urls.at(chosen).second);
+            while (probe.wait_for(std::chrono::milliseconds(50)) != std::future_status::ready) {
+                QCoreApplication::processEvents();
+            }
+
+            info_ext = probe.get();
+            if ((info_ext.status_ok && info_ext.response_code == 200) || (chosen + 1) >= file.urls.size()) {
+                break;
+            }
+
+            ++chosen;
+        }
+
+        GekkoFyre::GkCurl::CurlDlInfo dl_info;
+        dl_info.unique_id = routines->createId(FYREDL_UNIQUE_ID_DIGIT_COUNT);
+        dl_info.insert_timestamp = 0;
+        dl_info.ext_info.response_code = info_ext.response_code;
+        if (info_ext.status_ok && info_ext.response_code == 200) {
+            dl_info.dlStatus = GekkoFyre::DownloadStatus::Stopped;
+            dl_info.ext_info.content_length = (info_ext.content_length > 0) ? info_ext.content_length : file.size;
+            dl_info.ext_info.effective_url = info_ext.effective_url;
+            dl_info.ext_info.status_ok = true;
+        } else {
+            // Not one of the URLs could be reached
+            dl_info.dlStatus = GekkoFyre::DownloadStatus::Invalid;
+            dl_info.ext_info.content_length = file.size;
+            dl_info.ext_info.effective_url = file.urls.front().second;
+            dl_info.ext_info.status_ok = false;
+            chosen = 0;
+        }
+
+        for (size_t j = 0; j < file.urls.size(); ++j) {
+            if (j != chosen) {
+                dl_info.mirrors.push_back(file.urls.at(j).second);
+            }
+        }
+
+        // The name given by the Metalink is not trusted to stay within the destination directory
+        std::string file_name = fs::path(file.name).filename().string();
+        if (file_name.empty() || file_name == "." || file_name == "..") {
+            file_name = routines->extractFilename(QString::fromStdString(dl_info.ext_info.effective_url)).toStdString();
+        }
+
+        std::ostringstream oss_path;
+        oss_path << file_dest.toStdString() << fs::path::preferred_separator << file_name;
+        dl_info.file_loc = oss_path.str();
+
+        dl_info.hash_type = file.hash_type;
+        dl_info.hash_val_given = file.hash;
+        batch.push_back(dl_info);
+    }
+
+    if (!batch.empty()) {
+        emit sendDetailsBatch(batch);
+    }
+
+    return;
+}
+
+/**
+ * @brief AddURL::parseMetalink reads in the files described by a Metalink, of either version 3.0 or 4.0. Only URLs that
+ * may be downloaded over HTTP(S) or FTP(S) are kept, ranked in the order of preference given by the Metalink itself, and
+ * of the checksums given for each file only the strongest is kept.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-30
+ * @note <https://tools.ietf.org/html/rfc5854>
+ *       <http://www.metalinker.org/Metalink_3.0_Spec.pdf>
+ *       <http://doc.qt.io/qt-5/qxmlstreamreader.html>
+ * @param metalink_file The Metalink file to read in.
+ * @return Every file within the Metalink that has at least one URL.
+ */
+std::vector<AddURL::MetalinkFile> AddURL::parseMetalink(const QString &metalink_file)
+{
+    QFile file(metalink_file);
+    if (!file.open(QIODevice::ReadOnly)) {
+        throw std::invalid_argument(tr("Unable to open the Metalink file!\n\n%1").arg(metalink_file).toStdString());
+    }
+
+    // The weaker checksums are only kept should nothing stronger be given
+    auto hash_strength = [](const GekkoFyre::HashType &hash_type) -> int {
+        switch (hash_type) {
+            case GekkoFyre::HashType::MD5: return 1;
+            case GekkoFyre::HashType::SHA1: return 2;
+            case GekkoFyre::HashType::SHA256: return 3;
+            case GekkoFyre::HashType::SHA3_256: return 4;
+            case GekkoFyre::HashType::SHA512: return 5;
+            case GekkoFyre::HashType::SHA3_512: return 6;
+            default: return 0;
+        }
+    };
+
+    std::vector<MetalinkFile> files;
+    QXmlStreamReader xml(&file);
+    while (!xml.atEnd()) {
+        xml.readNext();
+        if (!xml.isStartElement()) {
+            continue;
+        }
+
+        if (xml.name() == QLatin1String("file")) {
+            MetalinkFile item;
+            item.name = xml.attributes().value(QLatin1String("name")).toString().toStdString();
+            item.size = 0;
+            item.hash_type = GekkoFyre::HashType::None;
+            files.push_back(item);
+        } else if (!files.empty()) {
+            MetalinkFile &item = files.back();
+            if (xml.name() == QLatin1String("size")) {
+                item.size = xml.readElementText().trimmed().toDouble();
+            } else if (xml.name() == QLatin1String("hash") && xml.attributes().hasAttribute(QLatin1String("type"))) {
+                // Version 3.0 names them as 'sha256', whereas version 4.0 names them as 'sha-256'
+                QString type = xml.attributes().value(QLatin1String("type")).toString().trimmed().toUpper();
+                if (type.startsWith("SHA") && !type.startsWith("SHA3") && !type.startsWith("SHA-")) {
+                    type.insert(3, '-');
+                }
+
+                const GekkoFyre::HashType hash_type = routines->convHashType_StringToEnum(type);
+                // Checksums are worked out (and compared) in lowercase hexadecimal, whereas a Metalink may give them in
+                // either case
+                const QString value = xml.readElementText().trimmed().toLower();
+                if (!value.isEmpty() && hash_strength(hash_type) > hash_strength(item.hash_type)) {
+                    item.hash_type = hash_type;
+                    item.hash = value.toStdString();
+                }
+            } else if (xml.name() == QLatin1String("url")) {
+                // Version 4.0 ranks by 'priority', from 1 being the most preferred, whereas version 3.0 ranks by
+                // 'preference', from 100 being the most preferred
+                int rank = 999999;
+                bool ok = false;
+                if (xml.attributes().hasAttribute(QLatin1String("priority"))) {
+                    const int priority = xml.attributes().value(QLatin1String("priority")).toInt(&ok);
+                    if (ok) { rank = priority; }
+                } else if (xml.attributes().hasAttribute(QLatin1String("preference"))) {
+                    const int preference = xml.attributes().value(QLatin1String("preference")).toInt(&ok);
+                    if (ok) { rank = (101 - preference); }
+                }
+
+                const QString url = xml.readElementText().trimmed();
+                const QString scheme = QUrl(url).scheme().toLower();
+                if (scheme == "http" || scheme == "https" || scheme == "ftp" || scheme == "ftps") {
+                    item.urls.push_back(std::make_pair(rank, url.toStdString()));
                 }
             }
-        } catch (const std::exception &e) {
-            QMessageBox::warning(this, tr("Error!"), QString("%1").arg(e.what()), QMessageBox::Ok);
-            return AddURL::done(QDialog::Rejected);
         }
     }
+
+    if (xml.hasError()) {
+        throw std::invalid_argument(tr("Error reading Metalink file! Is it formatted correctly?\n\n%1\n\n%2")
+                                            .arg(metalink_file).arg(xml.errorString()).toStdString());
+    }
+
+    std::vector<MetalinkFile> usable;
+    for (auto &item: files) {
+        if (item.urls.empty()) {
+            continue;
+        }
+
+        std::stable_sort(item.urls.begin(), item.urls.end(),
+                         [](const std::pair<int, std::string> &a, const std::pair<int, std::string> &b) {
+                             return a.first < b.first; });
+        usable.push_back(item);
+    }
+
+    return usable;
 }
 
 void AddURL::on_buttonBox_rejected()
@@ -377,7 +632,7 @@ void AddURL::on_file_import_toolButton_clicked()
 {
     QString csv_dir = QFileDialog::getOpenFileName(this, tr("Choose file to import..."),
                                                    QDir::homePath(),
-                                                   tr("BitTorrent (*.torrent);;Comma Separated Values (*.csv *.txt);;All Files (*.*)"),
+                                                   tr("BitTorrent (*.torrent);;Metalink (*.meta4 *.metalink);;Comma Separated Values (*.csv *.txt);;All Files (*.*)"),
                                                    nullptr, QFileDialog::DontResolveSymlinks);
     ui->file_import_lineEdit->setText(csv_dir);
     return;
@@ -45,6 +45,7 @@
 
 #include "./../cmnroutines.hpp"
 #include <memory>
+#include <vector>
 #include <QDialog>
 #include <QString>
 
@@ -75,12 +76,34 @@ signals:
                      const std::string &hash_val, const long long &resp_code, const bool &stat_ok,
                      const std::string &stat_msg, const std::string &unique_id,
                      const GekkoFyre::DownloadType &down_type);
+    void sendDetailsBatch(const std::vector<GekkoFyre::GkCurl::CurlDlInfo> &dl_info);
 
 private:
     Ui::AddURL *ui;
     std::shared_ptr<GekkoFyre::CmnRoutines> routines;
 
+    struct CsvImport {
+        std::string url;
+        std::string dest;
+        std::string hash;
+        std::string mirrors;
+    };
+
+    // A single file as described by a Metalink, along with every URL it may be downloaded from
+    struct MetalinkFile {
+        std::string name;
+        double size;
+        GekkoFyre::HashType hash_type;
+        std::string hash;
+        std::vector<std::pair<int, std::string>> urls; // Ranked by priority, with the lowest rank being the most preferred
+    };
+
     QString browseForDir();
+    void importCsvFile(const QString &csv_file, const QString &csv_file_dest);
+    void importMetalink(const QString &metalink_file, const QString &file_dest);
+    std::vector<MetalinkFile> parseMetalink(const QString &metalink_file);
+    GekkoFyre::GkCurl::CurlDlInfo importRow(const CsvImport &row, const GekkoFyre::GkCurl::CurlInfoExt &info_ext,
+                                            const QString &csv_file_dest);
 };
 
 #endif // ADDURL_HPP
@@ -54,6 +54,7 @@
 #include <cmath>
 #include <fstream>
 #include <iostream>
+#include <unordered_map>
 #include <qmetatype.h>
 #include <QInputDialog>
 #include <QModelIndex>
@@ -66,6 +67,7 @@
 #include <QShortcut>
 #include <QUrl>
 #include <QDir>
+#include <QFileInfo>
 #include <QDateTime>
 #include <QDate>
 #include <QHash>
@@ -86,11 +88,18 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::MainWi
     curl_multi = new GekkoFyre::CurlMulti();
     gk_torrent_client = new GekkoFyre::GkTorrentClient(database, this);
 
+    hash_service = new GekkoFyre::GkHashService(this);
+    QObject::connect(hash_service, SIGNAL(sendHashProgress(QString,qint64,qint64)), this, SLOT(recvHashProgress(QString,qint64,qint64)));
+    QObject::connect(hash_service, SIGNAL(sendHashFinished(QString,GekkoFyre::GkFile::FileHash)), this, SLOT(recvHashFinished(QString,GekkoFyre::GkFile::FileHash)));
+    QObject::connect(hash_service, SIGNAL(sendHashError(QString,QString)), this, SLOT(recvHashError(QString,QString)));
+
     // http://wiki.qt.io/QThreads_general_usage
     // https://mayaposch.wordpress.com/2011/11/01/how-to-really-truly-use-qthreads-the-full-explanation/
     curl_multi_thread = new QThread;
     curl_multi->moveToThread(curl_multi_thread);
-    QObject::connect(this, SIGNAL(sendStartDownload(QString,QString,bool)), curl_multi, SLOT(recvNewDl(QString,QString,bool)));
+    qRegisterMetaType<GekkoFyre::HashType>("GekkoFyre::HashType");
+    qRegisterMetaType<std::vector<GekkoFyre::GkCurl::SegmentRange>>("std::vector<GekkoFyre::GkCurl::SegmentRange>");
+    QObject::connect(this, SIGNAL(sendStartDownload(QString,QString,bool,double,bool,GekkoFyre::HashType,QStringList,std::vector<GekkoFyre::GkCurl::SegmentRange>)), curl_multi, SLOT(recvNewDl(QString,QString,bool,double,bool,GekkoFyre::HashType,QStringList,std::vector<GekkoFyre::GkCurl::SegmentRange>)));
     // QObject::connect(this, SIGNAL(sendStopDownload(QString)), curl_multi, SLOT(recvStopDl(QString)));
     QObject::connect(this, SIGNAL(finish_curl_multi_thread()), curl_multi_thread, SLOT(quit()));
     QObject::connect(this, SIGNAL(finish_curl_multi_thread()), curl_multi, SLOT(deleteLater()));
@@ -111,6 +120,11 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::MainWi
     QObject::connect(ui->downloadView, SIGNAL(customContextMenuRequested(QPoint)), this, SLOT(on_downloadView_customContextMenuRequested(QPoint)));
     QObject::connect(this, SIGNAL(updateDlStats()), this, SLOT(manageDlStats()));
 
+    // However often the transfer statistics arrive, the GUI is only updated with them so often
+    xfer_stats_timer = new QTimer(this);
+    QObject::connect(xfer_stats_timer, SIGNAL(timeout()), this, SLOT(drainXferStats()));
+    xfer_stats_timer->start(FYREDL_STATS_DRAIN_INTERVAL);
+
     try {
         readFromHistoryFile();
     } catch (const std::exception &e) {
@@ -183,6 +197,8 @@ void MainWindow::addDownload()
     QPointer<AddURL> add_url = new AddURL(database, this);
     QObject::connect(add_url, SIGNAL(sendDetails(std::string,double,int,double,int,int,GekkoFyre::DownloadStatus,std::string,std::string,GekkoFyre::HashType,std::string,long long,bool,std::string,std::string,GekkoFyre::DownloadType)),
                      this, SLOT(sendDetails(std::string,double,int,double,int,int,GekkoFyre::DownloadStatus,std::string,std::string,GekkoFyre::HashType,std::string,long long,bool,std::string,std::string,GekkoFyre::DownloadType)));
+    QObject::connect(add_url, SIGNAL(sendDetailsBatch(std::vector<GekkoFyre::GkCurl::CurlDlInfo>)),
+                     this, SLOT(recvDetailsBatch(std::vector<GekkoFyre::GkCurl::CurlDlInfo>)));
     add_url->setAttribute(Qt::WA_DeleteOnClose, true);
     add_url->open();
     return;
@@ -197,8 +213,7 @@ void MainWindow::readFromHistoryFile()
 {
     std::vector<GekkoFyre::GkCurl::CurlDlInfo> dl_history;
     std::vector<GekkoFyre::GkTorrent::TorrentInfo> gk_torrent_history;
-    dl_history = routines->readCurlItems();
-    gk_torrent_history = routines->readTorrentItems(true);
+    routines->readHistory(dl_history, gk_torrent_history, true);
 
     dlModel->removeRows(0, (int)dl_history.size(), QModelIndex());
     for (size_t i = 0; i < dl_history.size(); ++i) {
@@ -285,50 +300,99 @@ void MainWindow::insertNewRow(const std::string &fileName, const double &fileSiz
 {
     try {
         dlModel->insertRows(0, 1, QModelIndex());
+        setRowData(0, fileName, fileSize, downloaded, progress, upSpeed, downSpeed, status, url, destination, unique_id);
 
-        QModelIndex index = dlModel->index(0, MN_FILENAME_COL, QModelIndex());
-        dlModel->setData(index, routines->extractFilename(QString::fromStdString(fileName)), Qt::DisplayRole);
+        // Initialize the graphs
+        initCharts(QString::fromStdString(unique_id), QString::fromStdString(destination), download_type);
+        return;
+    } catch (const std::exception &e) {
+        QMessageBox::warning(this, tr("Error!"), QString("%1").arg(e.what()), QMessageBox::Ok);
+        return;
+    }
 
-        index = dlModel->index(0, MN_FILESIZE_COL, QModelIndex());
-        dlModel->setData(index, routines->numberConverter(fileSize), Qt::DisplayRole);
+    return;
+}
 
-        index = dlModel->index(0, MN_DOWNLOADED_COL, QModelIndex());
-        dlModel->setData(index, QString::number(downloaded), Qt::DisplayRole);
+/**
+ * @brief MainWindow::insertNewRows inserts a whole batch of HTTP(S)/FTP(S) downloads into 'downloadView' at once, as is
+ * done when importing a large list of URLs, with the model only being told of the new rows the once.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-24
+ * @param dl_info The downloads to insert. These end up in the same order as if each had been inserted with insertNewRow().
+ */
+void MainWindow::insertNewRows(const std::vector<GekkoFyre::GkCurl::CurlDlInfo> &dl_info)
+{
+    if (dl_info.empty()) {
+        return;
+    }
 
-        index = dlModel->index(0, MN_PROGRESS_COL, QModelIndex());
-        dlModel->setData(index, QString::number(progress), Qt::DisplayRole);
+    try {
+        const int rows = (int)dl_info.size();
+        dlModel->insertRows(0, rows, QModelIndex());
+        for (int i = 0; i < rows; ++i) {
+            const GekkoFyre::GkCurl::CurlDlInfo &item = dl_info.at((size_t)(rows - 1 - i));
+            setRowData(i, item.ext_info.effective_url, item.ext_info.content_length, 0, 0, 0, 0, item.dlStatus,
+                       item.ext_info.effective_url, item.file_loc, item.unique_id);
+        }
 
-        index = dlModel->index(0, MN_UPSPEED_COL, QModelIndex());
-        dlModel->setData(index, QString::number(upSpeed), Qt::DisplayRole);
+        for (const auto &item: dl_info) {
+            initCharts(QString::fromStdString(item.unique_id), QString::fromStdString(item.file_loc),
+                       GekkoFyre::DownloadType::HTTP);
+        }
+    } catch (const std::exception &e) {
+        QMessageBox::warning(this, tr("Error!"), QString("%1").arg(e.what()), QMessageBox::Ok);
+        return;
+    }
 
-        index = dlModel->index(0, MN_DOWNSPEED_COL, QModelIndex());
-        dlModel->setData(index, QString::number(downSpeed), Qt::DisplayRole);
+    return;
+}
 
-        index = dlModel->index(0, MN_SEEDERS_COL, QModelIndex());
-        dlModel->setData(index, tr("<N/A>"), Qt::DisplayRole);
+/**
+ * @brief MainWindow::setRowData fills in the columns of the given row within 'downloadView'.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-24
+ * @see MainWindow::insertNewRow(), MainWindow::insertNewRows()
+ */
+void MainWindow::setRowData(const int &row, const std::string &fileName, const double &fileSize, const int &downloaded,
+                            const double &progress, const int &upSpeed, const int &downSpeed,
+                            const GekkoFyre::DownloadStatus &status, const std::string &url,
+                            const std::string &destination, const std::string &unique_id)
+{
+    QModelIndex index = dlModel->index(row, MN_FILENAME_COL, QModelIndex());
+    dlModel->setData(index, routines->extractFilename(QString::fromStdString(fileName)), Qt::DisplayRole);
 
-        index = dlModel->index(0, MN_LEECHERS_COL, QModelIndex());
-        dlModel->setData(index, tr("<N/A>"), Qt::DisplayRole);
+    index = dlModel->index(row, MN_FILESIZE_COL, QModelIndex());
+    dlModel->setData(index, routines->numberConverter(fileSize), Qt::DisplayRole);
 
-        index = dlModel->index(0, MN_STATUS_COL, QModelIndex());
-        dlModel->setData(index, routines->convDlStat_toString(status), Qt::DisplayRole);
+    index = dlModel->index(row, MN_DOWNLOADED_COL, QModelIndex());
+    dlModel->setData(index, QString::number(downloaded), Qt::DisplayRole);
 
-        index = dlModel->index(0, MN_DESTINATION_COL, QModelIndex());
-        dlModel->setData(index, QString::fromStdString(destination), Qt::DisplayRole);
+    index = dlModel->index(row, MN_PROGRESS_COL, QModelIndex());
+    dlModel->setData(index, QString::number(progress), Qt::DisplayRole);
 
-        index = dlModel->index(0, MN_URL_COL, QModelIndex());
-        dlModel->setData(index, QString::fromStdString(url), Qt::DisplayRole);
+    index = dlModel->index(row, MN_UPSPEED_COL, QModelIndex());
+    dlModel->setData(index, QString::number(upSpeed), Qt::DisplayRole);
 
-        index = dlModel->index(0, MN_HIDDEN_UNIQUE_ID, QModelIndex());
-        dlModel->setData(index, QString::fromStdString(unique_id), Qt::DisplayRole);
+    index = dlModel->index(row, MN_DOWNSPEED_COL, QModelIndex());
+    dlModel->setData(index, QString::number(downSpeed), Qt::DisplayRole);
 
-        // Initialize the graphs
-        initCharts(QString::fromStdString(unique_id), QString::fromStdString(destination), download_type);
-        return;
-    } catch (const std::exception &e) {
-        QMessageBox::warning(this, tr("Error!"), QString("%1").arg(e.what()), QMessageBox::Ok);
-        return;
-    }
+    index = dlModel->index(row, MN_SEEDERS_COL, QModelIndex());
+    dlModel->setData(index, tr("<N/A>"), Qt::DisplayRole);
+
+    index = dlModel->index(row, MN_LEECHERS_COL, QModelIndex());
+    dlModel->setData(index, tr("<N/A>"), Qt::DisplayRole);
+
+    index = dlModel->index(row, MN_STATUS_COL, QModelIndex());
+    dlModel->setData(index, routines->convDlStat_toString(status), Qt::DisplayRole);
+
+    index = dlModel->index(row, MN_DESTINATION_COL, QModelIndex());
+    dlModel->setData(index, QString::fromStdString(destination), Qt::DisplayRole);
+
+    index = dlModel->index(row, MN_URL_COL, QModelIndex());
+    dlModel->setData(index, QString::fromStdString(url), Qt::DisplayRole);
+
+    index = dlModel->index(row, MN_HIDDEN_UNIQUE_ID, QModelIndex());
+    dlModel->setData(index, QString::fromStdString(unique_id), Qt::DisplayRole);
 
     return;
 }
@@ -405,7 +469,8 @@ void MainWindow::resetDlStateStartup()
         QModelIndex find_index = dlModel->index(i, MN_STATUS_COL);
         if (find_index.isValid()) {
             const QString stat_string = ui->downloadView->model()->data(find_index).toString();
-            if (stat_string == routines->convDlStat_toString(GekkoFyre::DownloadStatus::Downloading)) {
+            if (stat_string == routines->convDlStat_toString(GekkoFyre::DownloadStatus::Downloading) ||
+                    stat_string == routines->convDlStat_toString(GekkoFyre::DownloadStatus::Queued)) {
                 QModelIndex file_dest_index = dlModel->index(i, MN_DESTINATION_COL);
                 const QString file_dest_string = ui->downloadView->model()->data(file_dest_index).toString();
                 QModelIndex unique_id_index = dlModel->index(i, MN_HIDDEN_UNIQUE_ID);
@@ -485,25 +550,19 @@ void MainWindow::initCharts(const QString &unique_id, const QString &down_dest,
 
         if (download_type == GekkoFyre::DownloadType::HTTP || download_type == GekkoFyre::DownloadType::FTP) {
             // Download type is either HTTP or FTP
-            std::vector<GekkoFyre::GkCurl::CurlDlInfo> curl_dl_info = routines->readCurlItems();
-            for (size_t j = 0; j < curl_dl_info.size(); ++j) {
-                if (curl_dl_info.at(j).unique_id == unique_id.toStdString()) {
-                    graph_info.curl_info = curl_dl_info.at(j);
-                    graph_info.stats.content_length = graph_info.curl_info.value().ext_info.content_length;
-                    break;
-                }
+            GekkoFyre::GkCurl::CurlDlInfo curl_dl_info;
+            if (routines->findCurlItem(unique_id.toStdString(), curl_dl_info)) {
+                graph_info.curl_info = curl_dl_info;
+                graph_info.stats.content_length = graph_info.curl_info.value().ext_info.content_length;
             }
         } else if (download_type == GekkoFyre::DownloadType::Torrent ||
                 download_type == GekkoFyre::DownloadType::TorrentMagnetLink) {
             // Download type is BitTorrent
-            std::vector<GekkoFyre::GkTorrent::TorrentInfo> gk_torrent_info = routines->readTorrentItems(false);
-            for (size_t j = 0; j < gk_torrent_info.size(); ++j) {
-                if (gk_torrent_info.at(j).general.unique_id == graph_info.unique_id.toStdString()) {
-                    graph_info.to_info = gk_torrent_info.at(j);
-                    graph_info.stats.content_length = ((double)graph_info.to_info.value().general.num_pieces *
-                            (double)graph_info.to_info.value().general.piece_length);
-                    break;
-                }
+            GekkoFyre::GkTorrent::TorrentInfo gk_torrent_info;
+            if (routines->findTorrentItem(graph_info.unique_id.toStdString(), gk_torrent_info)) {
+                graph_info.to_info = gk_torrent_info;
+                graph_info.stats.content_length = ((double)graph_info.to_info.value().general.num_pieces *
+                        (double)graph_info.to_info.value().general.piece_length);
             }
         } else {
             throw std::invalid_argument(tr("An invalid download type has been given!").toStdString());
@@ -581,70 +640,68 @@ void MainWindow::contentsView_update()
                                     gk_dl_info_cache.at(k).dl_type == GekkoFyre::DownloadType::TorrentMagnetLink) {
 
                                 // Read the XML data into memory
-                                std::vector<GekkoFyre::GkTorrent::TorrentInfo> gk_ti = routines->readTorrentItems(false);
+                                GekkoFyre::GkTorrent::TorrentInfo gk_ti;
                                 std::ostringstream oss_data;
-                                for (size_t i = 0; i < gk_ti.size(); ++i) {
-                                    if (gk_ti.at(i).general.unique_id == unique_id.toStdString()) {
-                                        QHash <QString, QPair<QString, QString>> columnData; // <root, <child, parent>>
-                                        std::vector<GekkoFyre::GkTorrent::TorrentFile> gk_tf_vec = gk_ti.at(i).files_vec;
-
-                                        for (size_t j = 0; j < gk_tf_vec.size(); ++j) {
-                                            GekkoFyre::GkTorrent::TorrentFile gk_tf_element = gk_tf_vec.at(j);
-                                            fs::path boost_path(gk_tf_element.file_path);
-
-                                            // Process the XML data
-                                            for (auto &indice: boost_path) {
-                                                QString cv_root = QString::fromStdString(boost_path.parent_path().string());
-                                                columnData.insertMulti(cv_root, qMakePair(QString::fromStdString(indice.string()), cv_root));
-                                            }
+                                if (routines->findTorrentItem(unique_id.toStdString(), gk_ti)) {
+                                    QHash <QString, QPair<QString, QString>> columnData; // <root, <child, parent>>
+                                    std::vector<GekkoFyre::GkTorrent::TorrentFile> gk_tf_vec = gk_ti.files_vec;
+
+                                    for (size_t j = 0; j < gk_tf_vec.size(); ++j) {
+                                        GekkoFyre::GkTorrent::TorrentFile gk_tf_element = gk_tf_vec.at(j);
+                                        fs::path boost_path(gk_tf_element.file_path);
+
+                                        // Process the XML data
+                                        for (auto &indice: boost_path) {
+                                            QString cv_root = QString::fromStdString(boost_path.parent_path().string());
+                                            columnData.insertMulti(cv_root, qMakePair(QString::fromStdString(indice.string()), cv_root));
                                         }
+                                    }
 
-                                        QSet<QString> files_toProc; // <child, parent>, directories ready to be processed.
-                                        for (auto const &entry: columnData) {
-                                            // This will find all the directories and the appropriate column number for each directory.
-                                            QString child = entry.first;
-                                            QString parent = entry.second;
+                                    QSet<QString> files_toProc; // <child, parent>, directories ready to be processed.
+                                    for (auto const &entry: columnData) {
+                                        // This will find all the directories and the appropriate column number for each directory.
+                                        QString child = entry.first;
+                                        QString parent = entry.second;
 
-                                            fs::path boost_child_path(child.toStdString());
-                                            QString dir_name = QDir(parent).dirName();
+                                        fs::path boost_child_path(child.toStdString());
+                                        QString dir_name = QDir(parent).dirName();
 
-                                            if (boost_child_path.has_extension() && dir_name != child) {
-                                                // We are quite likely to have a file, and not a (sub-)directory
-                                                QString full_path = parent + fs::path::preferred_separator + child;
-                                                files_toProc.insert(full_path);
-                                            }
+                                        if (boost_child_path.has_extension() && dir_name != child) {
+                                            // We are quite likely to have a file, and not a (sub-)directory
+                                            QString full_path = parent + fs::path::preferred_separator + child;
+                                            files_toProc.insert(full_path);
                                         }
+                                    }
 
-                                        QList<QString> dirs_pair = files_toProc.values();
-
-                                        cV_model = new QStandardItemModel();
-                                        QStandardItem *topLevelItem = cV_model->invisibleRootItem();
+                                    QList<QString> dirs_pair = files_toProc.values();
 
-                                        // Iterate over each directory string
-                                        QStringList dir_list;
-                                        for (int j = 0; j < dirs_pair.size(); ++j) {
-                                            dir_list << dirs_pair.at(j);
-                                        }
+                                    cV_model = new QStandardItemModel();
+                                    QStandardItem *topLevelItem = cV_model->invisibleRootItem();
 
-                                        qSort(dir_list.begin(), dir_list.end());
-                                        for (auto const &item: dir_list) {
-                                            QStringList splitName = item.split(fs::path::preferred_separator);
+                                    // Iterate over each directory string
+                                    QStringList dir_list;
+                                    for (int j = 0; j < dirs_pair.size(); ++j) {
+                                        dir_list << dirs_pair.at(j);
+                                    }
 
-                                            // First part of the string is defo parent item
-                                            // Check to make sure not to add duplicate
-                                            if (cV_model->findItems(splitName[0], Qt::MatchFixedString).size() == 0) {
-                                                QStandardItem *parentItem = new QStandardItem(splitName[0]);
-                                                topLevelItem->appendRow(parentItem);
-                                            }
+                                    qSort(dir_list.begin(), dir_list.end());
+                                    for (auto const &item: dir_list) {
+                                        QStringList splitName = item.split(fs::path::preferred_separator);
 
-                                            cV_addItems(topLevelItem, splitName);
+                                        // First part of the string is defo parent item
+                                        // Check to make sure not to add duplicate
+                                        if (cV_model->findItems(splitName[0], Qt::MatchFixedString).size() == 0) {
+                                            QStandardItem *parentItem = new QStandardItem(splitName[0]);
+                                            topLevelItem->appendRow(parentItem);
                                         }
 
-                                        QStringList headers;
-                                        headers << tr("Dir/File");
-                                        cV_model->setHorizontalHeaderLabels(headers);
-                                        ui->contentsView->setModel(cV_model);
+                                        cV_addItems(topLevelItem, splitName);
                                     }
+
+                                    QStringList headers;
+                                    headers << tr("Dir/File");
+                                    cV_model->setHorizontalHeaderLabels(headers);
+                                    ui->contentsView->setModel(cV_model);
                                 }
                             } else {
                                 ui->contentsView->setModel(nullptr);
@@ -813,23 +870,59 @@ void MainWindow::startHttpDownload(const QString &file_dest, const QString &uniq
                         if (gk_dl_info_cache.at(k).dl_type == GekkoFyre::DownloadType::HTTP ||
                                 gk_dl_info_cache.at(k).dl_type == GekkoFyre::DownloadType::FTP) {
                             // TODO: QFutureWatcher<GekkoFyre::CurlMulti::CurlInfo> *verifyFileFutWatch;
-                            if (status != GekkoFyre::DownloadStatus::Downloading) {
+                            if (status != GekkoFyre::DownloadStatus::Downloading &&
+                                    status != GekkoFyre::DownloadStatus::Queued) {
+                                QStringList mirrors;
+                                if (gk_dl_info_cache.at(k).curl_info.is_initialized()) {
+                                    for (const auto &mirror: gk_dl_info_cache.at(k).curl_info.value().mirrors) {
+                                        mirrors << QString::fromStdString(mirror);
+                                    }
+                                }
+
+                                // Should the original URL be unreachable, then the details are taken from the first
+                                // of its mirrors that is not
                                 double freeDiskSpace = (double)routines->freeDiskSpace(QDir(file_dest).absolutePath());
                                 GekkoFyre::GkCurl::CurlInfoExt extended_info = GekkoFyre::CurlEasy::curlGrabInfo(url);
+                                for (int m = 0; !extended_info.status_ok && m < mirrors.size(); ++m) {
+                                    extended_info = GekkoFyre::CurlEasy::curlGrabInfo(mirrors.at(m));
+                                }
+
                                 if ((unsigned long int)((extended_info.content_length * FREE_DSK_SPACE_MULTIPLIER) < freeDiskSpace)) {
+                                    // The download waits within the queue until there is a slot free for it, at
+                                    // which point 'recvDlStarted()' marks it as downloading
                                     routines->modifyCurlItem(file_dest.toStdString(),
-                                                             GekkoFyre::DownloadStatus::Downloading);
-                                    dlModel->updateCol(index, routines->convDlStat_toString(GekkoFyre::DownloadStatus::Downloading), MN_STATUS_COL);
+                                                             GekkoFyre::DownloadStatus::Queued);
+                                    dlModel->updateCol(index, routines->convDlStat_toString(GekkoFyre::DownloadStatus::Queued), MN_STATUS_COL);
 
-                                    QObject::connect(GekkoFyre::routine_singleton::instance(), SIGNAL(sendXferStats(GekkoFyre::GkCurl::CurlProgressPtr)), this, SLOT(recvCurl_XferStats(GekkoFyre::GkCurl::CurlProgressPtr)));
-                                    QObject::connect(GekkoFyre::routine_singleton::instance(), SIGNAL(sendDlFinished(GekkoFyre::GkCurl::DlStatusMsg)), this, SLOT(recvDlFinished(GekkoFyre::GkCurl::DlStatusMsg)));
+                                    QObject::connect(GekkoFyre::routine_singleton::instance(), SIGNAL(sendDlStarted(QString)), this, SLOT(recvDlStarted(QString)), Qt::UniqueConnection);
+                                    QObject::connect(GekkoFyre::routine_singleton::instance(), SIGNAL(sendDlFinished(GekkoFyre::GkCurl::DlStatusMsg)), this, SLOT(recvDlFinished(GekkoFyre::GkCurl::DlStatusMsg)), Qt::UniqueConnection);
+                                    QObject::connect(GekkoFyre::routine_singleton::instance(), SIGNAL(sendDlSegments(QString,std::vector<GekkoFyre::GkCurl::SegmentRange>)), this, SLOT(recvDlSegments(QString,std::vector<GekkoFyre::GkCurl::SegmentRange>)), Qt::UniqueConnection);
 
                                     // This is required for signaling, otherwise QVariant does not know the type.
-                                    qRegisterMetaType<GekkoFyre::GkCurl::CurlProgressPtr>("curlProgressPtr");
                                     qRegisterMetaType<GekkoFyre::GkCurl::DlStatusMsg>("DlStatusMsg");
 
+                                    // The checksum is worked out whilst the download is being written to disk, so that
+                                    // 'recvDlFinished()' need not read the whole file back in again
+                                    GekkoFyre::HashType hash_type = GekkoFyre::HashType::SHA1;
+                                    if (gk_dl_info_cache.at(k).curl_info.is_initialized()) {
+                                        const GekkoFyre::HashType given_type = gk_dl_info_cache.at(k).curl_info.value().hash_type;
+                                        if (given_type != GekkoFyre::HashType::None &&
+                                                given_type != GekkoFyre::HashType::CannotDetermine) {
+                                            hash_type = given_type;
+                                        }
+                                    }
+
+                                    // Should FyreDL have been restarted since the download was stopped, then how far
+                                    // along each of its segments got is only known from the download history
+                                    std::vector<GekkoFyre::GkCurl::SegmentRange> segments;
+                                    GekkoFyre::GkCurl::CurlDlInfo saved_info;
+                                    if (resumeDl && routines->findCurlItemByPath(file_dest.toStdString(), saved_info)) {
+                                        segments = saved_info.segments;
+                                    }
+
                                     // Emit the signal data necessary to initiate a download
-                                    emit sendStartDownload(url, file_dest, resumeDl);
+                                    emit sendStartDownload(url, file_dest, resumeDl, extended_info.content_length,
+                                                           extended_info.accept_ranges, hash_type, mirrors, segments);
                                     return;
                                 } else {
                                     throw std::runtime_error(tr("Not enough free disk space!").toStdString());
@@ -860,15 +953,12 @@ void MainWindow::startTorrentDl(const QString &unique_id, const bool &resumeDl)
 {
     QModelIndexList indexes = ui->downloadView->selectionModel()->selectedRows();
     QModelIndex index = dlModel->index(indexes.at(0).row(), MN_STATUS_COL, QModelIndex());
-    std::vector<GekkoFyre::GkTorrent::TorrentInfo> gk_ti = routines->readTorrentItems(false);
-    for (auto const &indice: gk_ti) {
-        if (indice.general.unique_id == unique_id.toStdString()) {
-            QObject::connect(gk_torrent_client, SIGNAL(xfer_torrent_info(GekkoFyre::GkTorrent::TorrentResumeInfo)), this, SLOT(recvBitTorrent_XferStats(GekkoFyre::GkTorrent::TorrentResumeInfo)));
-            gk_torrent_client->startTorrentDl(indice);
-            routines->modifyTorrentItem(unique_id.toStdString(), GekkoFyre::DownloadStatus::Downloading);
-            dlModel->updateCol(index, routines->convDlStat_toString(GekkoFyre::DownloadStatus::Downloading), MN_STATUS_COL);
-            break;
-        }
+    GekkoFyre::GkTorrent::TorrentInfo gk_ti;
+    if (routines->findTorrentItem(unique_id.toStdString(), gk_ti)) {
+        QObject::connect(gk_torrent_client, SIGNAL(xfer_torrent_info(GekkoFyre::GkTorrent::TorrentResumeInfo)), this, SLOT(recvBitTorrent_XferStats(GekkoFyre::GkTorrent::TorrentResumeInfo)));
+        gk_torrent_client->startTorrentDl(gk_ti);
+        routines->modifyTorrentItem(unique_id.toStdString(), GekkoFyre::DownloadStatus::Downloading);
+        dlModel->updateCol(index, routines->convDlStat_toString(GekkoFyre::DownloadStatus::Downloading), MN_STATUS_COL);
     }
 
     return;
@@ -951,6 +1041,7 @@ void MainWindow::resumeDownload()
                         try {
                             switch (status) {
                                 case GekkoFyre::DownloadStatus::Paused:
+                                case GekkoFyre::DownloadStatus::Queued:
                                     if (fs::exists(dest_boost_path) && fs::is_regular_file(dest_boost_path)) {
                                         // The file still exists, so resume downloading since it's from a paused state!
                                         startHttpDownload(dest, unique_id, true);
@@ -1719,52 +1810,94 @@ void MainWindow::sendDetails(const std::string &fileName, const double &fileSize
 }
 
 /**
- * @brief MainWindow::recvCurl_XferStats receives the statistics regarding a HTTP(S)/FTP(S) download.
+ * @brief MainWindow::recvDetailsBatch receives a batch of HTTP(S)/FTP(S) downloads, as imported from a list of URLs, and
+ * both commits them to the database and inserts them into 'downloadView' together.
  * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
- * @date   2016-10-23
- * @note   <http://stackoverflow.com/questions/9086372/how-to-compare-pointers>
- *         <http://doc.qt.io/qt-5/qmutexlocker.html>
- *         <http://stackoverflow.com/questions/19981161/using-qmutexlocker-to-protect-shared-variables-when-running-function-with-qtconc>
- * @param info is the struct related to the download info.
- * @see MainWindow::manageDlStats()
+ * @date 2017-08-24
+ * @param dl_info The downloads that have been imported.
+ * @see AddURL::importCsvFile()
  */
-void MainWindow::recvCurl_XferStats(const GekkoFyre::GkCurl::CurlProgressPtr &info)
+void MainWindow::recvDetailsBatch(const std::vector<GekkoFyre::GkCurl::CurlDlInfo> &dl_info)
 {
-    QMutex curl_multi_mutex;
-    GekkoFyre::GkGraph::GkXferStats stats_temp;
-    std::time_t cur_time_temp;
-    std::time(&cur_time_temp);
-    stats_temp.cur_time = cur_time_temp;
-    curl_multi_mutex.lock();
+    // The destinations already within the model are gathered the once, rather than the whole model being searched through
+    // again for every single download within the batch
+    QSet<QString> existing;
+    for (const auto &row: dlModel->getList()) {
+        if (row.size() > (size_t)MN_DESTINATION_COL) {
+            existing.insert(row.at(MN_DESTINATION_COL));
+        }
+    }
 
-    stats_temp.download_rate = info.stat.back().dlnow;
-    stats_temp.upload_rate = info.stat.back().upnow;
-    stats_temp.download_total = info.stat.back().dltotal; // TODO: Modify this value to be the file-size of the download instead.
-    stats_temp.upload_total = info.stat.back().uptotal;
+    std::vector<GekkoFyre::GkCurl::CurlDlInfo> fresh;
+    fresh.reserve(dl_info.size());
+    QStringList duplicates;
+    for (const auto &item: dl_info) {
+        const QString dest = QString::fromStdString(item.file_loc);
+        if (existing.contains(dest)) {
+            duplicates << dest;
+            continue;
+        }
 
-    for (size_t i = 0; i < gk_dl_info_cache.size(); ++i) {
-        if (gk_dl_info_cache.at(i).dl_type == GekkoFyre::DownloadType::HTTP ||
-                gk_dl_info_cache.at(i).dl_type == GekkoFyre::DownloadType::FTP) {
-            if (gk_dl_info_cache.at(i).dl_dest == QString::fromStdString(info.file_dest)) {
-                if (gk_dl_info_cache.at(i).stats.timer_begin == 0) {
-                    // If it doesn't exist, push the whole of 'prog_temp' onto the private, class-global 'dl_stat' and
-                    // thusly updateDlStats().
-                    std::time(&gk_dl_info_cache.at(i).stats.timer_begin);
-                    gk_dl_info_cache.at(i).stats.xfer_stats.push_back(stats_temp);
-                    emit updateDlStats();
-                    goto finish_loop;
-                } else {
-                    // If it does exist, then only update certain elements instead and thusly updateDlStats() also.
-                    gk_dl_info_cache.at(i).stats.xfer_stats.push_back(stats_temp);
-                    emit updateDlStats();
-                    goto finish_loop;
-                }
+        existing.insert(dest);
+        fresh.push_back(item);
+    }
+
+    // Committed before the rows are inserted, so that the charts are able to find the record of each download
+    routines->addCurlItems(fresh);
+    insertNewRows(fresh);
+
+    if (!duplicates.isEmpty()) {
+        QMessageBox::information(this, tr("Duplicate entry..."), tr("There has been an attempt at %1 duplicate "
+                                                                            "entries, which have been skipped!\n\n%2")
+                .arg(duplicates.size()).arg(duplicates.first()), QMessageBox::Ok);
+    }
+
+    return;
+}
+
+/**
+ * @brief MainWindow::drainXferStats takes in the statistics of every HTTP(S)/FTP(S) download that have been handed over
+ * since the last time around, every 'FYREDL_STATS_DRAIN_INTERVAL' milliseconds. Only the latest sample of each download
+ * is kept, and the GUI is then brought up to date the once for all of them.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date   2017-08-31
+ * @see MainWindow::manageDlStats(), GekkoFyre::CurlMulti::nextXferSample()
+ */
+void MainWindow::drainXferStats()
+{
+    std::unordered_map<std::size_t, GekkoFyre::GkCurl::CurlDlStats> latest;
+    GekkoFyre::GkCurl::XferSample sample;
+    while (GekkoFyre::CurlMulti::nextXferSample(sample)) {
+        latest[sample.item] = sample.stat;
+    }
+
+    if (latest.empty()) {
+        return;
+    }
+
+    for (auto &dl_info: gk_dl_info_cache) {
+        if (dl_info.dl_type == GekkoFyre::DownloadType::HTTP || dl_info.dl_type == GekkoFyre::DownloadType::FTP) {
+            auto stat = latest.find(std::hash<std::string>()(dl_info.dl_dest.toStdString()));
+            if (stat == latest.end()) {
+                continue;
+            }
+
+            GekkoFyre::GkGraph::GkXferStats stats_temp;
+            stats_temp.cur_time = stat->second.cur_time;
+            stats_temp.download_rate = stat->second.dlnow;
+            stats_temp.upload_rate = stat->second.upnow;
+            stats_temp.download_total = stat->second.dltotal; // TODO: Modify this value to be the file-size of the download instead.
+            stats_temp.upload_total = stat->second.uptotal;
+
+            if (dl_info.stats.timer_begin == 0) {
+                std::time(&dl_info.stats.timer_begin);
             }
+
+            dl_info.stats.xfer_stats.push_back(stats_temp);
         }
     }
 
-    finish_loop: ;
-    curl_multi_mutex.unlock();
+    manageDlStats();
     return;
 }
 
@@ -1773,7 +1906,7 @@ void MainWindow::recvCurl_XferStats(const GekkoFyre::GkCurl::CurlProgressPtr &in
  * the relevant columns on the GUI, and if needed, updating the database also.
  * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
  * @date 2016-10-23
- * @see MainWindow::recvCurl_XferStats(), MainWindow::recvBitTorrent_XferStats()
+ * @see MainWindow::drainXferStats(), MainWindow::recvBitTorrent_XferStats()
  */
 void MainWindow::manageDlStats()
 {
@@ -1839,6 +1972,46 @@ void MainWindow::manageDlStats()
     return;
 }
 
+/**
+ * @brief MainWindow::recvDlStarted marks the given download as downloading, once it has made its way out of the queue.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date   2017-08-28
+ * @param file_loc The location of the download on the user's local storage.
+ */
+void MainWindow::recvDlStarted(const QString &file_loc)
+{
+    for (int i = 0; i < dlModel->getList().size(); ++i) {
+        const QString dest = ui->downloadView->model()->data(dlModel->index(i, MN_DESTINATION_COL)).toString();
+        if (dest == file_loc) {
+            QModelIndex stat_index = dlModel->index(i, MN_STATUS_COL);
+            if (routines->convDlStat_StringToEnum(ui->downloadView->model()->data(stat_index).toString()) ==
+                GekkoFyre::DownloadStatus::Queued) {
+                routines->modifyCurlItem(file_loc.toStdString(), GekkoFyre::DownloadStatus::Downloading);
+                dlModel->updateCol(stat_index, routines->convDlStat_toString(GekkoFyre::DownloadStatus::Downloading),
+                                   MN_STATUS_COL);
+            }
+
+            return;
+        }
+    }
+
+    return;
+}
+
+/**
+ * @brief MainWindow::recvDlSegments keeps how far along each segment of the given download is within its record, so
+ * that it may be resumed from there even after FyreDL has been restarted.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date   2017-09-02
+ * @param file_loc The location of the download on the user's local storage.
+ * @param segments The byte-ranges of the download and how much of each has been written, or empty should it have none.
+ */
+void MainWindow::recvDlSegments(const QString &file_loc, const std::vector<GekkoFyre::GkCurl::SegmentRange> &segments)
+{
+    routines->modifyCurlSegments(file_loc.toStdString(), segments);
+    return;
+}
+
 /**
  * @brief MainWindow::downloadFin is a slot that is executed upon finishing of a download.
  * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
@@ -1856,35 +2029,68 @@ void MainWindow::recvDlFinished(const GekkoFyre::GkCurl::DlStatusMsg &status)
 
             if (dest.toStdString() == status.file_loc) {
                 QModelIndex stat_index = dlModel->index(i, MN_STATUS_COL);
-                if (routines->convDlStat_StringToEnum(ui->downloadView->model()->data(stat_index).toString()) ==
-                    GekkoFyre::DownloadStatus::Downloading) {
+                const GekkoFyre::DownloadStatus dl_status = routines->convDlStat_StringToEnum(
+                        ui->downloadView->model()->data(stat_index).toString());
+                if (status.result != CURLE_OK && (dl_status == GekkoFyre::DownloadStatus::Downloading ||
+                                                  dl_status == GekkoFyre::DownloadStatus::Queued)) {
+                    // The download was given up on part-way through (or could not be started at all), so it is left
+                    // paused for the user to resume rather than hashing what little of it there is
+                    routines->modifyCurlItem(status.file_loc, GekkoFyre::DownloadStatus::Paused);
+                    dlModel->updateCol(stat_index, routines->convDlStat_toString(GekkoFyre::DownloadStatus::Paused),
+                                       MN_STATUS_COL);
+                    ui->statusBar->showMessage(tr("Download of \"%1\" failed: %2").arg(dest)
+                                                       .arg(curl_easy_strerror(status.result)), 5000);
+                    return;
+                }
 
+                if (dl_status == GekkoFyre::DownloadStatus::Downloading) {
                     GekkoFyre::GkFile::FileHash file_hash;
-                    std::vector<GekkoFyre::GkCurl::CurlDlInfo> dl_mini_info_vec = routines->readCurlItems(true);
-                    for (size_t j = 0; j < dl_mini_info_vec.size(); ++j) {
-                        if (dl_mini_info_vec.at(j).file_loc == status.file_loc) {
-                            switch (dl_mini_info_vec.at(j).hash_type) {
+                    file_hash.hash_type = GekkoFyre::HashType::None;
+                    file_hash.hash_verif = GekkoFyre::HashVerif::NotApplicable;
+                    bool hash_queued = false;
+                    GekkoFyre::GkCurl::CurlDlInfo dl_mini_info;
+                    if (routines->findCurlItemByPath(status.file_loc, dl_mini_info)) {
+                        const GekkoFyre::HashType given_type = dl_mini_info.hash_type;
+                        const bool given_known = (given_type != GekkoFyre::HashType::CannotDetermine &&
+                                                  given_type != GekkoFyre::HashType::None);
+                        if (!status.checksum.isEmpty() &&
+                                status.hash_type == (given_known ? given_type : GekkoFyre::HashType::SHA1)) {
+                            // The checksum has already been worked out whilst downloading, so there is no need to
+                            // read the whole file back in again. The given one is brought into line with it just as
+                            // 'cryptoFileHash()' does.
+                            const QString given_hash = given_known ? QString::fromStdString(dl_mini_info.hash_val_given)
+                                                                             .trimmed().toLower() : "";
+                            file_hash.hash_type = status.hash_type;
+                            file_hash.checksum = status.checksum;
+                            if (given_hash.isEmpty()) {
+                                file_hash.hash_verif = GekkoFyre::HashVerif::NotApplicable;
+                            } else if (file_hash.checksum == given_hash) {
+                                file_hash.hash_verif = GekkoFyre::HashVerif::Verified;
+                            } else {
+                                file_hash.hash_verif = GekkoFyre::HashVerif::Corrupt;
+                            }
+                        } else {
+                            // Otherwise, the file has to be read back in, which is left to the hashing service so that the
+                            // GUI is not held up in the meantime. The download is marked as completed once it is done.
+                            switch (given_type) {
                                 case GekkoFyre::HashType::CannotDetermine:
                                 case GekkoFyre::HashType::None:
-                                    file_hash = routines->cryptoFileHash(
-                                            QString::fromStdString(status.file_loc), GekkoFyre::HashType::SHA1, "");
+                                    hash_service->hashFile(QString::fromStdString(status.file_loc),
+                                                           GekkoFyre::HashType::SHA1, "");
                                     break;
                                 default:
-                                    file_hash = routines->cryptoFileHash(
-                                            QString::fromStdString(status.file_loc), dl_mini_info_vec.at(j).hash_type,
-                                            QString::fromStdString(dl_mini_info_vec.at(j).hash_val_given));
+                                    hash_service->hashFile(QString::fromStdString(status.file_loc), given_type,
+                                                           QString::fromStdString(dl_mini_info.hash_val_given));
                                     break;
                             }
 
-                            break;
+                            hash_queued = true;
                         }
                     }
 
-                    routines->modifyCurlItem(status.file_loc, GekkoFyre::DownloadStatus::Completed,
-                                             QDateTime::currentDateTime().toTime_t(),
-                                             file_hash.checksum.toStdString(), file_hash.hash_type);
-                    dlModel->updateCol(stat_index, routines->convDlStat_toString(GekkoFyre::DownloadStatus::Completed),
-                                       MN_STATUS_COL);
+                    if (!hash_queued) {
+                        completeHttpDownload(status.file_loc, file_hash);
+                    }
 
                     // Update the 'downloaded amount' because the statistics routines are not always accurate, due to only
                     // running every few seconds at most. This causes inconsistencies.
@@ -1903,6 +2109,83 @@ void MainWindow::recvDlFinished(const GekkoFyre::GkCurl::DlStatusMsg &status)
     return;
 }
 
+/**
+ * @brief MainWindow::completeHttpDownload marks the given HTTP(S)/FTP(S) download as completed, now that it has been
+ * downloaded in full and its checksum is known.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date   2017-08-17
+ * @param file_loc The destination of the download in question on the user's local storage.
+ * @param file_hash The checksum of the download.
+ */
+void MainWindow::completeHttpDownload(const std::string &file_loc, const GekkoFyre::GkFile::FileHash &file_hash)
+{
+    for (int i = 0; i < dlModel->getList().size(); ++i) {
+        QString dest = ui->downloadView->model()->data(dlModel->index(i, MN_DESTINATION_COL)).toString();
+        if (dest.toStdString() == file_loc) {
+            QModelIndex stat_index = dlModel->index(i, MN_STATUS_COL);
+            if (routines->convDlStat_StringToEnum(ui->downloadView->model()->data(stat_index).toString()) ==
+                GekkoFyre::DownloadStatus::Downloading) {
+                routines->modifyCurlItem(file_loc, GekkoFyre::DownloadStatus::Completed,
+                                         QDateTime::currentDateTime().toTime_t(),
+                                         file_hash.checksum.toStdString(), file_hash.hash_type);
+                dlModel->updateCol(stat_index, routines->convDlStat_toString(GekkoFyre::DownloadStatus::Completed),
+                                   MN_STATUS_COL);
+                return;
+            }
+        }
+    }
+
+    return;
+}
+
+/**
+ * @brief MainWindow::recvHashProgress lets the user know how far along the checksum of a finished download is.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date   2017-08-17
+ */
+void MainWindow::recvHashProgress(const QString &file_dest, const qint64 &done, const qint64 &total)
+{
+    const qint64 percent = (total > 0) ? ((done * 100) / total) : 100;
+    ui->statusBar->showMessage(tr("Verifying \"%1\"... %2%").arg(QFileInfo(file_dest).fileName())
+                                       .arg(QString::number(percent)), 5000);
+    return;
+}
+
+/**
+ * @brief MainWindow::recvHashFinished is a slot that is executed once the checksum of a finished download has been
+ * worked out by the hashing service.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date   2017-08-17
+ */
+void MainWindow::recvHashFinished(const QString &file_dest, const GekkoFyre::GkFile::FileHash &file_hash)
+{
+    try {
+        completeHttpDownload(file_dest.toStdString(), file_hash);
+    } catch (const std::exception &e) {
+        QMessageBox::warning(this, tr("Error!"), QString("%1").arg(e.what()), QMessageBox::Ok);
+        return;
+    }
+
+    return;
+}
+
+/**
+ * @brief MainWindow::recvHashError is a slot that is executed should the checksum of a finished download not be able
+ * to be worked out, whereupon the download is marked as completed regardless, but without a checksum.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date   2017-08-17
+ */
+void MainWindow::recvHashError(const QString &file_dest, const QString &error)
+{
+    QMessageBox::warning(this, tr("Error!"), error, QMessageBox::Ok);
+
+    GekkoFyre::GkFile::FileHash file_hash;
+    file_hash.hash_type = GekkoFyre::HashType::None;
+    file_hash.hash_verif = GekkoFyre::HashVerif::NotApplicable;
+    recvHashFinished(file_dest, file_hash);
+    return;
+}
+
 void MainWindow::terminate_curl_downloads()
 {
     emit finish_curl_multi_thread();
@@ -47,6 +47,7 @@
 #include "./../dl_view.hpp"
 #include "./../cmnroutines.hpp"
 #include "./../curl_multi.hpp"
+#include "./../hash_service.hpp"
 #include "./../torrent/client.hpp"
 #include "addurl.hpp"
 #include <vector>
@@ -59,6 +60,7 @@
 #include <QStringList>
 #include <QStandardItem>
 #include <QPointer>
+#include <QTimer>
 
 using namespace GekkoFyre;
 namespace Ui {
@@ -84,6 +86,11 @@ private:
                       const GekkoFyre::DownloadStatus &status, const std::string &url,
                       const std::string &destination, const std::string &unique_id,
                       const GekkoFyre::DownloadType &download_type);
+    void insertNewRows(const std::vector<GekkoFyre::GkCurl::CurlDlInfo> &dl_info);
+    void setRowData(const int &row, const std::string &fileName, const double &fileSize, const int &downloaded,
+                    const double &progress, const int &upSpeed, const int &downSpeed,
+                    const GekkoFyre::DownloadStatus &status, const std::string &url,
+                    const std::string &destination, const std::string &unique_id);
     void removeSelRows();
     void resetDlStateStartup();
 
@@ -99,6 +106,7 @@ private:
     bool askDeleteHttpItem(const QString &file_dest, const QString &unique_id, const bool &noRestart = false);
     void startHttpDownload(const QString &file_dest, const QString &unique_id, const bool &resumeDl = true);
     void startTorrentDl(const QString &unique_id, const bool &resumeDl = true);
+    void completeHttpDownload(const std::string &file_loc, const GekkoFyre::GkFile::FileHash &file_hash);
 
     // Immediately below are actions that the user may take on a single downloadable item, such as by pausing,
     // restarting, or halting it, for example. That is not a complete list.
@@ -115,6 +123,7 @@ private:
     QPointer<downloadModel> dlModel;
     std::shared_ptr<GekkoFyre::CmnRoutines> routines;
     QPointer<GekkoFyre::CurlMulti> curl_multi;
+    QPointer<GekkoFyre::GkHashService> hash_service;
     QPointer<GekkoFyre::GkTorrentClient> gk_torrent_client;
     std::vector<GekkoFyre::Global::DownloadInfo> gk_dl_info_cache;
     std::mutex mutex;
@@ -122,12 +131,15 @@ private:
 
     // http://stackoverflow.com/questions/10121560/stdthread-naming-your-thread
     QPointer<QThread> curl_multi_thread;
+    QPointer<QTimer> xfer_stats_timer; // Takes in the transfer statistics of HTTP(S)/FTP(S) downloads at a fixed rate
 
 signals:
     // Libcurl specific signals
     void updateDlStats();
     void sendStopDownload(const QString &fileLoc);
-    void sendStartDownload(const QString &url, const QString &file_loc, const bool &resumeDl);
+    void sendStartDownload(const QString &url, const QString &file_loc, const bool &resumeDl, const double &content_length,
+                           const bool &accept_ranges, const GekkoFyre::HashType &hash_type, const QStringList &mirrors,
+                           const std::vector<GekkoFyre::GkCurl::SegmentRange> &segments);
     void finish_curl_multi_thread();
     void terminate_xfers();
 
@@ -172,13 +184,21 @@ private slots:
                      const std::string &hash_val, const long long &resp_code, const bool &stat_ok,
                      const std::string &stat_msg, const std::string &unique_id,
                      const GekkoFyre::DownloadType &down_type);
+    void recvDetailsBatch(const std::vector<GekkoFyre::GkCurl::CurlDlInfo> &dl_info);
 
     // Libcurl specific slots
-    void recvCurl_XferStats(const GekkoFyre::GkCurl::CurlProgressPtr &info);
+    void drainXferStats();
     void manageDlStats();
     void recvDlFinished(const GekkoFyre::GkCurl::DlStatusMsg &status);
+    void recvDlStarted(const QString &file_loc);
+    void recvDlSegments(const QString &file_loc, const std::vector<GekkoFyre::GkCurl::SegmentRange> &segments);
     void terminate_curl_downloads();
 
+    // Checksum specific slots
+    void recvHashProgress(const QString &file_dest, const qint64 &done, const qint64 &total);
+    void recvHashFinished(const QString &file_dest, const GekkoFyre::GkFile::FileHash &file_hash);
+    void recvHashError(const QString &file_dest, const QString &error);
+
     // Libtorrent specific slots
     void recvBitTorrent_XferStats(const GekkoFyre::GkTorrent::TorrentResumeInfo &gk_xfer_info);
 
@@ -0,0 +1,108 @@
+/**
+ **  ______             ______ _
+ **  |  ___|            |  _  \ |
+ **  | |_ _   _ _ __ ___| | | | |
+ **  |  _| | | | '__/ _ \ | | | |
+ **  | | | |_| | | |  __/ |/ /| |____
+ **  \_|  \__, |_|  \___|___/ \_____/
+ **        __/ |
+ **       |___/
+ **
+ **   Thank you for using "FyreDL" for your download management needs!
+ **   Copyright (C) 2016-2017. GekkoFyre.
+ **
+ **
+ **   FyreDL is free software: you can redistribute it and/or modify
+ **   it under the terms of the GNU General Public License as published by
+ **   the Free Software Foundation, either version 3 of the License, or
+ **   (at your option) any later version.
+ **
+ **   FyreDL is distributed in the hope that it will be useful,
+ **   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **   GNU General Public License for more details.
+ **
+ **   You should have received a copy of the GNU General Public License
+ **   along with FyreDL.  If not, see <http://www.gnu.org/licenses/>.
+ **
+ **
+ **   The latest source code updates can be obtained from [ 1 ] below at your
+ **   discretion. A web-browser or the 'git' application may be required.
+ **
+ **   [ 1 ] - https://github.com/GekkoFyre/FyreDL
+ **
+ ********************************************************************************/
+
+/**
+ * @file hash_service.cpp
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-17
+ * @brief Verifies the checksums of finished downloads upon a pool of threads, away from the GUI.
+ */
+
+#include "hash_service.hpp"
+#include "cmnroutines.hpp"
+#include <algorithm>
+#include <thread>
+#include <exception>
+
+GekkoFyre::GkHashService::GkHashService(QObject *parent) : QObject(parent), cancelled(false)
+{
+    qRegisterMetaType<GekkoFyre::GkFile::FileHash>("GekkoFyre::GkFile::FileHash");
+
+    // Hashing is bound by the disk as much as by the processor, so there is little to be gained from any more threads
+    // than this even upon machines with plenty of cores
+    const unsigned int cores = std::max(std::thread::hardware_concurrency(), 1U);
+    pool.reset(new ThreadPool(std::min(cores, (unsigned int)FYREDL_HASH_MAX_THREADS)));
+}
+
+GekkoFyre::GkHashService::~GkHashService()
+{
+    // Nobody is left to hear about the outcome, so whatever has yet to start is dropped and whatever is under way gives
+    // up upon its next block, rather than reading the rest of each file in first. The threads are then waited upon
+    // whilst this object is still around for them to touch.
+    cancelled = true;
+    pool.reset();
+}
+
+/**
+ * @brief GekkoFyre::GkHashService::hashFile queues up the given file to have its checksum worked out (and compared
+ * against the given one, if any) by the pool, returning straight away. Many files may be hashed at once, one per
+ * thread, with the rest waiting their turn. The outcome is given by either sendHashFinished() or sendHashError().
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-17
+ * @param file_dest The file you wish to hash.
+ * @param hash_type The crypto type you wish to use.
+ * @param given_hash_val The checksum to compare against, if any.
+ * @see GekkoFyre::CmnRoutines::cryptoFileHash()
+ */
+void GekkoFyre::GkHashService::hashFile(const QString &file_dest, const GekkoFyre::HashType &hash_type,
+                                        const QString &given_hash_val)
+{
+    pool->enqueue([this, file_dest, hash_type, given_hash_val]() {
+        if (cancelled) {
+            return;
+        }
+
+        try {
+            int last_percent = -1;
+            GekkoFyre::GkFile::FileHash file_hash = GekkoFyre::CmnRoutines::cryptoFileHash(
+                    file_dest, hash_type, given_hash_val, [&](const qint64 &done, const qint64 &total) {
+                        // Only bother the GUI whenever there is a visible change to report
+                        int percent = (total > 0) ? (int)((done * 100) / total) : 100;
+                        if (percent != last_percent) {
+                            last_percent = percent;
+                            emit sendHashProgress(file_dest, done, total);
+                        }
+                    }, &cancelled);
+
+            emit sendHashFinished(file_dest, file_hash);
+        } catch (const std::exception &e) {
+            if (!cancelled) {
+                emit sendHashError(file_dest, QString::fromStdString(e.what()));
+            }
+        }
+    });
+
+    return;
+}
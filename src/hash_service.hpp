@@ -0,0 +1,79 @@
+/**
+ **  ______             ______ _
+ **  |  ___|            |  _  \ |
+ **  | |_ _   _ _ __ ___| | | | |
+ **  |  _| | | | '__/ _ \ | | | |
+ **  | | | |_| | | |  __/ |/ /| |____
+ **  \_|  \__, |_|  \___|___/ \_____/
+ **        __/ |
+ **       |___/
+ **
+ **   Thank you for using "FyreDL" for your download management needs!
+ **   Copyright (C) 2016-2017. GekkoFyre.
+ **
+ **
+ **   FyreDL is free software: you can redistribute it and/or modify
+ **   it under the terms of the GNU General Public License as published by
+ **   the Free Software Foundation, either version 3 of the License, or
+ **   (at your option) any later version.
+ **
+ **   FyreDL is distributed in the hope that it will be useful,
+ **   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **   GNU General Public License for more details.
+ **
+ **   You should have received a copy of the GNU General Public License
+ **   along with FyreDL.  If not, see <http://www.gnu.org/licenses/>.
+ **
+ **
+ **   The latest source code updates can be obtained from [ 1 ] below at your
+ **   discretion. A web-browser or the 'git' application may be required.
+ **
+ **   [ 1 ] - https://github.com/GekkoFyre/FyreDL
+ **
+ ********************************************************************************/
+
+/**
+ * @file hash_service.hpp
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-17
+ * @brief Verifies the checksums of finished downloads upon a pool of threads, away from the GUI.
+ */
+
+#ifndef FYREDL_HASH_SERVICE_HPP
+#define FYREDL_HASH_SERVICE_HPP
+
+#include "default_var.hpp"
+#include "./../utils/ThreadPool/ThreadPool.h"
+#include <memory>
+#include <atomic>
+#include <QObject>
+#include <QString>
+#include <qmetatype.h>
+
+namespace GekkoFyre {
+class GkHashService : public QObject {
+    Q_OBJECT
+
+public:
+    explicit GkHashService(QObject *parent = 0);
+    ~GkHashService();
+
+    void hashFile(const QString &file_dest, const GekkoFyre::HashType &hash_type, const QString &given_hash_val);
+
+signals:
+    void sendHashProgress(const QString &file_dest, const qint64 &done, const qint64 &total);
+    void sendHashFinished(const QString &file_dest, const GekkoFyre::GkFile::FileHash &file_hash);
+    void sendHashError(const QString &file_dest, const QString &error);
+
+private:
+    std::unique_ptr<ThreadPool> pool;
+    std::atomic<bool> cancelled; // Set upon destruction, whereupon anything that has yet to be hashed is dropped
+
+};
+}
+
+// This is required for signaling, otherwise QVariant does not know the type.
+Q_DECLARE_METATYPE(GekkoFyre::GkFile::FileHash);
+
+#endif // FYREDL_HASH_SERVICE_HPP
@@ -0,0 +1,142 @@
+/**
+ **  ______             ______ _
+ **  |  ___|            |  _  \ |
+ **  | |_ _   _ _ __ ___| | | | |
+ **  |  _| | | | '__/ _ \ | | | |
+ **  | | | |_| | | |  __/ |/ /| |____
+ **  \_|  \__, |_|  \___|___/ \_____/
+ **        __/ |
+ **       |___/
+ **
+ **   Thank you for using "FyreDL" for your download management needs!
+ **   Copyright (C) 2016-2017. GekkoFyre.
+ **
+ **
+ **   FyreDL is free software: you can redistribute it and/or modify
+ **   it under the terms of the GNU General Public License as published by
+ **   the Free Software Foundation, either version 3 of the License, or
+ **   (at your option) any later version.
+ **
+ **   FyreDL is distributed in the hope that it will be useful,
+ **   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ **   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ **   GNU General Public License for more details.
+ **
+ **   You should have received a copy of the GNU General Public License
+ **   along with FyreDL.  If not, see <http://www.gnu.org/licenses/>.
+ **
+ **
+ **   The latest source code updates can be obtained from [ 1 ] below at your
+ **   discretion. A web-browser or the 'git' application may be required.
+ **
+ **   [ 1 ] - https://github.com/GekkoFyre/FyreDL
+ **
+ ********************************************************************************/
+
+/**
+ * @file stat_ring.hpp
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-31
+ * @brief A fixed-size, lock-free ring of samples for handing transfer statistics over from the threads that gather them
+ * to the GUI, without either side ever having to wait upon the other.
+ * @note <http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue>
+ */
+
+#ifndef FYREDL_STAT_RING_HPP
+#define FYREDL_STAT_RING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace GekkoFyre {
+/**
+ * @brief GekkoFyre::GkStatRing is a bounded queue for any number of producers and a single consumer. Every cell carries a
+ * sequence number which says whether it is free to be written to or ready to be read from, so a producer only ever has
+ * to claim a cell and the consumer never takes a lock. Should the ring be full, then the sample is dropped rather than
+ * the producer being made to wait.
+ */
+template<typename T, size_t N>
+class GkStatRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "The size of a 'GkStatRing' must be a power of two!");
+    static_assert(std::is_trivially_copyable<T>::value, "The samples within a 'GkStatRing' must be trivially copyable!");
+
+public:
+    GkStatRing() : tail(0), head(0), lost(0) {
+        for (size_t i = 0; i < N; ++i) {
+            cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    GkStatRing(const GkStatRing &) = delete;
+    GkStatRing &operator=(const GkStatRing &) = delete;
+
+    /**
+     * @brief push adds a sample to the ring. Safe to call from any number of threads at once.
+     * @return Whether there was room for the sample, as otherwise it has been dropped.
+     */
+    bool push(const T &value) noexcept {
+        Cell *cell;
+        size_t pos = tail.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &cells[pos & (N - 1)];
+            const size_t seq = cell->seq.load(std::memory_order_acquire);
+            const intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                lost.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = value;
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief pop takes the oldest sample off of the ring. Only ever to be called from the one thread.
+     * @return Whether there was a sample to be had.
+     */
+    bool pop(T &value) noexcept {
+        const size_t pos = head.load(std::memory_order_relaxed);
+        Cell &cell = cells[pos & (N - 1)];
+        const size_t seq = cell.seq.load(std::memory_order_acquire);
+        if ((intptr_t)seq - (intptr_t)(pos + 1) < 0) {
+            return false;
+        }
+
+        value = cell.value;
+        cell.seq.store(pos + N, std::memory_order_release);
+        head.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief dropped is how many samples have been dropped thus far, for want of room within the ring.
+     */
+    unsigned long dropped() const noexcept {
+        return lost.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> seq;
+        T value;
+    };
+
+    // Kept apart so that the producers and the consumer are not forever fighting over the same cache line
+    alignas(64) std::atomic<size_t> tail;
+    alignas(64) std::atomic<size_t> head;
+    alignas(64) std::atomic<unsigned long> lost;
+    Cell cells[N];
+};
+}
+
+#endif // FYREDL_STAT_RING_HPP
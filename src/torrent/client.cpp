@@ -50,6 +50,8 @@
 #include <boost/filesystem.hpp>
 #include <boost/exception/all.hpp>
 #include <QString>
+#include <algorithm>
+#include <limits>
 
 namespace sys = boost::system;
 namespace fs = boost::filesystem;
@@ -66,6 +68,8 @@ GekkoFyre::GkTorrentClient::GkTorrentClient(const GekkoFyre::GkFile::FileDb &dat
 {
     routines = std::make_shared<GekkoFyre::CmnRoutines>(database, this);
     db_struct = database;
+    bw_down = 0;
+    bw_up = GekkoFyre::GkBandwidth::instance().uploadLimit();
 
     // http://libtorrent.org/reference-Settings.html#settings_pack
     // http://www.libtorrent.org/include/libtorrent/session_settings.hpp
@@ -86,8 +90,8 @@ GekkoFyre::GkTorrentClient::GkTorrentClient(const GekkoFyre::GkFile::FileDb &dat
 
     pack.set_int(lt::settings_pack::connection_speed, 10);                  // The number of connection attempts that are made per second.
     pack.set_int(lt::settings_pack::handshake_timeout, 30);                 // The number of seconds to wait for a handshake response from a peer.
-    pack.set_int(lt::settings_pack::download_rate_limit, 0);                // Sets the session-global limits of upload and download rate limits, in bytes per second. By default peers on the local network are not rate limited.
-    pack.set_int(lt::settings_pack::upload_rate_limit, 0);                  // Sets the session-global limits of upload and download rate limits, in bytes per second. By default peers on the local network are not rate limited.
+    pack.set_int(lt::settings_pack::download_rate_limit, (int)bw_down);     // Sets the session-global limits of upload and download rate limits, in bytes per second. Both are handed out by 'GkBandwidth' from here on, see apply_bw_limits().
+    pack.set_int(lt::settings_pack::upload_rate_limit, (int)bw_up);         // Sets the session-global limits of upload and download rate limits, in bytes per second. By default peers on the local network are not rate limited.
     pack.set_int(lt::settings_pack::dht_upload_rate_limit, 4000);           // Sets the rate limit on the DHT. This is specified in bytes per second and defaults to 4000. For busy boxes with lots of torrents that requires more DHT traffic, this should be raised.
     pack.set_int(lt::settings_pack::connections_limit, 500);                // Sets a global limit on the number of connections opened.
     pack.set_int(lt::settings_pack::connections_slack, 10);                 // The number of incoming connections exceeding the connection limit to accept in order to potentially replace existing ones.
@@ -107,7 +111,12 @@ GekkoFyre::GkTorrentClient::GkTorrentClient(const GekkoFyre::GkFile::FileDb &dat
 }
 
 GekkoFyre::GkTorrentClient::~GkTorrentClient()
-{}
+{
+    std::lock_guard<std::mutex> lock(bw_mtx);
+    if (bw_flow != nullptr) {
+        GekkoFyre::GkBandwidth::instance().removeFlow(bw_flow);
+    }
+}
 
 /**
  * @brief GekkoFyre::GkTorrentClient::startTorrentDl reads the given download destination to the user's local storage from
@@ -171,6 +180,7 @@ void GekkoFyre::GkTorrentClient::startTorrentDl(const GekkoFyre::GkTorrent::Torr
             }
         }
 
+        apply_bw_limits();
         std::this_thread::sleep_for(std::chrono::milliseconds(200));
 
         return;
@@ -265,6 +275,17 @@ void GekkoFyre::GkTorrentClient::run_session_bckgrnd()
 
                     if (auto st = lt::alert_cast<lt::state_update_alert>(a)) {
                         if (st->status.empty()) continue;
+                        double download_rate = 0;
+                        for (auto const &s: st->status) {
+                            download_rate += s.download_rate;
+                        }
+
+                        std::unique_lock<std::mutex> bw_lock(bw_mtx);
+                        if (bw_flow != nullptr) {
+                            GekkoFyre::GkBandwidth::instance().report(*bw_flow, download_rate);
+                        }
+
+                        bw_lock.unlock();
                         int p = -1;
                         QMap<std::string, lt::torrent_handle>::iterator i;
                         for (i = lt_to_handle.begin(); i != lt_to_handle.end(); ++i) {
@@ -304,6 +325,7 @@ void GekkoFyre::GkTorrentClient::run_session_bckgrnd()
                 }
 
                 std::this_thread::sleep_for(std::chrono::milliseconds(200));
+                apply_bw_limits();
 
                 // Ask the session to post a state_update_alert, to update our state output for the torrent
                 lt_ses->post_torrent_updates();
@@ -330,3 +352,41 @@ void GekkoFyre::GkTorrentClient::run_session_bckgrnd()
         return;
     }
 }
+
+/**
+ * @brief GekkoFyre::GkTorrentClient::apply_bw_limits gives the session whatever share of the global bandwidth it has
+ * been allotted, alongside any HTTP(S)/FTP(S) downloads, so that the two never add up to more than the global limit.
+ * The session only draws upon the global bandwidth for as long as it has any torrents.
+ * @author Phobos Aryn'dythyrn D'thorga <phobos.gekko@gmail.com>
+ * @date 2017-08-27
+ * @note <http://libtorrent.org/reference-Settings.html#download_rate_limit>
+ * @see GekkoFyre::GkBandwidth::rebalance()
+ */
+void GekkoFyre::GkTorrentClient::apply_bw_limits()
+{
+    std::lock_guard<std::mutex> lock(bw_mtx);
+    GekkoFyre::GkBandwidth &bandwidth = GekkoFyre::GkBandwidth::instance();
+    if (lt_to_handle.isEmpty()) {
+        if (bw_flow != nullptr) {
+            bandwidth.removeFlow(bw_flow);
+            bw_flow.reset();
+        }
+    } else if (bw_flow == nullptr) {
+        bw_flow = bandwidth.addFlow(FYREDL_BW_TORRENT_ITEM, std::string());
+    }
+
+    bandwidth.rebalance();
+    const curl_off_t down = (bw_flow != nullptr) ? bandwidth.rate(*bw_flow) : 0;
+    const curl_off_t up = bandwidth.uploadLimit();
+    if (down != bw_down || up != bw_up) {
+        const curl_off_t int_max = std::numeric_limits<int>::max();
+        lt::settings_pack pack;
+        pack.set_int(lt::settings_pack::download_rate_limit, (int)std::min(down, int_max));
+        pack.set_int(lt::settings_pack::upload_rate_limit, (int)std::min(up, int_max));
+        lt_ses->apply_settings(pack);
+        bw_down = down;
+        bw_up = up;
+    }
+
+    return;
+}
@@ -48,12 +48,14 @@
 
 #include "./../default_var.hpp"
 #include "./../cmnroutines.hpp"
+#include "./../bandwidth.hpp"
 #include "misc.hpp"
 #include <libtorrent/session_handle.hpp>
 #include <libtorrent/torrent_handle.hpp>
 #include <string>
 #include <memory>
 #include <future>
+#include <mutex>
 #include <QObject>
 #include <QPointer>
 #include <QMap>
@@ -70,6 +72,7 @@ public:
 
 private:
     void run_session_bckgrnd();
+    void apply_bw_limits();
 
     std::shared_ptr<GekkoFyre::CmnRoutines> routines;
     lt::session_handle *lt_ses;
@@ -77,6 +80,10 @@ private:
     QMap<std::string, std::string> unique_id_cache;
     std::future<void> async_ses;
     GekkoFyre::GkFile::FileDb db_struct;
+    std::shared_ptr<GekkoFyre::GkBw::Flow> bw_flow; // The session's share of the global bandwidth, whilst it has any torrents
+    curl_off_t bw_down;                             // The download rate limit last given to the session
+    curl_off_t bw_up;                               // The upload rate limit last given to the session
+    std::mutex bw_mtx;
 
 private slots:
     void recv_proc_to_stats(const std::string &save_path, const lt::torrent_status &stats);